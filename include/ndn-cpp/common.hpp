@@ -9,6 +9,7 @@
 #define NDN_COMMON_HPP
 
 #include <vector>
+#include <string>
 // common.h include ndn-cpp-config.h.
 #include "c/common.h"
 
@@ -84,6 +85,15 @@ typedef double MillisecondsSince1970;
 std::string 
 toHex(const std::vector<uint8_t>& array);
 
+/**
+ * Return the hex representation of the bytes in array.
+ * @param array The array of bytes.
+ * @param arrayLength The number of bytes in array.
+ * @return Hex string.
+ */
+std::string 
+toHex(const uint8_t *array, size_t arrayLength);
+
 }
 
 #endif
@@ -55,6 +55,15 @@ public:
    */
   virtual void 
   set(const struct ndn_Signature& signatureStruct) = 0;
+
+  /**
+   * Clear this signature, and set the values from the ndn_Signature struct, sharing the byte array of buffer for
+   * values which are inside it.  This default implementation ignores buffer and calls set(signatureStruct) to copy.
+   * @param signatureStruct a C ndn_Signature struct
+   * @param buffer The Blob whose byte array may contain the values in signatureStruct, for example the decoder input.
+   */
+  virtual void 
+  set(const struct ndn_Signature& signatureStruct, const Blob& buffer);
 };
 
 /**
@@ -79,9 +88,11 @@ public:
   /**
    * Clear this meta info, and set the values by copying from the ndn_MetaInfo struct.
    * @param metaInfoStruct a C ndn_MetaInfo struct
+   * @param buffer (optional) If the finalBlockID is inside the byte array of this Blob, share the array instead of
+   * copying.
    */
   void 
-  set(const struct ndn_MetaInfo& metaInfoStruct);
+  set(const struct ndn_MetaInfo& metaInfoStruct, const Blob& buffer = Blob());
 
   MillisecondsSince1970 
   getTimestampMilliseconds() const { return timestampMilliseconds_; }
@@ -177,6 +188,17 @@ public:
     wireDecode(&input[0], input.size(), wireFormat);
   }
   
+  /**
+   * Decode the input using a particular wire format and update this Data without copying.  The name components, 
+   * content and signature fields are slices of input which share its byte array, so that decoding does not allocate
+   * a copy of each field.  If wireFormat is the default wire format, also set the defaultWireEncoding field to input.
+   * @param input The input byte array to be decoded.  This takes another reference to the array, which stays allocated 
+   * as long as this Data or one of its fields refers to it.
+   * @param wireFormat A WireFormat object used to decode the input. If omitted, use WireFormat getDefaultWireFormat().
+   */
+  void 
+  wireDecode(const Blob& input, WireFormat& wireFormat = *WireFormat::getDefaultWireFormat());
+  
   /**
    * Set the dataStruct to point to the values in this interest, without copying any memory.
    * WARNING: The resulting pointers in dataStruct are invalid after a further use of this object which could reallocate memory.
@@ -188,9 +210,11 @@ public:
   /**
    * Clear this data object, and set the values by copying from the ndn_Data struct.
    * @param dataStruct a C ndn_Data struct
+   * @param buffer (optional) For values which are inside the byte array of this Blob, for example the input which was
+   * decoded into dataStruct, share the array instead of copying.
    */
   void 
-  set(const struct ndn_Data& dataStruct);
+  set(const struct ndn_Data& dataStruct, const Blob& buffer = Blob());
 
   const Signature* 
   getSignature() const { return signature_.get(); }
@@ -35,6 +35,15 @@ public:
   virtual void 
   decodeInterest(Interest& interest, const uint8_t *input, size_t inputLength);
 
+  /**
+   * Decode input as an interest in binary XML and set the fields of the interest object as slices of input which 
+   * share its byte array.
+   * @param interest The Interest object whose fields are updated.
+   * @param input The input buffer to decode.
+   */
+  virtual void 
+  decodeInterest(Interest& interest, const Blob& input);
+
   /**
    * Encode data with binary XML and return the encoding.
    * @param data The Data object to encode.
@@ -64,6 +73,17 @@ public:
   decodeData
     (Data& data, const uint8_t *input, size_t inputLength, size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset);
 
+  /**
+   * Decode input as a data packet in binary XML and set the fields in the data object as slices of input which share
+   * its byte array.
+   * @param data The Data object whose fields are updated.
+   * @param input The input buffer to decode.
+   * @param signedPortionBeginOffset Return the offset in the input buffer of the beginning of the signed portion.
+   * @param signedPortionEndOffset Return the offset in the input buffer of the end of the signed portion.
+   */
+  virtual void 
+  decodeData(Data& data, const Blob& input, size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset);
+
   /**
    * Encode forwardingEntry in binary XML and return the encoding. 
    * @param forwardingEntry The ForwardingEntry object to encode.
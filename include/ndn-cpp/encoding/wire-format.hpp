@@ -38,6 +38,16 @@ public:
   virtual void 
   decodeInterest(Interest& interest, const uint8_t *input, size_t inputLength);
 
+  /**
+   * Decode input as an interest and set the fields of the interest object, sharing the byte array of input for the
+   * field values instead of copying.  Your derived class should override.  This default implementation calls 
+   * decodeInterest(interest, input.buf(), input.size()).
+   * @param interest The Interest object whose fields are updated.
+   * @param input The input buffer to decode.
+   */
+  virtual void 
+  decodeInterest(Interest& interest, const Blob& input);
+
   /**
    * Encode data and return the encoding.  Your derived class should override.
    * @param data The Data object to encode.
@@ -82,6 +92,18 @@ public:
   decodeData
     (Data& data, const uint8_t *input, size_t inputLength, size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset);
 
+  /**
+   * Decode input as a data packet and set the fields in the data object, sharing the byte array of input for the field
+   * values instead of copying.  Your derived class should override.  This default implementation calls 
+   * decodeData(data, input.buf(), input.size(), signedPortionBeginOffset, signedPortionEndOffset).
+   * @param data The Data object whose fields are updated.
+   * @param input The input buffer to decode.
+   * @param signedPortionBeginOffset Return the offset in the input buffer of the beginning of the signed portion.
+   * @param signedPortionEndOffset Return the offset in the input buffer of the end of the signed portion.
+   */
+  virtual void 
+  decodeData(Data& data, const Blob& input, size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset);
+
   void 
   decodeData(Data& data, const uint8_t *input, size_t inputLength)
   {
@@ -104,6 +104,18 @@ public:
   {
     node_.removePendingInterest(pendingInterestId);
   }
+
+  /**
+   * Remove every pending interest entry whose interest name has prefix as a prefix (including prefix itself) from the
+   * pending interest table, without calling their timeout callbacks.  For example, call this at shutdown to cancel
+   * all the interests of an application.
+   * @param prefix The name prefix of the pending interests to remove.
+   */
+  void
+  removePendingInterestsWithPrefix(const Name& prefix)
+  {
+    node_.removePendingInterestsWithPrefix(prefix);
+  }
   
   /**
    * Register prefix with the connected NDN hub and call onInterest when a matching interest is received.
@@ -136,9 +148,123 @@ public:
   {
     node_.removeRegisteredPrefix(registeredPrefixId);
   }
+
+  /**
+   * Call callback from processEvents after delayMilliseconds.  An application can use this to retransmit or to do
+   * periodic work without polling the time itself.
+   * @param delayMilliseconds The delay in milliseconds from now.  If this is 0 or negative, call callback from the
+   * next call to processEvents.
+   * @param callback A function object to call.  This copies the function object, so you may need to
+   * use func_lib::ref() as appropriate.
+   * @return The call later ID which can be used with cancelCallLater.
+   */
+  uint64_t
+  callLater(Milliseconds delayMilliseconds, const OnCallLater& callback)
+  {
+    return node_.callLater(delayMilliseconds, callback);
+  }
+
+  /**
+   * Cancel the callback for the callLaterId so that it is not called.
+   * If there is no callback with the callLaterId (or it was already called), do nothing.
+   * @param callLaterId The ID returned from callLater.
+   */
+  void
+  cancelCallLater(uint64_t callLaterId)
+  {
+    node_.cancelCallLater(callLaterId);
+  }
+
+  /**
+   * Set the budget of the content store which caches the data packets that satisfy pending interests.  While the
+   * content store is enabled, expressInterest answers an interest from the content store if a cached data packet
+   * matches it (unless the interest answerOriginKind excludes the content store), without sending the interest.  The
+   * onData callback is then called from the next call to processEvents.  A cached data packet becomes stale after its
+   * freshnessSeconds, and the least recently used data packets are evicted to stay within the budget.
+   * The content store is disabled by default.
+   * @param maxBytes The maximum total number of bytes in the wire encodings of the cached data packets.  If this is
+   * 0, disable the content store and remove the cached data packets.
+   */
+  void
+  setContentStoreMaxBytes(size_t maxBytes)
+  {
+    node_.setContentStoreMaxBytes(maxBytes);
+  }
+
+  /**
+   * Add the data packet to the producer store, replacing a stored data packet with the same name.  While a matching
+   * data packet is in the producer store, an incoming interest is answered by sending its wire encoding, without
+   * calling the OnInterest callback, so the application doesn't build, sign and encode it again.  A stored data
+   * packet becomes stale after its freshnessSeconds, and the least recently used data packets are evicted to stay
+   * within the budget set by setProducerStoreMaxBytes, which is 16 MB until it is called.
+   * @param data The signed data packet.  This uses data.getDefaultWireEncoding() if it has one, otherwise it encodes.
+   * @param wireFormat A WireFormat object used to encode the data packet. If omitted, use WireFormat getDefaultWireFormat().
+   * @return The wire encoding, which the application can send to answer the interest that it is processing.
+   */
+  Blob
+  putData(const Data& data, WireFormat& wireFormat = *WireFormat::getDefaultWireFormat())
+  {
+    return node_.putData(data, wireFormat);
+  }
+
+  /**
+   * Set the budget of the producer store for putData, evicting the least recently used data packets if needed.
+   * @param maxBytes The maximum total number of bytes in the wire encodings of the stored data packets.
+   */
+  void
+  setProducerStoreMaxBytes(size_t maxBytes)
+  {
+    node_.setProducerStoreMaxBytes(maxBytes);
+  }
+
+  /**
+   * Get the number of incoming interests which were answered from the producer store.  The hit rate is
+   * getProducerStoreHitCount() / (getProducerStoreHitCount() + getProducerStoreMissCount()).
+   */
+  uint64_t
+  getProducerStoreHitCount() const { return node_.getProducerStoreHitCount(); }
+
+  /**
+   * Get the number of incoming interests, received after the first call to putData, which the producer store did
+   * not answer.
+   */
+  uint64_t
+  getProducerStoreMissCount() const { return node_.getProducerStoreMissCount(); }
+
+  /**
+   * Enable the thread-safe mode, in which any thread can call expressInterest, removePendingInterest and putData while
+   * one thread calls processEvents.  A call from a thread other than the one in processEvents encodes the packet on the
+   * calling thread, then adds the request to a lock-free queue and wakes processEvents, which carries out the queued
+   * requests in the order that each thread made them.  All callbacks are called from the thread in processEvents.
+   * The other methods are not thread-safe.  Call this before other threads use the Face.
+   * @throw runtime_error if the wakeup file descriptor can't be created.
+   */
+  void
+  enableThreadSafeMode()
+  {
+    node_.enableThreadSafeMode();
+  }
+
+  /**
+   * Call the OnData, OnTimeout and OnInterest callbacks with the executor, for example a ThreadPoolExecutor, instead
+   * of from processEvents, so that a slow callback doesn't stall receiving.  The packets are still decoded by
+   * processEvents, and each callback gets the decoded Data or Interest.  This enables the thread-safe mode so that the
+   * callbacks can call expressInterest, removePendingInterest and putData, and the Transport given to OnInterest
+   * queues what it sends for processEvents to send.  Destroy the executor (which should finish its tasks) before this
+   * Face.
+   * @param executor The executor for the callbacks, or a null shared_ptr to call them from processEvents again.
+   * @param preserveOrder If true, the OnInterest callbacks for the same registered prefix are called one at a time in
+   * the order that the interests were received, and likewise for the callbacks of the same pending interest.  If
+   * false, the callbacks can be called in any order.  If omitted, use true.
+   */
+  void
+  setCallbackExecutor(const ptr_lib::shared_ptr<Executor>& executor, bool preserveOrder = true)
+  {
+    node_.setCallbackExecutor(executor, preserveOrder);
+  }
   
   /**
-   * Process any data to receive or call timeout callbacks.
+   * Process any data to receive or call timeout and callLater callbacks.
    * This is non-blocking and will return immediately if there is no data to receive.
    * You should repeatedly call this from an event loop, with calls to sleep as needed so that the loop doesn't use 100% of the CPU.
    * @throw This may throw an exception for reading data or in the callback for processing the data.  If you
@@ -151,6 +277,23 @@ public:
     node_.processEvents();
   }
 
+  /**
+   * Process any data to receive or call timeout and callLater callbacks.  If there is nothing to do, block until the
+   * transport has data to receive, a callback is due or timeoutMilliseconds passes.
+   * This returns as soon as at least one event is handled, so you can call this in a loop without sleeping.
+   * @param timeoutMilliseconds The maximum time to block in milliseconds.  If this is 0, don't block.
+   * @return The number of events handled, which is the number of elements received plus the number of timeout and
+   * callLater callbacks called, plus 1 if the transport lost its connection.  This is 0 if timeoutMilliseconds passed
+   * with nothing to do.
+   * @throw This may throw an exception for reading data or in the callback for processing the data.  If you
+   * call this from an main event loop, you may want to catch and log/disregard all exceptions.
+   */
+  size_t
+  processEvents(Milliseconds timeoutMilliseconds)
+  {
+    return node_.processEvents(timeoutMilliseconds);
+  }
+
   /**
    * Shut down and disconnect this Face.
    */
@@ -117,9 +117,11 @@ public:
   /**
    * Clear this Exclude, and set the entries by copying from the ndn_Exclude struct.
    * @param excludeStruct a C ndn_Exclude struct
+   * @param buffer (optional) For components which are inside the byte array of this Blob, share the array instead of
+   * copying.
    */
   void 
-  set(const struct ndn_Exclude& excludeStruct);
+  set(const struct ndn_Exclude& excludeStruct, const Blob& buffer = Blob());
 
   /**
    * Append a new entry of type ndn_Exclude_ANY.
@@ -288,7 +290,8 @@ public:
   void 
   wireDecode(const uint8_t *input, size_t inputLength, WireFormat& wireFormat = *WireFormat::getDefaultWireFormat()) 
   {
-    wireFormat.decodeInterest(*this, input, inputLength);
+    // Copy the input once so that the decoded fields can share it.
+    wireDecode(Blob(input, inputLength), wireFormat);
   }
   
   /**
@@ -302,6 +305,19 @@ public:
     wireDecode(&input[0], input.size(), wireFormat);
   }
   
+  /**
+   * Decode the input using a particular wire format and update this Interest without copying.  The name components,
+   * exclude components, publisher public key digest and nonce are slices of input which share its byte array.
+   * @param input The input byte array to be decoded.  This takes another reference to the array, which stays allocated
+   * as long as this Interest or one of its fields refers to it.
+   * @param wireFormat A WireFormat object used to decode the input. If omitted, use WireFormat::getDefaultWireFormat().
+   */
+  void 
+  wireDecode(const Blob& input, WireFormat& wireFormat = *WireFormat::getDefaultWireFormat()) 
+  {
+    wireFormat.decodeInterest(*this, input);
+  }
+  
   /**
    * Encode the name according to the "NDN URI Scheme".  If there are interest selectors, append "?" and
    * added the selectors as a query string.  For example "/test/name?ndn.ChildSelector=1".
@@ -360,9 +376,11 @@ public:
   /**
    * Clear this interest, and set the values by copying from the interest struct.
    * @param interestStruct a C ndn_Interest struct
+   * @param buffer (optional) For values which are inside the byte array of this Blob, for example the input which was
+   * decoded into interestStruct, share the array instead of copying.
    */
   void 
-  set(const struct ndn_Interest& interestStruct);
+  set(const struct ndn_Interest& interestStruct, const Blob& buffer = Blob());
   
   void
   setName(const Name& name) { name_ = name; }
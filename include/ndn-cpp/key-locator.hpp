@@ -45,9 +45,11 @@ public:
   /**
    * Clear this key locator, and set the values by copying from the ndn_KeyLocator struct.
    * @param keyLocatorStruct a C ndn_KeyLocator struct
+   * @param buffer (optional) For values which are inside the byte array of this Blob, share the array instead of 
+   * copying.
    */
   void 
-  set(const struct ndn_KeyLocator& keyLocatorStruct);
+  set(const struct ndn_KeyLocator& keyLocatorStruct, const Blob& buffer = Blob());
 
   ndn_KeyLocatorType 
   getType() const { return type_; }
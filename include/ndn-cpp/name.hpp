@@ -22,7 +22,11 @@ struct ndn_Name;
 namespace ndn {
     
 /**
- * A Name holds an array of Name::Component and represents an NDN name.
+ * A Name holds an array of Name::Component and represents an NDN name.  The name keeps the values of all its
+ * components one after the other in a single byte array, and each Name::Component is a slice of that array.  So
+ * building a name takes a few allocations instead of several per component, and equals, match and compare use memcmp
+ * over the contiguous bytes.  The byte array is shared by copies of the name, but only the name which allocated it
+ * appends to it, and only after the bytes of its existing components, so a Component from get(i) never changes.
  */
 class Name {
 public:
@@ -85,7 +89,7 @@ public:
     void 
     toEscapedString(std::ostringstream& result) const
     {
-      Name::toEscapedString(*value_, result);
+      Name::toEscapedString(value_.buf(), value_.size(), result);
     }
 
     /**
@@ -96,7 +100,7 @@ public:
     std::string
     toEscapedString() const
     {
-      return Name::toEscapedString(*value_);
+      return Name::toEscapedString(value_.buf(), value_.size());
     }
     
     /**
@@ -176,7 +180,9 @@ public:
     bool
     equals(const Component& other) const
     {
-      return *value_ == *other.value_;
+      return value_.size() == other.value_.size() && 
+             (value_.size() == 0 || value_.buf() == other.value_.buf() ||
+              memcmp(value_.buf(), other.value_.buf(), value_.size()) == 0);
     }
     
     /**
@@ -242,6 +248,15 @@ public:
     bool
     operator > (const Component& other) const { return compare(other) > 0; }
 
+    /**
+     * Get a hash code of this component value, for a hash table keyed by Component.  Equal components have the same
+     * hash code.  This reads the value a 64-bit word at a time, and the result depends on the byte order of the
+     * machine, so it should not be saved or sent to another process.
+     * @return The hash code.
+     */
+    size_t
+    hash() const;
+
   private:
     Blob value_;
   }; 
@@ -249,23 +264,23 @@ public:
   /**
    * Create a new Name with no components.
    */
-  Name() {
+  Name() 
+  : bufferLength_(0)
+  {
   }
   
   /**
    * Create a new Name, copying the name components.
    * @param components A vector of Component
    */
-  Name(const std::vector<Component>& components)
-  : components_(components)
-  {
-  }
+  Name(const std::vector<Component>& components);
   
   /**
    * Parse the uri according to the NDN URI Scheme and create the name with the components.
    * @param uri The URI string.
    */
   Name(const char* uri)
+  : bufferLength_(0)
   {
     set(uri);
   }
@@ -275,10 +290,38 @@ public:
    * @param uri The URI string.
    */
   Name(const std::string& uri)
+  : bufferLength_(0)
   {
     set(uri.c_str());
   }
 
+  /**
+   * Create a new Name with the same components as name.  This shares the byte array of the components without
+   * copying it.  The new name copies the components to its own byte array on the first append.
+   * @param name The Name to copy.
+   */
+  Name(const Name& name)
+  : components_(name.components_), prefixHashes_(name.prefixHashes_), bufferLength_(0)
+  {
+  }
+
+  /**
+   * Set this name to have the same components as name, sharing the byte array as in the copy constructor.
+   * @param name The Name to copy.
+   * @return This name.
+   */
+  Name&
+  operator = (const Name& name)
+  {
+    if (&name != this) {
+      components_ = name.components_;
+      prefixHashes_ = name.prefixHashes_;
+      buffer_.reset();
+      bufferLength_ = 0;
+    }
+    return *this;
+  }
+
   /**
    * Set the nameStruct to point to the components in this name, without copying any memory.
    * WARNING: The resulting pointers in nameStruct are invalid after a further use of this object which could reallocate memory.
@@ -288,14 +331,15 @@ public:
   get(struct ndn_Name& nameStruct) const;
   
   /**
-   * Clear this name, and set the components by copying from the name struct.
+   * Clear this name, and set the components by copying from the name struct into one byte array.
    * @param nameStruct A C ndn_Name struct
    */
   void 
   set(const struct ndn_Name& nameStruct);
   
   /**
-   * Parse the uri according to the NDN URI Scheme and set the name with the components.
+   * Parse the uri according to the NDN URI Scheme and set the name with the components.  This decodes the components
+   * directly into the byte array of the name without copying the URI.
    * @param uri The null-terminated URI string.
    */
   void 
@@ -315,7 +359,7 @@ public:
   Name& 
   append(const uint8_t *value, size_t valueLength) 
   {
-    components_.push_back(Component(value, valueLength));
+    appendValue(value, valueLength);
     return *this;
   }
 
@@ -326,22 +370,29 @@ public:
   Name& 
   append(const std::vector<uint8_t>& value) 
   {
-    components_.push_back(value);
+    appendValue(value.size() > 0 ? &value[0] : 0, value.size());
     return *this;
   }
   
+  /**
+   * Append a new component, copying from value.
+   * @return This name so that you can chain calls to append.
+   */
   Name& 
   append(const Blob &value)
   {
-    components_.push_back(value);
+    appendValue(value.buf(), value.size());
     return *this;
   }
   
+  /**
+   * Append a new component, copying from value.
+   * @return This name so that you can chain calls to append.
+   */
   Name& 
   append(const Component &value)
   {
-    components_.push_back(value);
-    return *this;
+    return append(value.getValue());
   }
   
   /**
@@ -411,7 +462,9 @@ public:
    */
   void 
   clear() {
+    // Keep the byte array.  The next append writes after bufferLength_ so that it doesn't change removed components.
     components_.clear();
+    prefixHashes_.clear();
   }
   
   /**
@@ -458,6 +511,26 @@ public:
       return getSubName(0, nComponents);
   }
   
+  /**
+   * Get a hash code of the name made from the first nComponents components of this name, for a hash table keyed by
+   * Name.  Equal names have the same hash code.  This name computes the hash code of each of its prefixes once when
+   * the component is appended, so this does not read the component values.  To find the longest prefix of this name
+   * in a hash table of prefixes, look up getPrefixHash(i) for each prefix length i without making each prefix.
+   * Like Component::hash, the result should not be saved or sent to another process.
+   * @param nComponents The number of prefix components, from 0 to size().  getPrefixHash(0) is the hash code of the
+   * empty name.
+   * @return The hash code.
+   */
+  size_t
+  getPrefixHash(size_t nComponents) const;
+
+  /**
+   * Get a hash code of this name, which is the same as getPrefixHash(size()).
+   * @return The hash code.
+   */
+  size_t
+  hash() const { return getPrefixHash(components_.size()); }
+
   /**
    * Encode this name as a URI.
    * @return The encoded URI.
@@ -482,8 +555,7 @@ public:
   Name& 
   appendSegment(uint64_t segment)
   {
-    components_.push_back(Component::fromNumberWithMarker(segment, 0x00));
-    return *this;
+    return append(Component::fromNumberWithMarker(segment, 0x00));
   }
 
   /**
@@ -495,8 +567,7 @@ public:
   Name& 
   appendVersion(uint64_t version)
   {
-    components_.push_back(Component::fromNumberWithMarker(version, 0xFD));
-    return *this;
+    return append(Component::fromNumberWithMarker(version, 0xFD));
   }
   
   /**
@@ -554,7 +625,20 @@ public:
    * @param result the string stream to write to.
    */
   static void 
-  toEscapedString(const std::vector<uint8_t>& value, std::ostringstream& result);
+  toEscapedString(const std::vector<uint8_t>& value, std::ostringstream& result)
+  {
+    toEscapedString(value.size() > 0 ? &value[0] : 0, value.size(), result);
+  }
+
+  /**
+   * Write the value to result, escaping characters according to the NDN URI Scheme.
+   * This also adds "..." to a value with zero or more ".".
+   * @param value Pointer to the value byte array to escape.
+   * @param valueLength Length of value.
+   * @param result the string stream to write to.
+   */
+  static void 
+  toEscapedString(const uint8_t *value, size_t valueLength, std::ostringstream& result);
 
   /**
    * Convert the value by escaping characters according to the NDN URI Scheme.
@@ -563,7 +647,20 @@ public:
    * @return The escaped string.
    */
   static std::string
-  toEscapedString(const std::vector<uint8_t>& value);
+  toEscapedString(const std::vector<uint8_t>& value)
+  {
+    return toEscapedString(value.size() > 0 ? &value[0] : 0, value.size());
+  }
+
+  /**
+   * Convert the value by escaping characters according to the NDN URI Scheme.
+   * This also adds "..." to a value with zero or more ".".
+   * @param value Pointer to the value byte array to escape.
+   * @param valueLength Length of value.
+   * @return The escaped string.
+   */
+  static std::string
+  toEscapedString(const uint8_t *value, size_t valueLength);
 
   //
   // vector equivalent interface.
@@ -683,67 +780,99 @@ public:
   };
   
   //
-  // Iterator interface to name components.
+  // Iterator interface to name components.  The components are slices of the byte array of this name, so the
+  // iterators are read-only.  Use append to add components.
   //
-  typedef std::vector<Component>::iterator iterator;
+  typedef std::vector<Component>::const_iterator iterator;
   typedef std::vector<Component>::const_iterator const_iterator;
-  typedef std::vector<Component>::reverse_iterator reverse_iterator;
+  typedef std::vector<Component>::const_reverse_iterator reverse_iterator;
   typedef std::vector<Component>::const_reverse_iterator const_reverse_iterator;
-  typedef std::vector<Component>::reference reference;
+  typedef std::vector<Component>::const_reference reference;
   typedef std::vector<Component>::const_reference const_reference;
 
   typedef Component partial_type;
 
   /**
-   * Begin iterator (const).
+   * Begin iterator.
    */
   const_iterator
   begin() const { return components_.begin(); }
 
   /**
-   * Begin iterator.
-   */
-  iterator
-  begin() { return components_.begin(); }
-
-  /**
-   * End iterator (const).
+   * End iterator.
    */
   const_iterator
   end() const { return components_.end(); }
 
   /**
-   * End iterator.
+   * Reverse begin iterator.
    */
-  iterator
-  end() { return components_.end(); }
+  const_reverse_iterator
+  rbegin() const { return components_.rbegin(); }
 
   /**
-   * Reverse begin iterator (const).
+   * Reverse end iterator.
    */
   const_reverse_iterator
-  rbegin() const { return components_.rbegin(); }
+  rend() const { return components_.rend(); }
 
+private:
   /**
-   * Reverse begin iterator.
+   * Append a component with a copy of value, written after bufferLength_ in buffer_.  If this name doesn't have its
+   * own byte array with enough room, first copy the existing components to a new, larger byte array.
+   * @param value Pointer to the value byte array.  This may point into the byte array of a component of this name.
+   * @param valueLength Length of value.
    */
-  reverse_iterator
-  rbegin() { return components_.rbegin(); }
+  void
+  appendValue(const uint8_t *value, size_t valueLength);
 
   /**
-   * Reverse end iterator (const).
+   * Append a component with the value decoded from the escaped string according to the NDN URI Scheme, written
+   * after bufferLength_ in buffer_ without a temporary copy.  Ignore an illegal component, as fromEscapedString does.
+   * @param escapedBegin A pointer to the first character of the escaped string.
+   * @param escapedEnd A pointer just past the last character of the escaped string.
    */
-  const_reverse_iterator
-  rend() const { return components_.rend(); }
+  void
+  appendEscapedValue(const char *escapedBegin, const char *escapedEnd);
 
   /**
-   * Reverse end iterator.
+   * Append a component whose value of length valueLength was already written after bufferLength_ in buffer_.
+   * @param valueLength The length of the value.
    */
-  reverse_iterator
-  rend() { return components_.rend(); }
+  void
+  appendBufferedValue(size_t valueLength);
+
+  /**
+   * Make sure that buffer_ is the byte array of this name with room for valuesLength more bytes after bufferLength_.
+   * If not, copy the values of the existing components to a new byte array and make the components slices of it.
+   * @param valuesLength The number of bytes to make room for.
+   * @param capacity The size of a new byte array.  If this is less than the needed size, use the needed size.
+   */
+  void
+  reserveBuffer(size_t valuesLength, size_t capacity);
+
+  /**
+   * Get the total number of bytes in the values of the first nComponents components, which are contiguous.
+   * @param nComponents The number of components.
+   * @return The number of bytes.
+   */
+  size_t
+  getValuesLength(size_t nComponents) const;
+
+  /**
+   * Check if the first nComponents components of this name equal those of name.  Both names must have at least
+   * nComponents components.
+   * @param name The other Name.
+   * @param nComponents The number of components to check.
+   * @return true if the components are equal, otherwise false.
+   */
+  bool
+  equalsFirst(const Name& name, size_t nComponents) const;
 
-private:
   std::vector<Component> components_;
+  std::vector<size_t> prefixHashes_; /**< prefixHashes_[i] is getPrefixHash(i + 1). */
+  Blob buffer_;         /**< The byte array allocated by this name, or null if the components are in a shared array. */
+  size_t bufferLength_; /**< The number of bytes of buffer_ which have been written. */
 };  
 
 inline std::ostream&
@@ -753,7 +882,36 @@ operator << (std::ostream& os, const Name& name)
   return os;
 }
 
+/**
+ * Return component.hash() so that boost::hash (and ndnboost::hash) can hash a Name::Component.
+ */
+inline size_t
+hash_value(const Name::Component& component) { return component.hash(); }
+
+/**
+ * Return name.hash() so that boost::hash (and ndnboost::hash) can hash a Name.
+ */
+inline size_t
+hash_value(const Name& name) { return name.hash(); }
+
 }
 
+#if NDN_CPP_HAVE_STD_FUNCTION
+// The standard library has std::function, so it also has std::hash for unordered_map and unordered_set.
+namespace std {
+
+template<> struct hash<ndn::Name::Component> {
+  size_t
+  operator() (const ndn::Name::Component& component) const { return component.hash(); }
+};
+
+template<> struct hash<ndn::Name> {
+  size_t
+  operator() (const ndn::Name& name) const { return name.hash(); }
+};
+
+}
+#endif
+
 #endif
 
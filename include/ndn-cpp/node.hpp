@@ -8,6 +8,7 @@
 #ifndef NDN_NODE_HPP
 #define NDN_NODE_HPP
 
+#include <map>
 #include "common.hpp"
 #include "interest.hpp"
 #include "data.hpp"
@@ -16,6 +17,7 @@
 #include "encoding/element-listener.hpp"
 
 struct ndn_Interest;
+struct ndn_Name;
 
 namespace ndn {
 
@@ -40,8 +42,19 @@ typedef func_lib::function<void
  */
 typedef func_lib::function<void(const ptr_lib::shared_ptr<const Name>&)> OnRegisterFailed;
 
+/**
+ * An OnCallLater function object is used to pass a callback to callLater.
+ */
+typedef func_lib::function<void()> OnCallLater;
+
 class Face;
 class KeyChain;
+class TimerQueue;
+class ContentStore;
+class Poller;
+class Executor;
+template<class T> class NameTrie;
+template<class T> class MpscQueue;
     
 class Node : public ElementListener {
 public:
@@ -51,12 +64,18 @@ public:
    * @param transport A shared_ptr to a Transport::ConnectionInfo to be used to connect to the transport.
    */
   Node(const ptr_lib::shared_ptr<Transport>& transport, const ptr_lib::shared_ptr<const Transport::ConnectionInfo>& connectionInfo);
+
+  ~Node();
   
   /**
    * Send the Interest through the transport, read the entire response and call onData(interest, data).
+   * If an identical interest (with the same wire encoding) is already pending and was sent within its interest
+   * lifetime, this does not send the interest again but only adds the callbacks, so that one data packet satisfies
+   * both.  An incoming data packet satisfies every pending interest which it matches.
    * @param interest A reference to the Interest.  This copies the Interest.
    * @param onData A function object to call when a matching data packet is received.  This copies the function object, so you may need to
-   * use func_lib::ref() as appropriate.
+   * use func_lib::ref() as appropriate.  When the data packet satisfies more than one pending interest, each onData
+   * receives the same Data object, so it should not modify it.
    * @param onTimeout A function object to call if the interest times out.  If onTimeout is an empty OnTimeout(), this does not use it.
    * This copies the function object, so you may need to use func_lib::ref() as appropriate.
    * @param wireFormat A WireFormat object used to encode the message.
@@ -73,6 +92,14 @@ public:
    */
   void
   removePendingInterest(uint64_t pendingInterestId);
+
+  /**
+   * Remove every pending interest entry whose interest name has prefix as a prefix (including prefix itself) from the
+   * pending interest table, without calling their timeout callbacks.
+   * @param prefix The name prefix of the pending interests to remove.
+   */
+  void
+  removePendingInterestsWithPrefix(const Name& prefix);
   
   /**
    * Register prefix with the connected NDN hub and call onInterest when a matching interest is received.
@@ -100,7 +127,101 @@ public:
   removeRegisteredPrefix(uint64_t registeredPrefixId);
 
   /**
-   * Process any data to receive.  For each element received, call onReceivedElement.
+   * Call callback from processEvents after delayMilliseconds.
+   * @param delayMilliseconds The delay in milliseconds from now.  If this is 0 or negative, call callback from the
+   * next call to processEvents.
+   * @param callback A function object to call.  This copies the function object, so you may need to
+   * use func_lib::ref() as appropriate.
+   * @return The call later ID which can be used with cancelCallLater.
+   */
+  uint64_t
+  callLater(Milliseconds delayMilliseconds, const OnCallLater& callback);
+
+  /**
+   * Cancel the callback for the callLaterId so that it is not called.
+   * If there is no callback with the callLaterId (or it was already called), do nothing.
+   * @param callLaterId The ID returned from callLater.
+   */
+  void
+  cancelCallLater(uint64_t callLaterId);
+
+  /**
+   * Set the budget of the content store which caches the data packets that satisfy pending interests.  While the
+   * content store is enabled, expressInterest answers an interest from the content store if a cached data packet
+   * matches it (unless the interest answerOriginKind excludes the content store), without sending the interest.  The
+   * onData callback is then called from the next call to processEvents.  A cached data packet becomes stale after its
+   * freshnessSeconds, and the least recently used data packets are evicted to stay within the budget.
+   * The content store is disabled by default.
+   * @param maxBytes The maximum total number of bytes in the wire encodings of the cached data packets.  If this is
+   * 0, disable the content store and remove the cached data packets.
+   */
+  void
+  setContentStoreMaxBytes(size_t maxBytes);
+
+  /**
+   * Add the data packet to the producer store, replacing a stored data packet with the same name.  While a matching
+   * data packet is in the producer store, onReceivedElement answers an incoming interest by sending its wire encoding,
+   * without calling the OnInterest callback, so the application doesn't build, sign and encode it again.  A stored
+   * data packet becomes stale after its freshnessSeconds, and the least recently used data packets are evicted to stay
+   * within the budget set by setProducerStoreMaxBytes, which is 16 MB until it is called.
+   * @param data The signed data packet.  This uses data.getDefaultWireEncoding() if it has one, otherwise it encodes.
+   * @param wireFormat A WireFormat object used to encode the data packet.
+   * @return The wire encoding, which the application can send to answer the interest that it is processing.
+   */
+  Blob
+  putData(const Data& data, WireFormat& wireFormat);
+
+  /**
+   * Set the budget of the producer store for putData, evicting the least recently used data packets if needed.
+   * @param maxBytes The maximum total number of bytes in the wire encodings of the stored data packets.
+   */
+  void
+  setProducerStoreMaxBytes(size_t maxBytes);
+
+  /**
+   * Get the number of incoming interests which were answered from the producer store.  The hit rate is
+   * getProducerStoreHitCount() / (getProducerStoreHitCount() + getProducerStoreMissCount()).
+   */
+  uint64_t
+  getProducerStoreHitCount() const { return nProducerStoreHits_; }
+
+  /**
+   * Get the number of incoming interests, received after the first call to putData, which the producer store did
+   * not answer.
+   */
+  uint64_t
+  getProducerStoreMissCount() const { return nProducerStoreMisses_; }
+
+  /**
+   * Enable the thread-safe mode, in which any thread can call expressInterest, removePendingInterest and putData while
+   * one thread calls processEvents.  A call from a thread other than the one in processEvents encodes the packet on the
+   * calling thread, then adds the request to a lock-free queue and wakes processEvents, which carries out the queued
+   * requests in the order that each thread made them.  A call from a callback inside processEvents is carried out
+   * immediately as usual.  All callbacks are called from the thread in processEvents.  The other methods are not
+   * thread-safe.  Call this before other threads use the Node.
+   * @throw runtime_error if the wakeup file descriptor can't be created.
+   */
+  void
+  enableThreadSafeMode();
+
+  /**
+   * Call the OnData, OnTimeout and OnInterest callbacks with the executor, for example a ThreadPoolExecutor, instead
+   * of from processEvents, so that a slow callback doesn't stall receiving.  The packets are still decoded by
+   * processEvents, and each callback gets the decoded Data or Interest.  This enables the thread-safe mode so that the
+   * callbacks can call expressInterest, removePendingInterest and putData, and the Transport given to OnInterest
+   * queues what it sends for processEvents to send.  Destroy the executor (which should finish its tasks) before this
+   * Node.
+   * @param executor The executor for the callbacks, or a null shared_ptr to call them from processEvents again.
+   * @param preserveOrder If true, give the executor an order key so that the OnInterest callbacks for the same
+   * registered prefix are called one at a time in the order that the interests were received, and likewise for the
+   * callbacks of the same pending interest.  If false, the callbacks can be called in any order.
+   */
+  void
+  setCallbackExecutor(const ptr_lib::shared_ptr<Executor>& executor, bool preserveOrder);
+
+  /**
+   * Process any data to receive.  For each element received, call onReceivedElement.  Then call the timeout
+   * callback of each expired pending interest and each callLater callback which is due.
    * This is non-blocking and will return immediately if there is no data to receive.
    * You should repeatedly call this from an event loop, with calls to sleep as needed so that the loop doesn't use 100% of the CPU.
    * @throw This may throw an exception for reading data or in the callback for processing the data.  If you
@@ -108,6 +229,20 @@ public:
    */
   void 
   processEvents();
+
+  /**
+   * Process any data to receive and call timeout and callLater callbacks like processEvents().  If there is nothing
+   * to do, block until the transport has data to receive, a callback is due or timeoutMilliseconds passes, and try again.
+   * This returns as soon as at least one event is handled, so you can call this in a loop without sleeping.
+   * @param timeoutMilliseconds The maximum time to block in milliseconds.  If this is 0, don't block.
+   * @return The number of events handled, which is the number of elements received plus the number of timeout and
+   * callLater callbacks called, plus the number of requests queued by other threads in the thread-safe mode, plus 1 if
+   * the transport lost its connection.  This is 0 if timeoutMilliseconds passed with nothing to do.
+   * @throw This may throw an exception for reading data or in the callback for processing the data.  If you
+   * call this from an main event loop, you may want to catch and log/disregard all exceptions.
+   */
+  size_t
+  processEvents(Milliseconds timeoutMilliseconds);
   
   const ptr_lib::shared_ptr<Transport>& 
   getTransport() { return transport_; }
@@ -128,12 +263,13 @@ private:
      * Create a new PitEntry and set the timeoutTime_ based on the current time and the interest lifetime.
      * @param pendingInterestId A unique ID for this entry, which you should get with getNextPendingInteresId().
      * @param interest A shared_ptr for the interest.
+     * @param encoding The wire encoding of the interest, used to send it and to find identical interests.
      * @param onData A function object to call when a matching data packet is received.
      * @param onTimeout A function object to call if the interest times out.  If onTimeout is an empty OnTimeout(), this does not use it.
      */
     PendingInterest
-      (uint64_t pendingInterestId, const ptr_lib::shared_ptr<const Interest>& interest, const OnData& onData, 
-       const OnTimeout& onTimeout);
+      (uint64_t pendingInterestId, const ptr_lib::shared_ptr<const Interest>& interest, const Blob& encoding,
+       const OnData& onData, const OnTimeout& onTimeout);
     
     /**
      * Return the next unique pending interest ID.
@@ -141,7 +277,8 @@ private:
     static uint64_t 
     getNextPendingInterestId()
     {
-      return ++lastPendingInterestId_;
+      // Use an atomic increment since expressInterest can be called from any thread in the thread-safe mode.
+      return __atomic_add_fetch(&lastPendingInterestId_, 1, __ATOMIC_RELAXED);
     }
     
     /**
@@ -152,6 +289,17 @@ private:
     
     const ptr_lib::shared_ptr<const Interest>& 
     getInterest() { return interest_; }
+
+    const Blob&
+    getEncoding() { return encoding_; }
+
+    /**
+     * Check if the encoding of this interest is the same as the encoding of the other interest.
+     * @param other The other entry.
+     * @return true if the encodings have the same bytes.
+     */
+    bool
+    hasSameEncoding(PendingInterest& other);
     
     const OnData& 
     getOnData() { return onData_; }
@@ -171,16 +319,46 @@ private:
     }
     
     /**
-     * Check if this interest is timed out.
-     * @param nowMilliseconds The current time in milliseconds from ndn_getNowMilliseconds.
-     * @return true if this interest timed out, otherwise false.
+     * Get the time when the interest times out.
+     * @return The time in milliseconds according to ndn_getNowMilliseconds, or -1 for no timeout.
+     */
+    MillisecondsSince1970
+    getTimeoutTimeMilliseconds() { return timeoutTimeMilliseconds_; }
+
+    /**
+     * Get the time when the last transmission of this interest, by this entry or by an identical entry which it was
+     * aggregated with, expires in the forwarder.
+     * @return The time in milliseconds according to ndn_getNowMilliseconds, or -1 if it doesn't expire.
      */
-    bool 
-    isTimedOut(MillisecondsSince1970 nowMilliseconds)
+    MillisecondsSince1970
+    getTransmissionExpireTimeMilliseconds() { return transmissionExpireTimeMilliseconds_; }
+
+    void
+    setTransmissionExpireTimeMilliseconds(MillisecondsSince1970 transmissionExpireTimeMilliseconds)
     {
-      return timeoutTimeMilliseconds_ >= 0.0 && nowMilliseconds >= timeoutTimeMilliseconds_;
+      transmissionExpireTimeMilliseconds_ = transmissionExpireTimeMilliseconds;
     }
 
+    /**
+     * Get the ID of the timer in the Node's timerQueue_ which calls the timeout.
+     * @return The timer ID, or 0 if there is no timer.
+     */
+    uint64_t
+    getTimerId() { return timerId_; }
+
+    void
+    setTimerId(uint64_t timerId) { timerId_ = timerId; }
+
+    /**
+     * Check if the callbacks are called with the Node's callback executor, which is false for the Node's own
+     * interests.
+     */
+    bool
+    getUseCallbackExecutor() { return useCallbackExecutor_; }
+
+    void
+    setUseCallbackExecutor(bool useCallbackExecutor) { useCallbackExecutor_ = useCallbackExecutor; }
+
     /**
      * Call onTimeout_ (if defined).  This ignores exceptions from the onTimeout_.
      */
@@ -189,6 +367,7 @@ private:
     
   private:
     ptr_lib::shared_ptr<const Interest> interest_;
+    Blob encoding_;
     std::vector<struct ndn_NameComponent> nameComponents_;
     std::vector<struct ndn_ExcludeEntry> excludeEntries_;
     ptr_lib::shared_ptr<struct ndn_Interest> interestStruct_;
@@ -198,6 +377,9 @@ private:
     const OnData onData_;
     const OnTimeout onTimeout_;
     MillisecondsSince1970 timeoutTimeMilliseconds_; /**< The time when the interest times out in milliseconds according to ndn_getNowMilliseconds, or -1 for no timeout. */
+    MillisecondsSince1970 transmissionExpireTimeMilliseconds_; /**< See getTransmissionExpireTimeMilliseconds. */
+    uint64_t timerId_;                      /**< The ID of the timeout timer in the Node's timerQueue_, or 0 for none. */
+    bool useCallbackExecutor_;
   };
 
   class RegisteredPrefix {
@@ -301,13 +483,41 @@ private:
   };
   
   /**
-   * Find the entry from the pit_ where the name conforms to the entry's interest selectors, and
-   * the entry interest name is the longest that matches name.
-   * @param name The name to find the interest for (from the incoming data packet).
-   * @return The index in pit_ of the pit entry, or -1 if not found.
+   * Find every entry in the pendingInterestTable_ where the name conforms to the entry's interest selectors.
+   * @param name The name to find the interests for (from the incoming data packet).
+   * @param nameStruct The same name as an ndn_Name struct, used to check the interest selectors.
+   * @param entries Append the matching entries to this vector, with shorter interest names first.
    */
-  int 
-  getEntryIndexForExpressedInterest(const Name& name);
+  void
+  getEntriesForExpressedInterest
+    (const Name& name, const struct ndn_Name& nameStruct, std::vector<ptr_lib::shared_ptr<PendingInterest> >& entries);
+
+  /**
+   * Find an entry in the pendingInterestTable_, other than pendingInterest, with the same interest encoding and a
+   * transmission which has not expired, so that pendingInterest doesn't need to send the interest.
+   * @param pendingInterest The entry to check.
+   * @param nowMilliseconds The current time according to ndn_getNowMilliseconds.
+   * @return A pointer to the entry, or 0 if not found.
+   */
+  PendingInterest*
+  getEntryWithLiveTransmission(PendingInterest& pendingInterest, MillisecondsSince1970 nowMilliseconds);
+
+  /**
+   * Set the transmission expire time of pendingInterest from an identical entry whose transmission has not expired,
+   * or else send the interest and set the expire time from the interest lifetime.
+   * @param pendingInterest The entry to send.
+   * @param nowMilliseconds The current time according to ndn_getNowMilliseconds.
+   */
+  void
+  sendOrAggregate(PendingInterest& pendingInterest, MillisecondsSince1970 nowMilliseconds);
+
+  /**
+   * Schedule the timer of pendingInterest in the timerQueue_ for the earlier of its timeout and the expire time of
+   * its transmission.  Do nothing if neither expires.
+   * @param pendingInterest The entry from the pendingInterestTable_.
+   */
+  void
+  schedulePendingInterestTimer(const ptr_lib::shared_ptr<PendingInterest>& pendingInterest);
   
   /**
    * Find the first entry from the registeredPrefixTable_ where the entry prefix is the longest that matches name.
@@ -317,6 +527,117 @@ private:
   RegisteredPrefix*
   getEntryForRegisteredPrefix(const Name& name);
 
+  /**
+   * This is called by the timerQueue_ for a pending interest which was answered from the contentStore_.  If it is
+   * still in pendingInterestsById_, remove it and call its onData callback.
+   * @param pendingInterest The entry from pendingInterestsById_.
+   * @param data The data packet from the contentStore_.
+   */
+  void
+  satisfyFromContentStore(const ptr_lib::shared_ptr<PendingInterest>& pendingInterest, const ptr_lib::shared_ptr<Data>& data);
+
+  /**
+   * This is called by the timerQueue_ when the pending interest times out or its transmission expires.  If it is
+   * still in the pendingInterestTable_ and has timed out, remove it and call its timeout callback.  Otherwise
+   * send the interest again (unless an identical entry has already sent it) and schedule the timer again.
+   * @param pendingInterest The entry from the pendingInterestTable_.
+   */
+  void
+  timeoutPendingInterest(const ptr_lib::shared_ptr<PendingInterest>& pendingInterest);
+
+  /**
+   * Remove the pending interest from the pendingInterestTable_ and pendingInterestsById_, and cancel its timeout.
+   * @param pendingInterest The entry from the pendingInterestTable_.
+   * @return true if the entry was found and removed, otherwise false.
+   */
+  bool
+  erasePendingInterest(const ptr_lib::shared_ptr<PendingInterest>& pendingInterest);
+
+  class QueueingTransport;
+
+  /**
+   * Do the work of expressInterest.
+   * @param useCallbackExecutor If false, always call the callbacks from processEvents, for the Node's own interests.
+   */
+  uint64_t
+  expressInterest
+    (const Interest& interest, const OnData& onData, const OnTimeout& onTimeout, WireFormat& wireFormat,
+     bool useCallbackExecutor);
+
+  /**
+   * Call the onData callback of pendingInterest, or give the call to the callbackExecutor_.
+   * @param pendingInterest The entry which was removed from the pending interest table.
+   * @param data The data packet which satisfies it.
+   */
+  void
+  callOnData(const ptr_lib::shared_ptr<PendingInterest>& pendingInterest, const ptr_lib::shared_ptr<Data>& data);
+
+  /**
+   * Call the timeout callback of pendingInterest, or give the call to the callbackExecutor_.
+   * @param pendingInterest The entry which was removed from the pending interest table.
+   */
+  void
+  callTimeout(const ptr_lib::shared_ptr<PendingInterest>& pendingInterest);
+
+  /**
+   * Do the work of expressInterest on the thread in processEvents: answer the interest from the contentStore_, or
+   * send it and add it to the pending interest table.
+   * @param pendingInterest The new entry.
+   */
+  void
+  expressPendingInterest(const ptr_lib::shared_ptr<PendingInterest>& pendingInterest);
+
+  /**
+   * Do the work of removePendingInterest on the thread in processEvents.
+   * @param pendingInterestId The ID returned from expressInterest.
+   */
+  void
+  removePendingInterestById(uint64_t pendingInterestId);
+
+  /**
+   * Do the work of putData on the thread in processEvents: add the data packet to the producerStore_.
+   * @param data The copy of the data packet to store.
+   * @param encoding The wire encoding of the data packet.
+   */
+  void
+  addToProducerStore(const ptr_lib::shared_ptr<Data>& data, const Blob& encoding);
+
+  /**
+   * Check if a call to expressInterest, removePendingInterest or putData must be queued for the thread in
+   * processEvents, which is when the thread-safe mode is enabled and the caller is not inside processEvents.
+   */
+  bool
+  isQueueingRequests();
+
+  /**
+   * Add the request to the requests_ queue and, unless a wakeup is already pending, wake the thread in processEvents.
+   * @param request The function object to call from processEvents.
+   */
+  void
+  queueRequest(const func_lib::function<void()>& request);
+
+  /**
+   * Call the requests in the requests_ queue.
+   * @return The number of requests called.
+   */
+  size_t
+  processRequests();
+
+  /**
+   * Do the work of processEvents() without blocking.
+   * @return The number of elements received plus the number of timeout and callLater callbacks and queued requests
+   * called.
+   */
+  size_t
+  processReadyEvents();
+
+  /**
+   * Connect the transport_ and make the poller_ forget the file descriptor of the previous connection, since the new
+   * connection may reuse the same number.
+   */
+  void
+  connectTransport();
+
   /**
    * Do the work of registerPrefix once we know we are connected with an ndndId_.
    * @param registeredPrefixId The PrefixEntry::getNextRegisteredPrefixId() which registerPrefix got so it could return it to the caller.
@@ -333,10 +654,35 @@ private:
   
   ptr_lib::shared_ptr<Transport> transport_;
   ptr_lib::shared_ptr<const Transport::ConnectionInfo> connectionInfo_;
-  std::vector<ptr_lib::shared_ptr<PendingInterest> > pendingInterestTable_;
-  std::vector<ptr_lib::shared_ptr<RegisteredPrefix> > registeredPrefixTable_;
+  // The pending interest table is keyed by the interest name so that an incoming data packet only walks its own name.
+  ptr_lib::shared_ptr<NameTrie<ptr_lib::shared_ptr<PendingInterest> > > pendingInterestTable_;
+  // The same entries as pendingInterestTable_, keyed by pendingInterestId so that removePendingInterest doesn't scan.
+  std::map<uint64_t, ptr_lib::shared_ptr<PendingInterest> > pendingInterestsById_;
+  // The interest timeouts and callLater callbacks, ordered by time so that processEvents only touches the expired ones.
+  ptr_lib::shared_ptr<TimerQueue> timerQueue_;
+  // The registered prefix table is keyed by the prefix so that an incoming interest only walks its own name.
+  ptr_lib::shared_ptr<NameTrie<ptr_lib::shared_ptr<RegisteredPrefix> > > registeredPrefixTable_;
+  // The same entries as registeredPrefixTable_, keyed by registeredPrefixId so that removeRegisteredPrefix doesn't scan.
+  std::map<uint64_t, ptr_lib::shared_ptr<RegisteredPrefix> > registeredPrefixesById_;
+  ptr_lib::shared_ptr<ContentStore> contentStore_; /**< The cache of received data packets, or null if disabled. */
+  ptr_lib::shared_ptr<ContentStore> producerStore_; /**< The data packets from putData, or null before the first call. */
+  size_t producerStoreMaxBytes_;
+  uint64_t nProducerStoreHits_;
+  uint64_t nProducerStoreMisses_;
   Interest ndndIdFetcherInterest_;
   Blob ndndId_;
+  ptr_lib::shared_ptr<Poller> poller_;  /**< Created by the first call to processEvents(timeoutMilliseconds). */
+  int pollerFileDescriptor_;            /**< The transport file descriptor in poller_, or -1 for none. */
+  size_t nReceivedElements_;            /**< The number of calls to onReceivedElement, used to count events. */
+  // The requests from other threads in the thread-safe mode, or null if it is not enabled.
+  ptr_lib::shared_ptr<MpscQueue<func_lib::function<void()> > > requests_;
+  int wakeupReadFileDescriptor_;        /**< The eventfd (or pipe) which wakes processEvents, or -1 for none. */
+  int wakeupWriteFileDescriptor_;       /**< The same eventfd (or the write end of the pipe), or -1 for none. */
+  int isWakeupPending_;                 /**< Nonzero if a thread has written to the wakeup, accessed atomically. */
+  ptr_lib::shared_ptr<Executor> callbackExecutor_; /**< The executor for the callbacks, or null to call them inline. */
+  bool preserveCallbackOrder_;
+  // The transport given to OnInterest callbacks on the callbackExecutor_, which queues sends for processEvents.
+  ptr_lib::shared_ptr<Transport> queueingTransport_;
 };
 
 }
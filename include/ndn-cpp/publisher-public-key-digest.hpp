@@ -36,9 +36,10 @@ public:
   /**
    * Clear this PublisherPublicKeyDigest, and copy from the ndn_PublisherPublicKeyDigest struct.
    * @param excludeStruct a C ndn_Exclude struct
+   * @param buffer (optional) If the digest is inside the byte array of this Blob, share the array instead of copying.
    */
   void 
-  set(const struct ndn_PublisherPublicKeyDigest& publisherPublicKeyDigestStruct);
+  set(const struct ndn_PublisherPublicKeyDigest& publisherPublicKeyDigestStruct, const Blob& buffer = Blob());
 
   const Blob& 
   getPublisherPublicKeyDigest() const { return publisherPublicKeyDigest_; }
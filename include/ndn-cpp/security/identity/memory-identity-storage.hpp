@@ -183,8 +183,8 @@ private:
   
   std::vector<std::string> identityStore_; /**< A list of name URI. */
   std::string defaultIdentity_;            /**< The default identity in identityStore_, or "" if not defined. */
-  std::map<std::string, ptr_lib::shared_ptr<KeyRecord> > keyStore_; /**< The map key is the keyName.toUri() */
-  std::map<std::string, Blob> certificateStore_;                    /**< The map key is the certificateName.toUri() */
+  std::map<Name, ptr_lib::shared_ptr<KeyRecord> > keyStore_; /**< The map key is the keyName. */
+  std::map<Name, Blob> certificateStore_;                    /**< The map key is the certificateName. */
 };
 
 }
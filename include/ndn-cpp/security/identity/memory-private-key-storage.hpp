@@ -123,8 +123,8 @@ private:
     struct rsa_st* privateKey_;
   };
     
-  std::map<std::string, ptr_lib::shared_ptr<PublicKey> > publicKeyStore_;      /**< The map key is the keyName.toUri() */
-  std::map<std::string, ptr_lib::shared_ptr<RsaPrivateKey> > privateKeyStore_; /**< The map key is the keyName.toUri() */
+  std::map<Name, ptr_lib::shared_ptr<PublicKey> > publicKeyStore_;      /**< The map key is the keyName. */
+  std::map<Name, ptr_lib::shared_ptr<RsaPrivateKey> > privateKeyStore_; /**< The map key is the keyName. */
 };
 
 }
@@ -41,6 +41,15 @@ public:
   virtual void 
   set(const struct ndn_Signature& signatureStruct);
 
+  /**
+   * Clear this signature, and set the values from the ndn_Signature struct, sharing the byte array of buffer for 
+   * values which are inside it instead of copying.
+   * @param signatureStruct a C ndn_Signature struct
+   * @param buffer The Blob whose byte array may contain the values in signatureStruct, for example the decoder input.
+   */
+  virtual void 
+  set(const struct ndn_Signature& signatureStruct, const Blob& buffer);
+
   const Blob& 
   getDigestAlgorithm() const { return digestAlgorithm_; }
 
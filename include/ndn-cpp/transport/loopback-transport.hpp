@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_LOOPBACKTRANSPORT_HPP
+#define NDN_LOOPBACKTRANSPORT_HPP
+
+#include <vector>
+#include "../common.hpp"
+#include "transport.hpp"
+
+namespace ndn {
+
+class MiniForwarder;
+
+/**
+ * A LoopbackTransport connects to a MiniForwarder in the same process as one of its faces, so that a Face using it
+ * exchanges interests and data with the other Face objects connected to the same MiniForwarder.  Sending passes the
+ * element to the forwarder without copying it, and processEvents passes each element which the forwarder sent to this
+ * face to the ElementListener.  getFileDescriptor returns an eventfd (or a pipe) which becomes readable when the
+ * forwarder sends an element to this face, so that Face::processEvents(timeoutMilliseconds) can block until then.
+ */
+class LoopbackTransport : public Transport {
+public:
+  /**
+   * A LoopbackTransport::ConnectionInfo extends Transport::ConnectionInfo to hold the MiniForwarder to connect to.
+   */
+  class ConnectionInfo : public Transport::ConnectionInfo {
+  public:
+    /**
+     * Create a ConnectionInfo with the given forwarder.
+     * @param forwarder The MiniForwarder which the transport connects to as a new face.
+     */
+    ConnectionInfo(const ptr_lib::shared_ptr<MiniForwarder>& forwarder)
+    : forwarder_(forwarder)
+    {
+    }
+
+    /**
+     * Get the forwarder given to the constructor.
+     * @return The MiniForwarder.
+     */
+    const ptr_lib::shared_ptr<MiniForwarder>&
+    getForwarder() const { return forwarder_; }
+
+    virtual
+    ~ConnectionInfo();
+
+  private:
+    ptr_lib::shared_ptr<MiniForwarder> forwarder_;
+  };
+
+  LoopbackTransport();
+
+  /**
+   * Connect to the forwarder in ConnectionInfo as a new face, and processEvents() will use elementListener.
+   * @param connectionInfo A reference to a LoopbackTransport::ConnectionInfo.
+   * @param elementListener Not a shared_ptr because we assume that it will remain valid during the life of this object.
+   */
+  virtual void
+  connect(const Transport::ConnectionInfo& connectionInfo, ElementListener& elementListener);
+
+  /**
+   * Copy the data to a Blob and send it to the forwarder.
+   * @param data A pointer to the buffer of data to send.
+   * @param dataLength The number of bytes in data.
+   */
+  virtual void
+  send(const uint8_t *data, size_t dataLength);
+
+  /**
+   * Send the data to the forwarder, which forwards it to the other faces without copying it.
+   * @param data The data to send.
+   */
+  virtual void
+  send(const Blob& data);
+
+  /**
+   * Call elementListener.onReceivedElement for each element which the forwarder sent to this face since the last call.
+   * An element which is sent to this face by a callback is not received until the next call.
+   * You should normally not call this directly since it is called by Face.processEvents.
+   * @throw This may throw an exception in the callback for processing the data.  If you call this from an main event
+   * loop, you may want to catch and log/disregard all exceptions.
+   */
+  virtual void
+  processEvents();
+
+  virtual bool
+  getIsConnected();
+
+  /**
+   * Get the file descriptor which becomes readable when the forwarder has sent an element to this face which
+   * processEvents has not received.
+   * @return The file descriptor, or -1 if not connected.
+   */
+  virtual int
+  getFileDescriptor();
+
+  /**
+   * Remove this face from the forwarder, along with its registered prefixes, and discard the received elements.
+   */
+  virtual void
+  close();
+
+  ~LoopbackTransport();
+
+private:
+  friend class MiniForwarder;
+
+  /**
+   * Queue the element for processEvents and make the file descriptor readable.  This is called by the forwarder.
+   * @param element The encoded element.
+   */
+  void
+  receive(const Blob& element);
+
+  /**
+   * Read the wakeup file descriptor until it is not readable.
+   */
+  void
+  clearWakeup();
+
+  ptr_lib::shared_ptr<MiniForwarder> forwarder_;
+  uint64_t faceId_;
+  ElementListener *elementListener_;
+  std::vector<Blob> receiveQueue_;    /**< The elements which the forwarder sent to this face. */
+  std::vector<Blob> processingQueue_; /**< The elements which processEvents is passing to the elementListener_. */
+  int wakeupReadFileDescriptor_;      /**< Readable while receiveQueue_ is not empty. */
+  int wakeupWriteFileDescriptor_;     /**< The same as wakeupReadFileDescriptor_ for an eventfd. */
+};
+
+}
+
+#endif
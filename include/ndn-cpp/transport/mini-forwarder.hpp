@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_MINI_FORWARDER_HPP
+#define NDN_MINI_FORWARDER_HPP
+
+#include <map>
+#include <vector>
+#include "../common.hpp"
+#include "../name.hpp"
+#include "../util/blob.hpp"
+
+namespace ndn {
+
+class Interest;
+class LoopbackTransport;
+class TimerQueue;
+template<class T> class NameTrie;
+
+/**
+ * A MiniForwarder is a small NDN forwarder inside the application process.  Each LoopbackTransport connected to it is
+ * a face of the forwarder, so that several Face objects in one process can exchange interests and data without an
+ * NDN hub or any sockets, for example to test an application or benchmark it offline.
+ * The forwarder answers the ndndId request and the /ndnx/<ndndId>/selfreg interest which Face::registerPrefix sends
+ * by adding the prefix to its FIB.  It forwards every other interest to the faces with the longest registered prefix
+ * of the interest name and keeps a PIT entry until a data packet satisfies it or the interest lifetime passes.  An
+ * interest with the same name and selectors as a PIT entry from another face is added to that entry and not forwarded
+ * again.  A data packet is sent to the faces of every PIT entry which it satisfies, and is dropped if there is none.
+ * The forwarder does all of this in the call to LoopbackTransport::send, and queues each element for the receiving
+ * LoopbackTransport to pass to its ElementListener in processEvents.  This is not thread safe, so all the faces must
+ * be used in the same thread.
+ */
+class MiniForwarder {
+public:
+  MiniForwarder();
+
+  /**
+   * Get the ndndId which this forwarder returns as the publisher public key digest of its key.
+   * @return The 32-byte ndndId.
+   */
+  const Blob&
+  getNdndId() const { return ndndId_; }
+
+  /**
+   * Get the number of entries in the PIT, including expired entries which are not yet removed.
+   * @return The number of PIT entries.
+   */
+  size_t
+  getPitSize() const;
+
+  /**
+   * Get the number of prefixes registered by all the faces.
+   * @return The number of FIB entries.
+   */
+  size_t
+  getFibSize() const;
+
+  ~MiniForwarder();
+
+private:
+  friend class LoopbackTransport;
+  class PitEntry;
+
+  /**
+   * A FibEntry holds a prefix registered by a face.
+   */
+  class FibEntry {
+  public:
+    FibEntry(const Name& prefix, uint64_t faceId)
+    : prefix_(prefix), faceId_(faceId)
+    {
+    }
+
+    Name prefix_;
+    uint64_t faceId_;
+  };
+
+  /**
+   * Add the transport as a new face.
+   * @param transport The LoopbackTransport which receives the elements sent to the face.  It must call removeFace
+   * before it is destroyed.
+   * @return The face ID for onReceivedElement and removeFace.
+   */
+  uint64_t
+  addFace(LoopbackTransport *transport);
+
+  /**
+   * Remove the face and the prefixes it registered.
+   * @param faceId The face ID returned by addFace.
+   */
+  void
+  removeFace(uint64_t faceId);
+
+  /**
+   * Process the element sent by the face.  Ignore an element which is not an interest or data packet.
+   * @param faceId The face ID of the sender.
+   * @param element The encoded interest or data packet.  This is forwarded without copying its buffer.
+   */
+  void
+  onReceivedElement(uint64_t faceId, const Blob& element);
+
+  void
+  onReceivedInterest(uint64_t faceId, const Blob& element);
+
+  void
+  onReceivedData(uint64_t faceId, const Blob& element);
+
+  /**
+   * Decode the ForwardingEntry in the selfreg interest name and add its prefix to the FIB for the face.
+   * @param faceId The face ID of the sender.
+   * @param interest The /ndnx/<ndndId>/selfreg/<encoded Data> interest.
+   */
+  void
+  registerPrefix(uint64_t faceId, const Interest& interest);
+
+  /**
+   * Queue the element for the transport of the face.  Do nothing if the face was removed.
+   */
+  void
+  sendToFace(uint64_t faceId, const Blob& element);
+
+  /**
+   * Remove the PIT entry when its interest lifetime passes.
+   */
+  void
+  expirePitEntry(const ptr_lib::shared_ptr<PitEntry>& pitEntry);
+
+  Blob ndndId_;
+  Name ndndIdName_;
+  Blob ndndIdDataEncoding_;
+  Name selfregPrefix_; /**< The prefix /ndnx/<ndndId>/selfreg of the interest from Face::registerPrefix. */
+  std::map<uint64_t, LoopbackTransport*> faces_;
+  uint64_t lastFaceId_;
+  ptr_lib::shared_ptr<NameTrie<ptr_lib::shared_ptr<FibEntry> > > fib_;
+  ptr_lib::shared_ptr<NameTrie<ptr_lib::shared_ptr<PitEntry> > > pit_;
+  ptr_lib::shared_ptr<TimerQueue> timerQueue_;
+};
+
+}
+
+#endif
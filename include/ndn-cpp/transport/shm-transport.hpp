@@ -0,0 +1,146 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_SHMTRANSPORT_HPP
+#define NDN_SHMTRANSPORT_HPP
+
+#include <string>
+#include <deque>
+#include "../common.hpp"
+#include "transport.hpp"
+
+struct ndn_ShmTransport;
+struct ndn_BinaryXmlElementReader;
+
+namespace ndn {
+
+/**
+ * A ShmTransport exchanges elements with another process on the same host through a pair of rings in shared memory,
+ * one for each direction, instead of through the kernel.  Sending copies the element into the ring, and processEvents
+ * passes each received element to the ElementListener in place in the shared memory.  Each process waits on an
+ * eventfd which the other process signals when it sends to an empty ring or frees space in a full ring.  One process
+ * connects with ConnectionInfo::getIsListener() true and the other connects to it with the same file path.  This
+ * requires eventfd (Linux).
+ */
+class ShmTransport : public Transport {
+public:
+  /**
+   * A ShmTransport::ConnectionInfo extends Transport::ConnectionInfo to hold the path of the Unix socket file which
+   * the two processes use to set up the shared memory.
+   */
+  class ConnectionInfo : public Transport::ConnectionInfo {
+  public:
+    /**
+     * Create a ConnectionInfo with the given socket file path.
+     * @param filePath The path of the Unix socket file.
+     * @param isListener If true, connect listens on filePath and blocks until the other process connects, then
+     * creates the shared memory.  If false or omitted, connect connects to the listening process.
+     * @param ringCapacity The number of bytes in each ring, used by the listener.  The largest element is half of this.
+     * If omitted, use 4 MB.
+     */
+    ConnectionInfo(const char *filePath, bool isListener = false, size_t ringCapacity = 4194304)
+    : filePath_(filePath), isListener_(isListener), ringCapacity_(ringCapacity)
+    {
+    }
+
+    /**
+     * Get the socket file path given to the constructor.
+     * @return A string reference for the file path.
+     */
+    const std::string&
+    getFilePath() const { return filePath_; }
+
+    /**
+     * Get the isListener flag given to the constructor.
+     * @return true if connect listens for the other process.
+     */
+    bool
+    getIsListener() const { return isListener_; }
+
+    /**
+     * Get the ring capacity given to the constructor.
+     * @return The number of bytes in each ring.
+     */
+    size_t
+    getRingCapacity() const { return ringCapacity_; }
+
+    virtual
+    ~ConnectionInfo();
+
+  private:
+    std::string filePath_;
+    bool isListener_;
+    size_t ringCapacity_;
+  };
+
+  ShmTransport();
+
+  /**
+   * Connect according to the info in ConnectionInfo, and processEvents() will use elementListener.  If
+   * connectionInfo.getIsListener() is true, this blocks until the other process connects.
+   * @param connectionInfo A reference to a ShmTransport::ConnectionInfo.
+   * @param elementListener Not a shared_ptr because we assume that it will remain valid during the life of this object.
+   */
+  virtual void connect(const Transport::ConnectionInfo& connectionInfo, ElementListener& elementListener);
+
+  /**
+   * Copy the data into the send ring without blocking.  If the ring is full, copy the data to the send queue for
+   * processEvents to send when the other process frees space.
+   * @param data A pointer to the buffer of data to send.
+   * @param dataLength The number of bytes in data.
+   */
+  virtual void send(const uint8_t *data, size_t dataLength);
+
+  /**
+   * Copy the data into the send ring the same as send(const uint8_t *, size_t), except if the ring is full then queue
+   * the Blob itself instead of a copy.
+   * @param data The data to send.
+   */
+  virtual void send(const Blob& data);
+
+  /**
+   * Process any data to receive.  For each element received, call elementListener.onReceivedElement with a pointer
+   * into the shared memory.  This reads until the receive ring is empty, and will return immediately if there is no
+   * data to receive.  This first sends the data in the send queue if there is space.  If the other process wrote a
+   * record which is outside the ring, this closes the transport and throws an exception.
+   * You should normally not call this directly since it is called by Face.processEvents.
+   * @throw This may throw an exception for reading data or in the callback for processing the data.  If you
+   * call this from an main event loop, you may want to catch and log/disregard all exceptions.
+   */
+  virtual void processEvents();
+
+  virtual bool getIsConnected();
+
+  /**
+   * Get the eventfd which becomes readable when the other process sends data or frees space in the send ring.
+   * @return The eventfd, or -1 if not connected.
+   */
+  virtual int getFileDescriptor();
+
+  /**
+   * Unmap the shared memory.
+   */
+  virtual void close();
+
+  ~ShmTransport();
+
+private:
+  /**
+   * Copy as much of the send queue into the send ring as fits, and remove it from the queue.
+   */
+  void
+  flushSendQueue();
+
+  ptr_lib::shared_ptr<struct ndn_ShmTransport> transport_;
+  bool isConnected_;
+  ptr_lib::shared_ptr<struct ndn_BinaryXmlElementReader> elementReader_;
+  std::deque<Blob> sendQueue_; /**< The data which didn't fit in the send ring. */
+};
+
+}
+
+#endif
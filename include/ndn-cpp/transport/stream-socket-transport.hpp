@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_STREAMSOCKETTRANSPORT_HPP
+#define NDN_STREAMSOCKETTRANSPORT_HPP
+
+#include <deque>
+#include "../common.hpp"
+#include "transport.hpp"
+
+struct ndn_SocketTransport;
+struct ndn_BinaryXmlElementReader;
+
+namespace ndn {
+
+/**
+ * A StreamSocketTransport is the base class of TcpTransport and UnixTransport.  It sends and receives elements on a
+ * connected stream socket without blocking, and a derived class only has to connect the socket.
+ */
+class StreamSocketTransport : public Transport {
+public:
+  /**
+   * Send data without blocking.  If the socket doesn't accept all the data now, copy the rest to the send queue for
+   * processEvents to send when the socket is writable.
+   * @param data A pointer to the buffer of data to send.
+   * @param dataLength The number of bytes in data.
+   */
+  virtual void send(const uint8_t *data, size_t dataLength);
+
+  /**
+   * Add the data to the send queue, and send the queue now unless getSendCoalescingMilliseconds() is greater than 0.
+   * This does not block.  The queue keeps a pointer to the Blob's buffer instead of copying it, and any data which the
+   * socket doesn't accept now is sent by processEvents when the socket is writable.
+   * @param data The data to send.
+   */
+  virtual void send(const Blob& data);
+
+  /**
+   * Process any data to receive.  For each element received, call elementListener.onReceivedElement.
+   * This reads until there is no more data ready, and will return immediately if there is no data to receive.  This
+   * first sends the data in the send queue if getFlushTimeMilliseconds() has passed.  If the peer closed the
+   * connection, this closes the socket so that getIsConnected() returns false and getFileDescriptor() returns -1.
+   * You should normally not call this directly since it is called by Face.processEvents.
+   * @throw This may throw an exception for reading data or in the callback for processing the data.  If you
+   * call this from an main event loop, you may want to catch and log/disregard all exceptions.
+   */
+  virtual void processEvents();
+
+  virtual bool getIsConnected();
+
+  /**
+   * Get the socket descriptor, which becomes readable when processEvents has data to receive.
+   * @return The socket descriptor, or -1 if not connected.
+   */
+  virtual int getFileDescriptor();
+
+  /**
+   * Get the time when processEvents should send the data in the send queue.  This is the time that the oldest queued
+   * data was queued plus getSendCoalescingMilliseconds().
+   * @return The time in milliseconds since 1970, or -1 if the send queue is empty.
+   */
+  virtual MillisecondsSince1970 getFlushTimeMilliseconds();
+
+  /**
+   * Get the time that send(const Blob&) holds data in the send queue before sending it.
+   * @return The coalescing delay in milliseconds.
+   */
+  Milliseconds
+  getSendCoalescingMilliseconds() const { return sendCoalescingMilliseconds_; }
+
+  /**
+   * Set the time that send(const Blob&) holds data in the send queue before sending it, so that the data from a burst
+   * of calls to send goes to the socket in one system call.  The data is sent early if the queue reaches 64 KB.
+   * @param sendCoalescingMilliseconds The coalescing delay in milliseconds.  If this is 0 (the default), send each
+   * Blob immediately.
+   */
+  void
+  setSendCoalescingMilliseconds(Milliseconds sendCoalescingMilliseconds)
+  {
+    sendCoalescingMilliseconds_ = sendCoalescingMilliseconds;
+  }
+
+  /**
+   * Close the connection.
+   */
+  virtual void close();
+
+  ~StreamSocketTransport();
+
+protected:
+  StreamSocketTransport();
+
+  /**
+   * A derived class calls this from connect after connecting socketTransport_, to set up the element reader to call
+   * elementListener and to size the receive buffer.
+   * @param elementListener The ElementListener given to connect.
+   */
+  void
+  onConnected(ElementListener& elementListener);
+
+  /**
+   * Clear the send queue.  A derived class calls this from connect before connecting socketTransport_.
+   */
+  void
+  clearSendQueue();
+
+  ptr_lib::shared_ptr<struct ndn_SocketTransport> socketTransport_;
+
+private:
+  /**
+   * Send as much of the send queue as the socket accepts without blocking, and remove the sent data from the queue.
+   * If there is an error, clear the queue and throw an exception.
+   */
+  void
+  flushSendQueue();
+
+  bool isConnected_;
+  // TODO: This belongs in the socket listener.
+  ptr_lib::shared_ptr<struct ndn_BinaryXmlElementReader> elementReader_;
+  // The buffer for recv, sized from the socket's SO_RCVBUF in connect and reused by each call to processEvents.
+  std::vector<uint8_t> receiveBuffer_;
+  std::deque<Blob> sendQueue_;                      /**< The data which the socket has not accepted yet. */
+  size_t sendQueueOffset_;                          /**< The number of bytes of sendQueue_.front() already sent. */
+  size_t sendQueueLength_;                          /**< The number of bytes in sendQueue_ not yet sent. */
+  MillisecondsSince1970 sendQueueTimeMilliseconds_; /**< When the oldest data in sendQueue_ was queued. */
+  Milliseconds sendCoalescingMilliseconds_;
+};
+
+}
+
+#endif
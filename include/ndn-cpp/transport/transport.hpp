@@ -9,6 +9,7 @@
 #define NDN_TRANSPORT_HPP
 
 #include <vector>
+#include "../util/blob.hpp"
 
 namespace ndn {
 
@@ -46,6 +47,14 @@ public:
     send(&data[0], data.size());
   }
   
+  /**
+   * Send the encoded data.  A derived class may queue the data and send it later from processEvents, so this takes a
+   * Blob to share its buffer instead of copying it.  This base class implementation calls send(data.buf(), data.size()).
+   * @param data The data to send.
+   */
+  virtual void
+  send(const Blob& data);
+  
   /**
    * Process any data to receive.  For each element received, call elementListener.onReceivedElement.
    * This is non-blocking and will return immediately if there is no data to receive.
@@ -58,6 +67,23 @@ public:
 
   virtual bool 
   getIsConnected();
+
+  /**
+   * Get the file descriptor which becomes readable when processEvents has data to receive, so that the caller can
+   * block until then instead of polling.  This base class implementation returns -1, but your derived class can override.
+   * @return The file descriptor, or -1 if there is none (for example if not connected).
+   */
+  virtual int
+  getFileDescriptor();
+
+  /**
+   * Get the time when processEvents should send the data which send has queued.  A caller which blocks waiting for
+   * getFileDescriptor should not wait past this time, and once it has passed should also wake when the file
+   * descriptor becomes writable.  This base class implementation returns -1, but your derived class can override.
+   * @return The time in milliseconds since 1970, or -1 if no data is queued.
+   */
+  virtual MillisecondsSince1970
+  getFlushTimeMilliseconds();
   
   /**
    * Close the connection.  This base class implementation does nothing, but your derived class can override.
@@ -9,6 +9,7 @@
 #define NDN_UDPTRANSPORT_HPP
 
 #include <string>
+#include <deque>
 #include "../common.hpp"
 #include "transport.hpp"
 
@@ -67,16 +68,30 @@ public:
   connect(const Transport::ConnectionInfo& connectionInfo, ElementListener& elementListener);
   
   /**
-   * Set data to the host
+   * Send the data to the host as one datagram without blocking.  If this is called from a callback in processEvents,
+   * queue a copy of the datagram so that processEvents sends the datagrams from all the callbacks together.  Also
+   * queue a copy if the socket doesn't accept the datagram now, so that processEvents sends it when the socket is
+   * writable.
    * @param data A pointer to the buffer of data to send.
    * @param dataLength The number of bytes in data.
    */
   virtual void 
   send(const uint8_t *data, size_t dataLength);
 
+  /**
+   * Send the data to the host as one datagram the same as send(const uint8_t *, size_t), except queue the Blob
+   * itself instead of a copy.
+   * @param data The data to send.
+   */
+  virtual void
+  send(const Blob& data);
+
   /**
    * Process any data to receive.  For each element received, call elementListener.onReceivedElement.
-   * This is non-blocking and will return immediately if there is no data to receive.
+   * This reads until there is no more data ready, and will return immediately if there is no data to receive.
+   * This receives a batch of datagrams in one system call into a pool of buffers which is reused by each call.
+   * Each datagram is passed to the element reader in place.  A datagram longer than 8800 bytes is discarded.  At the
+   * end, send the queued datagrams in one system call.
    * You should normally not call this directly since it is called by Face.processEvents.
    * @throw This may throw an exception for reading data or in the callback for processing the data.  If you
    * call this from an main event loop, you may want to catch and log/disregard all exceptions.
@@ -87,6 +102,20 @@ public:
   virtual bool 
   getIsConnected();
 
+  /**
+   * Get the socket descriptor, which becomes readable when processEvents has data to receive.
+   * @return The socket descriptor, or -1 if not connected.
+   */
+  virtual int
+  getFileDescriptor();
+
+  /**
+   * Get the time when processEvents should send the queued datagrams, which is when the oldest was queued.
+   * @return The time in milliseconds since 1970, or -1 if no datagram is queued.
+   */
+  virtual MillisecondsSince1970
+  getFlushTimeMilliseconds();
+
   /**
    * Close the connection to the host.
    */
@@ -96,10 +125,45 @@ public:
   ~UdpTransport();
   
 private:
+  /**
+   * If there are no queued datagrams and processEvents is not calling callbacks, try to send the datagram now.
+   * @param data A pointer to the buffer of data to send.
+   * @param dataLength The number of bytes in data.
+   * @return true if the datagram was sent, or false if the caller should queue it.
+   */
+  bool
+  trySendNow(const uint8_t *data, size_t dataLength);
+
+  /**
+   * Add the datagram to the send queue.
+   * @param data The datagram.
+   */
+  void
+  queueDatagram(const Blob& data);
+
+  /**
+   * Send as many queued datagrams as the socket accepts without blocking, and remove them from the queue.
+   * If there is an error, clear the queue and throw an exception.
+   */
+  void
+  flushSendQueue();
+
+  /**
+   * Receive datagrams until no more are ready and pass them to the element reader.
+   */
+  void
+  receiveDatagrams();
+
+
   ptr_lib::shared_ptr<struct ndn_UdpTransport> transport_;
   bool isConnected_;
   // TODO: This belongs in the socket listener.
   ptr_lib::shared_ptr<struct ndn_BinaryXmlElementReader> elementReader_;
+  // The pool of receive buffers for one recvmmsg, allocated in connect and reused by each call to processEvents.
+  std::vector<uint8_t> receiveBuffer_;
+  std::deque<Blob> sendQueue_;                      /**< The datagrams which are not sent yet. */
+  MillisecondsSince1970 sendQueueTimeMilliseconds_; /**< When the oldest datagram in sendQueue_ was queued. */
+  bool isProcessingEvents_;                         /**< True while processEvents is calling callbacks. */
 };
 
 }
@@ -0,0 +1,63 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_UNIXTRANSPORT_HPP
+#define NDN_UNIXTRANSPORT_HPP
+
+#include <string>
+#include "stream-socket-transport.hpp"
+
+namespace ndn {
+  
+/**
+ * A UnixTransport connects to a forwarder on the same host with a Unix domain stream socket, which avoids the TCP
+ * loopback stack.  Otherwise it behaves the same as TcpTransport.
+ */
+class UnixTransport : public StreamSocketTransport {
+public:
+  /**
+   * A UnixTransport::ConnectionInfo extends Transport::ConnectionInfo to hold the socket file path for the Unix
+   * socket connection.
+   */
+  class ConnectionInfo : public Transport::ConnectionInfo {
+  public:
+    /**
+     * Create a ConnectionInfo with the given socket file path.
+     * @param filePath The path of the Unix socket file.  If omitted, use "/tmp/.ndnd.sock" where ndnd listens.
+     */
+    ConnectionInfo(const char *filePath = "/tmp/.ndnd.sock")
+    : filePath_(filePath)
+    {
+    }
+
+    /**
+     * Get the socket file path given to the constructor.
+     * @return A string reference for the file path.
+     */
+    const std::string& 
+    getFilePath() const { return filePath_; }
+    
+    virtual 
+    ~ConnectionInfo();
+    
+  private:
+    std::string filePath_;
+  };
+
+  UnixTransport();
+  
+  /**
+   * Connect according to the info in ConnectionInfo, and processEvents() will use elementListener.
+   * @param connectionInfo A reference to a UnixTransport::ConnectionInfo.
+   * @param elementListener Not a shared_ptr because we assume that it will remain valid during the life of this object.
+   */
+  virtual void connect(const Transport::ConnectionInfo& connectionInfo, ElementListener& elementListener);
+};
+
+}
+
+#endif
@@ -23,6 +23,10 @@ namespace ndn {
  * (Note that we could have made Blob derive directly from vector<uint8_t> and then explicitly use
  * a pointer to it like Blob, but this does not enforce immutability because we can't declare
  * Blob as derived from const vector<uint8_t>.)
+ * A Blob can also be a slice of the byte array of another Blob, sharing the array without copying.  For example,
+ * wireDecode(const Blob&) makes the name components and content of the decoded object slices of the input.  The
+ * shared_ptr of a slice still points to the entire array, so Blob hides operator*, operator-> and get() of the
+ * shared_ptr, which would return the entire array.  Use buf() and size() to access the bytes of a Blob.
  */
 class Blob : public ptr_lib::shared_ptr<const std::vector<uint8_t> > {
 public:
@@ -30,6 +34,7 @@ public:
    * Create a new Blob with a null pointer.
    */
   Blob()
+  : sliceBuf_(0), sliceSize_(0)
   {  
   }
   
@@ -39,7 +44,8 @@ public:
    * @param valueLength The length of value.
    */
   Blob(const uint8_t* value, size_t valueLength)
-  : ptr_lib::shared_ptr<const std::vector<uint8_t> >(new std::vector<uint8_t>(value, value + valueLength))
+  : ptr_lib::shared_ptr<const std::vector<uint8_t> >(new std::vector<uint8_t>(value, value + valueLength)),
+    sliceBuf_(0), sliceSize_(0)
   {
   }
   
@@ -50,7 +56,7 @@ public:
    * @param value A reference to a vector which is copied.
    */
   Blob(const std::vector<uint8_t> &value)
-  : ptr_lib::shared_ptr<const std::vector<uint8_t> >(new std::vector<uint8_t>(value))
+  : ptr_lib::shared_ptr<const std::vector<uint8_t> >(new std::vector<uint8_t>(value)), sliceBuf_(0), sliceSize_(0)
   {
   }
   
@@ -60,44 +66,94 @@ public:
    */
   Blob(const struct ndn_Blob& blobStruct);
   
+  /**
+   * Create a new Blob for the array in the given Blob struct.  If the array is inside the byte array of buffer, this 
+   * is a slice of buffer which shares its byte array without copying, otherwise this is an immutable copy.
+   * @param blobStruct The C ndn_Blob struct to receive the pointer.
+   * @param buffer The Blob whose byte array may contain the array in blobStruct, for example the input of a decoder.
+   * If buffer is null, this copies the array.
+   */
+  Blob(const struct ndn_Blob& blobStruct, const Blob& buffer);
+  
+  /**
+   * Create a new Blob which is a slice of the byte array of buffer, sharing the array without copying.
+   * @param buffer The Blob with the byte array.  This takes another reference to the array.
+   * @param offset The offset in buffer.buf() of the beginning of the slice.
+   * @param length The number of bytes in the slice.
+   * @throw runtime_error if offset + length is greater than buffer.size().
+   */
+  Blob(const Blob& buffer, size_t offset, size_t length);
+  
   /**
    * Create a new Blob to point to an existing byte array.  IMPORTANT: After calling this constructor,
    * if you keep a pointer to the array then you must treat the array as immutable and promise not to change it.
    * @param value A pointer to a vector with the byte array.  This takes another reference and does not copy the bytes.
    */
   Blob(const ptr_lib::shared_ptr<std::vector<uint8_t> > &value)
-  : ptr_lib::shared_ptr<const std::vector<uint8_t> >((const ptr_lib::shared_ptr<const std::vector<uint8_t> > &)value)
+  : ptr_lib::shared_ptr<const std::vector<uint8_t> >((const ptr_lib::shared_ptr<const std::vector<uint8_t> > &)value),
+    sliceBuf_(0), sliceSize_(0)
   {
   }
   Blob(const ptr_lib::shared_ptr<const std::vector<uint8_t> > &value)
-  : ptr_lib::shared_ptr<const std::vector<uint8_t> >(value)
+  : ptr_lib::shared_ptr<const std::vector<uint8_t> >(value), sliceBuf_(0), sliceSize_(0)
   {
   }
   
   /**
-   * Return the length of the immutable byte array.
+   * Return the length of the immutable byte array, or of the slice if this is a slice.
    */
   size_t 
   size() const
   {
-    if (*this)
-      return (*this)->size();
+    if (sliceBuf_)
+      return sliceSize_;
+    else if (*this)
+      return ptr_lib::shared_ptr<const std::vector<uint8_t> >::get()->size();
     else
       return 0;
   }
 
   /**
-   * Return a const pointer to the first byte of the immutable byte array, or 0 if the pointer is null.
+   * Return a const pointer to the first byte of the immutable byte array, or of the slice if this is a slice, or 0 if
+   * the pointer is null.
    */
   const uint8_t* 
   buf() const
   {
-    if (*this)
-      return &(*this)->front();
+    if (sliceBuf_)
+      return sliceBuf_;
+    else if (*this)
+      return &ptr_lib::shared_ptr<const std::vector<uint8_t> >::get()->front();
     else
       return 0;
   }
   
+  /**
+   * Check if this is a slice which shares the byte array of a larger Blob.
+   * @return True if this is a slice, false if this Blob has its own byte array.
+   */
+  bool
+  isSlice() const { return sliceBuf_ != 0; }
+
+  /**
+   * Check if the bytes of this Blob are the same as the bytes of other, comparing the slices if they are slices.
+   * @param other The other Blob to compare with.
+   * @return True if the bytes are the same, including if both are null or empty.
+   */
+  bool
+  equals(const Blob& other) const;
+  
+  /**
+   * Set the pointer to null, also clearing the slice.
+   */
+  void
+  reset()
+  {
+    ptr_lib::shared_ptr<const std::vector<uint8_t> >::reset();
+    sliceBuf_ = 0;
+    sliceSize_ = 0;
+  }
+  
   /**
    * Set the blobStruct to point to this Blob's byte array, without copying any memory.
    * WARNING: The resulting pointer in blobStruct is invalid after a further use of this object which could reallocate memory.
@@ -105,6 +161,28 @@ public:
    */
   void 
   get(struct ndn_Blob& blobStruct) const;
+  
+  /**
+   * Return the hex representation of the bytes in the byte array, or of the slice if this is a slice.
+   * @return The hex string, or "" if the pointer is null.
+   */
+  std::string
+  toHex() const { return ndn::toHex(buf(), size()); }
+  
+private:
+  // Hide the accessors of the shared_ptr since they return the entire array of a slice.  Use buf() and size().
+  const std::vector<uint8_t>&
+  operator*() const;
+
+  const std::vector<uint8_t>*
+  operator->() const;
+
+  const std::vector<uint8_t>*
+  get() const;
+
+  // A slice of a non-empty array always has a non-null pointer, even if the slice is empty.
+  const uint8_t *sliceBuf_; /**< The first byte of the slice, or 0 if this is not a slice. */
+  size_t sliceSize_;        /**< The number of bytes in the slice. */
 };
 
 }
@@ -0,0 +1,43 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_EXECUTOR_HPP
+#define NDN_EXECUTOR_HPP
+
+#include "../common.hpp"
+
+namespace ndn {
+
+/**
+ * An Executor is a base class for objects which call tasks, for example on other threads.  Face::setCallbackExecutor
+ * uses an Executor to call the application callbacks outside of processEvents.
+ */
+class Executor {
+public:
+  typedef func_lib::function<void()> Task;
+
+  /**
+   * Call the task, now or later, on any thread.
+   * @param task The function object to call.  This copies the function object.
+   * @param orderKey If this is not 0, call task after every earlier task with the same orderKey has returned.  If
+   * this is 0, task can be called in any order with the other tasks.
+   */
+  virtual void
+  execute(const Task& task, uint64_t orderKey) = 0;
+
+  /**
+   * Get the number of tasks which were given to execute but not yet started.
+   */
+  virtual size_t
+  getQueueDepth() = 0;
+
+  virtual ~Executor();
+};
+
+}
+
+#endif
@@ -0,0 +1,259 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_SEGMENT_FETCHER_HPP
+#define NDN_SEGMENT_FETCHER_HPP
+
+#include <deque>
+#include <map>
+#include <vector>
+#include "../face.hpp"
+
+namespace ndn {
+
+/**
+ * A SegmentFetcher fetches the segments of an object whose data packets are named <prefix>/<segment>, where the
+ * segment component is Name::Component::fromNumberWithMarker(segment, 0x00), and reassembles the content.  It learns
+ * the last segment from the finalBlockID in the MetaInfo of the data packets, and keeps a window of pending segment
+ * interests which adapts like TCP: it grows by one segment per data packet up to the slow start threshold and by one
+ * segment per window after that (additive increase), and halves when an interest times out (multiplicative
+ * decrease), at most once per window.  A timed out segment is expressed again.  Each segment's content is copied
+ * into its place in one buffer which is allocated once the size is known, and the buffer is given to the completion
+ * callback without another copy.
+ * The callbacks are called from Face::processEvents.  The SegmentFetcher must remain valid until it calls onComplete
+ * or onError, or until it is destroyed, which removes its pending interests.
+ */
+class SegmentFetcher {
+public:
+  enum ErrorCode {
+    INTEREST_TIMEOUT = 1,    /**< A segment interest timed out more than the maximum number of retries. */
+    DATA_HAS_NO_SEGMENT = 2, /**< A data packet name doesn't have a segment component after the prefix. */
+    CONTENT_TOO_LARGE = 3    /**< The finalBlockID or the received segments exceed the maximum content size. */
+  };
+
+  /**
+   * An OnComplete function object is called with the reassembled content.
+   */
+  typedef func_lib::function<void(const Blob& content)> OnComplete;
+
+  /**
+   * An OnError function object is called with the ErrorCode and a message if the fetch fails.
+   */
+  typedef func_lib::function<void(ErrorCode errorCode, const std::string& message)> OnError;
+
+  /**
+   * Create a new SegmentFetcher.  Call start() to begin fetching.
+   * @param face The Face used to express the interests.
+   * @param baseInterest An interest whose name is the prefix of the segment names and whose selectors and lifetime
+   * are used for the segment interests.  This copies the Interest.  If the lifetime is not set, use 4 seconds.
+   * @param onComplete A function object to call with the content once all segments are received.  This copies the
+   * function object.
+   * @param onError A function object to call if the fetch fails.  This copies the function object.
+   */
+  SegmentFetcher(Face& face, const Interest& baseInterest, const OnComplete& onComplete, const OnError& onError);
+
+  /**
+   * Set the window size for the first segments.  The default is 1.  Call this before start().
+   * @param initialWindowSize The number of pending interests to start with.
+   */
+  void
+  setInitialWindowSize(double initialWindowSize) { windowSize_ = initialWindowSize; }
+
+  /**
+   * Set the maximum window size.  The default is 256.
+   * @param maxWindowSize The maximum number of pending segment interests.
+   */
+  void
+  setMaxWindowSize(double maxWindowSize) { maxWindowSize_ = maxWindowSize; }
+
+  /**
+   * Set the window size where slow start ends and additive increase begins.  The default is the maximum window size.
+   * A timeout sets this to half the window.
+   * @param slowStartThreshold The slow start threshold.
+   */
+  void
+  setSlowStartThreshold(double slowStartThreshold) { slowStartThreshold_ = slowStartThreshold; }
+
+  /**
+   * Set the number of times to express a segment interest again after it times out before calling onError.  The
+   * default is 3.
+   * @param maxRetries The maximum number of retries for each segment.
+   */
+  void
+  setMaxRetries(int maxRetries) { maxRetries_ = maxRetries; }
+
+  /**
+   * Set the maximum number of bytes of the content.  If the buffer for the segments up to the finalBlockID or the
+   * received segments would exceed this, call onError with CONTENT_TOO_LARGE instead of allocating the buffer.  The
+   * default is 1 GB.
+   * @param maxContentSize The maximum content size in bytes.
+   */
+  void
+  setMaxContentSize(size_t maxContentSize) { maxContentSize_ = maxContentSize; }
+
+  /**
+   * Express the first segment interest.
+   */
+  void
+  start();
+
+  /**
+   * Get the current window size.
+   */
+  double
+  getWindowSize() const { return windowSize_; }
+
+  /**
+   * Get the number of segment interests which were expressed again after a timeout.
+   */
+  size_t
+  getRetransmissionCount() const { return nRetransmissions_; }
+
+  /**
+   * Remove the pending segment interests.
+   */
+  ~SegmentFetcher();
+
+private:
+  class PendingSegment {
+  public:
+    PendingSegment()
+    : pendingInterestId_(0), nRetries_(0)
+    {
+    }
+
+    uint64_t pendingInterestId_;
+    int nRetries_;
+  };
+
+  // Don't allow copying since the pending interests call back this object.
+  SegmentFetcher(const SegmentFetcher& other);
+  SegmentFetcher& operator = (const SegmentFetcher& other);
+
+  /**
+   * Express interests for the segments to retransmit and then for the next segments until the window is full.
+   */
+  void
+  fillWindow();
+
+  /**
+   * Express the interest for the segment and add it to pendingSegments_.
+   * @param segment The segment number.
+   */
+  void
+  expressSegment(uint64_t segment);
+
+  void
+  onData(const ptr_lib::shared_ptr<const Interest>& interest, const ptr_lib::shared_ptr<Data>& data);
+
+  void
+  onTimeout(const ptr_lib::shared_ptr<const Interest>& interest);
+
+  /**
+   * Check if the buffer for the segments up to finalSegment_ or the received bytes plus newSize would exceed
+   * maxContentSize_, without overflowing.
+   * @param newSize The number of bytes of the segment being received.
+   * @return True if the content is too large.
+   */
+  bool
+  isContentTooLarge(size_t newSize);
+
+  /**
+   * Keep the segment content, copying it into its place in content_ if the segment size allows.
+   * @param segment The segment number.
+   * @param content The segment content.
+   */
+  void
+  storeSegment(uint64_t segment, const Blob& content);
+
+  /**
+   * Copy the segment content into its place in content_ if every segment before the last has segmentSize_ and the
+   * last is not larger.
+   * @param segment The segment number.
+   * @param content The segment content.
+   * @return true if the content was copied, false if it can't be placed yet.
+   */
+  bool
+  placeSegment(uint64_t segment, const Blob& content);
+
+  /**
+   * Try again to place the segments in segments_, after learning the segment size or the final segment.
+   */
+  void
+  placeStoredSegments();
+
+  /**
+   * Make content_ large enough for segment, allocating it at the final size once the final segment is known.
+   * @param segment The segment number.
+   */
+  void
+  reserveContent(uint64_t segment);
+
+  /**
+   * Give up on one buffer because the segments don't have the same size.  Move the segments already in content_ to
+   * segments_ as slices of it, so that the content is concatenated from segments_ at the end.
+   */
+  void
+  moveContentToSegments();
+
+  /**
+   * Remove the pending interests for segments after finalSegment_.
+   */
+  void
+  removeSegmentsAfterFinal();
+
+  /**
+   * Call onComplete_ with the content.
+   */
+  void
+  complete();
+
+  /**
+   * Remove every pending interest and call onError_.
+   */
+  void
+  fail(ErrorCode errorCode, const std::string& message);
+
+  /**
+   * Get the segment number of name from the component after the prefix.
+   * @param name The interest or data name.
+   * @param segment Set this to the segment number.
+   * @return true for success, false if the name has no segment component.
+   */
+  bool
+  getSegment(const Name& name, uint64_t& segment);
+
+  Face& face_;
+  Interest baseInterest_;
+  OnComplete onComplete_;
+  OnError onError_;
+  double windowSize_;
+  double maxWindowSize_;
+  double slowStartThreshold_; /**< The slow start threshold, or -1 to use maxWindowSize_. */
+  int maxRetries_;
+  size_t maxContentSize_;
+  bool isFinished_;
+  uint64_t nextSegment_;      /**< The next segment which has not been expressed. */
+  int64_t finalSegment_;      /**< The segment number from the finalBlockID, or -1 if not known. */
+  uint64_t recoverySegment_;  /**< Don't decrease the window again for a timeout of a segment before this. */
+  std::map<uint64_t, PendingSegment> pendingSegments_; /**< Including the segments in retransmitSegments_. */
+  std::deque<uint64_t> retransmitSegments_; /**< The timed out segments to express again, which have priority. */
+  std::vector<bool> isReceived_;
+  uint64_t nReceived_;
+  size_t nReceivedBytes_;
+  size_t nRetransmissions_;
+  bool hasSegmentSize_;
+  size_t segmentSize_;        /**< The content size of the first segment before the last, which all should have. */
+  size_t finalSegmentSize_;   /**< The content size of the final segment, once placed in content_. */
+  bool isOneBuffer_;          /**< true until a segment doesn't fit in content_. */
+  ptr_lib::shared_ptr<std::vector<uint8_t> > content_; /**< The segments at offset segment * segmentSize_. */
+  std::map<uint64_t, Blob> segments_; /**< The segments which are not (yet) placed in content_. */
+};
+
+}
+
+#endif
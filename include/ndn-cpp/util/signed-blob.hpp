@@ -73,6 +73,17 @@ public:
   : Blob(value), signedPortionBeginOffset_(signedPortionBeginOffset), signedPortionEndOffset_(signedPortionEndOffset)
   {
   }
+  
+  /**
+   * Create a new SignedBlob to share the byte array of value, which may be a slice, without copying.
+   * @param value The Blob with the byte array.  This takes another reference to the array.
+   * @param signedPortionBeginOffset The offset in value.buf() of the beginning of the signed portion.
+   * @param signedPortionEndOffset The offset in value.buf() of the end of the signed portion.
+   */
+  SignedBlob(const Blob& value, size_t signedPortionBeginOffset, size_t signedPortionEndOffset)
+  : Blob(value), signedPortionBeginOffset_(signedPortionBeginOffset), signedPortionEndOffset_(signedPortionEndOffset)
+  {
+  }
     
   /**
    * Return the length of the signed portion of the immutable byte array, or 0 of the pointer to the array is null.
@@ -94,7 +105,7 @@ public:
   signedBuf() const
   {
     if (*this)
-      return &(*this)->front() + signedPortionBeginOffset_;
+      return buf() + signedPortionBeginOffset_;
     else
       return 0;
   }
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_THREAD_POOL_EXECUTOR_HPP
+#define NDN_THREAD_POOL_EXECUTOR_HPP
+
+#include <pthread.h>
+#include <vector>
+#include "executor.hpp"
+
+namespace ndn {
+
+/**
+ * A ThreadPoolExecutor calls tasks on a fixed number of worker threads.  Each worker has its own queue, so that
+ * workers don't contend on one lock.  A task without an orderKey is added to the queues in turn, and a worker whose
+ * queue is empty steals from the other queues.  A task with an orderKey is pinned to the worker chosen by the
+ * orderKey and is never stolen, so the tasks with the same orderKey are called one at a time in order.
+ */
+class ThreadPoolExecutor : public Executor {
+public:
+  /**
+   * Create a new ThreadPoolExecutor and start the worker threads.
+   * @param nThreads The number of worker threads.  If this is 0, use 1.
+   * @throw runtime_error if a thread can't be created.
+   */
+  ThreadPoolExecutor(size_t nThreads);
+
+  /**
+   * Add the task to a worker queue and wake a worker if needed.  Any thread can call this.  This ignores exceptions
+   * from the task since there is no caller to report them to.
+   * @param task The function object to call.  This copies the function object.
+   * @param orderKey If this is not 0, call task after every earlier task with the same orderKey has returned.  If
+   * this is 0, task can be called in any order with the other tasks.
+   */
+  virtual void
+  execute(const Task& task, uint64_t orderKey);
+
+  /**
+   * Get the number of tasks which were given to execute but not yet started.
+   */
+  virtual size_t
+  getQueueDepth();
+
+  /**
+   * Get the largest value of getQueueDepth() since this was created.
+   */
+  size_t
+  getMaxQueueDepth();
+
+  /**
+   * Get the number of worker threads.
+   */
+  size_t
+  size() const { return workers_.size(); }
+
+  /**
+   * Call the tasks which are still queued, then stop and join the worker threads.
+   */
+  virtual
+  ~ThreadPoolExecutor();
+
+private:
+  class Worker;
+
+  // Don't allow copying since the executor owns the threads.
+  ThreadPoolExecutor(const ThreadPoolExecutor& other);
+  ThreadPoolExecutor& operator = (const ThreadPoolExecutor& other);
+
+  /**
+   * Stop and join the worker threads after they call the queued tasks, and free the workers and the idle mutex.
+   * @param nStartedThreads The number of workers, from the first, whose thread was started.
+   */
+  void
+  stop(size_t nStartedThreads);
+
+  /**
+   * The thread function which runs the loop of a worker.
+   * @param worker The Worker.
+   */
+  static void*
+  run(void *worker);
+
+  /**
+   * Remove the next task for worker: from its pinned queue, else from its own queue, else steal from another worker.
+   * @param worker The worker which will call the task.
+   * @param task Set this to the removed task.
+   * @return true if a task was removed, false if there is no task for the worker.
+   */
+  bool
+  popTask(Worker& worker, Task& task);
+
+  std::vector<Worker*> workers_;
+  size_t nextWorker_;      /**< The worker for the next task without an orderKey, accessed atomically. */
+  size_t queueDepth_;      /**< Accessed atomically. */
+  size_t maxQueueDepth_;   /**< Accessed atomically. */
+  int nSleepingWorkers_;   /**< The number of workers waiting on idleCondition_, accessed atomically. */
+  bool isStopping_;        /**< Set by the destructor, guarded by idleMutex_. */
+  pthread_mutex_t idleMutex_;
+  pthread_cond_t idleCondition_;
+};
+
+}
+
+#endif
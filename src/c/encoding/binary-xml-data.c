@@ -6,6 +6,7 @@
  */
 
 #include "binary-xml-name.h"
+#include "binary-xml-structure-decoder.h"
 #include "binary-xml-publisher-public-key-digest.h"
 #include "binary-xml-data.h"
 #include "binary-xml-key.h"
@@ -196,6 +197,38 @@ ndn_Error ndn_encodeBinaryXmlData
   return NDN_ERROR_success;
 }
 
+size_t ndn_getBinaryXmlDataEncodingLength(struct ndn_Data *data)
+{
+  size_t length = ndn_BinaryXmlEncoder_getHeaderLength(ndn_BinaryXml_DTag_ContentObject) + 1;
+  
+  // The Signature.
+  length += ndn_BinaryXmlEncoder_getHeaderLength(ndn_BinaryXml_DTag_Signature) + 1 +
+            ndn_BinaryXmlEncoder_getOptionalBlobDTagElementLength(ndn_BinaryXml_DTag_Witness, &data->signature.witness) +
+            ndn_BinaryXmlEncoder_getBlobDTagElementLength(ndn_BinaryXml_DTag_SignatureBits, data->signature.signature.length);
+  
+  length += ndn_getBinaryXmlNameEncodingLength(&data->name);
+  
+  // The SignedInfo.
+  if ((int)data->metaInfo.type >= 0) {
+    length += ndn_BinaryXmlEncoder_getHeaderLength(ndn_BinaryXml_DTag_SignedInfo) + 1 +
+              ndn_getBinaryXmlPublisherPublicKeyDigestEncodingLength(&data->signature.publisherPublicKeyDigest) +
+              ndn_BinaryXmlEncoder_getOptionalTimeMillisecondsDTagElementLength
+                (ndn_BinaryXml_DTag_Timestamp, data->metaInfo.timestampMilliseconds);
+    if (data->metaInfo.type != ndn_ContentType_DATA)
+      // The type is encoded as 3 bytes.
+      length += ndn_BinaryXmlEncoder_getBlobDTagElementLength(ndn_BinaryXml_DTag_Type, 3);
+    length += ndn_BinaryXmlEncoder_getOptionalUnsignedDecimalIntDTagElementLength
+                (ndn_BinaryXml_DTag_FreshnessSeconds, data->metaInfo.freshnessSeconds) +
+              ndn_BinaryXmlEncoder_getOptionalBlobDTagElementLength
+                (ndn_BinaryXml_DTag_FinalBlockID, &data->metaInfo.finalBlockID.value) +
+              ndn_getBinaryXmlKeyLocatorEncodingLength(&data->signature.keyLocator);
+  }
+  
+  length += ndn_BinaryXmlEncoder_getBlobDTagElementLength(ndn_BinaryXml_DTag_Content, data->content.length);
+  
+  return length;
+}
+
 ndn_Error ndn_decodeBinaryXmlData
   (struct ndn_Data *data, size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset, struct ndn_BinaryXmlDecoder *decoder)
 {
@@ -238,3 +271,27 @@ ndn_Error ndn_decodeBinaryXmlData
   
   return NDN_ERROR_success;
 }
+
+ndn_Error ndn_decodeBinaryXmlDataName(struct ndn_Name *name, struct ndn_BinaryXmlDecoder *decoder)
+{
+  ndn_Error error;
+  if ((error = ndn_BinaryXmlDecoder_readElementStartDTag(decoder, ndn_BinaryXml_DTag_ContentObject)))
+    return error;
+
+  int gotExpectedTag;
+  if ((error = ndn_BinaryXmlDecoder_peekDTag(decoder, ndn_BinaryXml_DTag_Signature, &gotExpectedTag)))
+    return error;
+  if (gotExpectedTag) {
+    // Skip over the Signature element without decoding its fields.
+    struct ndn_BinaryXmlStructureDecoder structureDecoder;
+    ndn_BinaryXmlStructureDecoder_initialize(&structureDecoder);
+    if ((error = ndn_BinaryXmlStructureDecoder_findElementEnd
+         (&structureDecoder, decoder->input + decoder->offset, decoder->inputLength - decoder->offset)))
+      return error;
+    if (!structureDecoder.gotElementEnd)
+      return NDN_ERROR_read_past_the_end_of_the_input;
+    ndn_BinaryXmlDecoder_seek(decoder, decoder->offset + structureDecoder.offset);
+  }
+
+  return ndn_decodeBinaryXmlName(name, decoder);
+}
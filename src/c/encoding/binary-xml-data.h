@@ -29,6 +29,15 @@ extern "C" {
 ndn_Error ndn_encodeBinaryXmlData
   (struct ndn_Data *data, size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset, struct ndn_BinaryXmlEncoder *encoder);
 
+/**
+ * Return the number of bytes which ndn_encodeBinaryXmlData writes for the data packet, so that you can allocate the
+ * output once before encoding.  This only does arithmetic on the field lengths and does not check the fields, so
+ * ndn_encodeBinaryXmlData may still return an error.
+ * @param data A pointer to the ndn_Data struct.
+ * @return The encoding length.
+ */
+size_t ndn_getBinaryXmlDataEncodingLength(struct ndn_Data *data);
+
 /**
  * Decode the data packet as binary XML and set the fields in the data object.
  * @param data Pointer to the data object whose fields are updated.
@@ -42,6 +51,15 @@ ndn_Error ndn_encodeBinaryXmlData
 ndn_Error ndn_decodeBinaryXmlData
   (struct ndn_Data *data, size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset, struct ndn_BinaryXmlDecoder *decoder);
 
+/**
+ * Decode only the name of the binary XML data packet, skipping over the signature without decoding it.  This leaves
+ * the decoder offset after the Name element, so the rest of the data packet is not checked.
+ * @param name Pointer to the name object whose fields are updated.
+ * @param decoder Pointer to the ndn_BinaryXmlDecoder struct which has been initialized with the buffer to decode.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error ndn_decodeBinaryXmlDataName(struct ndn_Name *name, struct ndn_BinaryXmlDecoder *decoder);
+
 #ifdef __cplusplus
 }
 #endif
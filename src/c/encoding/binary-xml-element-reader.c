@@ -11,7 +11,8 @@ ndn_Error ndn_BinaryXmlElementReader_onReceivedData
 {
   // Process multiple objects in the data.
   while(1) {
-    // Scan the input to check if a whole binary XML object has been read.
+    // Scan the input to check if a whole binary XML object has been read.  The structure decoder keeps its state from
+    // the previous call, so this only scans the new data, starting at offset 0 of this input.
     ndn_BinaryXmlStructureDecoder_seek(&self->structureDecoder, 0);
     
     ndn_Error error;
@@ -23,7 +24,8 @@ ndn_Error ndn_BinaryXmlElementReader_onReceivedData
         // We have partial data from a previous call, so append this data and point to partialData.
         if ((error = ndn_DynamicUInt8Array_set(&self->partialData, data, self->structureDecoder.offset, self->partialDataLength)))
           return error;
-        self->partialDataLength += dataLength;
+        // Only the first offset bytes of data belong to this element.
+        self->partialDataLength += self->structureDecoder.offset;
                 
         (*self->elementListener->onReceivedElement)(self->elementListener, self->partialData.array, self->partialDataLength);
         // Assume we don't need to use partialData anymore until needed.
@@ -50,6 +52,14 @@ ndn_Error ndn_BinaryXmlElementReader_onReceivedData
         self->partialDataLength = 0;
       }
       
+      size_t neededLength = self->partialDataLength + dataLength;
+      if (self->structureDecoder.state == ndn_BinaryXmlStructureDecoder_READ_BYTES)
+        // We are in the middle of a blob (such as the content) whose length we know, so make room for the rest of it
+        // now instead of reallocating partialData as each chunk arrives.
+        neededLength += self->structureDecoder.nBytesToRead;
+      if ((error = ndn_DynamicUInt8Array_ensureLength(&self->partialData, neededLength)))
+        return error;
+      
       if ((error = ndn_DynamicUInt8Array_set(&self->partialData, data, dataLength, self->partialDataLength)))
         return error;
       self->partialDataLength += dataLength;
@@ -9,12 +9,6 @@
 #include "../util/ndn_memory.h"
 #include "binary-xml-encoder.h"
 
-enum {
-  ENCODING_LIMIT_1_BYTE = ((1 << ndn_BinaryXml_TT_VALUE_BITS) - 1),
-  ENCODING_LIMIT_2_BYTES = ((1 << (ndn_BinaryXml_TT_VALUE_BITS + ndn_BinaryXml_REGULAR_VALUE_BITS)) - 1),
-  ENCODING_LIMIT_3_BYTES = ((1 << (ndn_BinaryXml_TT_VALUE_BITS + 2 * ndn_BinaryXml_REGULAR_VALUE_BITS)) - 1)
-};
-
 /**
  * Call ndn_DynamicUInt8Array_ensureLength to ensure that there is enough room in the output, and copy
  * array to the output.  This does not write a header.
@@ -36,116 +30,32 @@ static ndn_Error writeArray(struct ndn_BinaryXmlEncoder *self, uint8_t *array, s
 }
 
 /**
- * Return the number of bytes to encode a header of value x.
+ * Return the number of bytes to write x as big endian with no leading zero bytes.  If x is 0, return 0.
  */
-static size_t getNHeaderEncodingBytes(unsigned int x) 
+static size_t getNBigEndianBytes(unsigned long x)
 {
-  // Do a quick check for pre-compiled results.
-  if (x <= ENCODING_LIMIT_1_BYTE) 
-    return 1;
-  if (x <= ENCODING_LIMIT_2_BYTES) 
-    return 2;
-  if (x <= ENCODING_LIMIT_3_BYTES) 
-    return 3;
-  
-  size_t nBytes = 1;
-  
-  // Last byte gives you TT_VALUE_BITS.
-  // Remainder each gives you REGULAR_VALUE_BITS.
-  x >>= ndn_BinaryXml_TT_VALUE_BITS;
+  size_t nBytes = 0;
   while (x != 0) {
     ++nBytes;
-    x >>= ndn_BinaryXml_REGULAR_VALUE_BITS;
+    x >>= 8;
   }
   
   return nBytes;
 }
 
 /**
- * Reverse the length bytes in array.
- * @param array
- * @param length
+ * Write x to array as nBytes big endian bytes, dropping higher bytes.
+ * @param array The array to write to.
+ * @param nBytes The number of bytes to write.
+ * @param x The value to write.
  */
-static void reverse(uint8_t *array, size_t length) 
+static void writeBigEndian(uint8_t *array, size_t nBytes, unsigned long x)
 {
-  if (length == 0)
-    return;
-  
-  uint8_t *left = array;
-  uint8_t *right = array + length - 1;
-  while (left < right) {
-    // Swap.
-    uint8_t temp = *left;
-    *left = *right;
-    *right = temp;
-    
-    ++left;
-    --right;
-  }
-}
-
-/**
- * Write x as an unsigned decimal integer to the output with the digits in reverse order, using ndn_DynamicUInt8Array_ensureLength.
- * This does not write a header.
- * We encode in reverse order, because this is the natural way to encode the digits, and the caller can reverse as needed.
- * @param self pointer to the ndn_BinaryXmlEncoder struct
- * @param x the unsigned int to write
- * @return 0 for success, else an error code
- */
-static ndn_Error encodeReversedUnsignedDecimalInt(struct ndn_BinaryXmlEncoder *self, unsigned int x) 
-{
-  while (1) {
-    ndn_Error error;
-    if ((error = ndn_DynamicUInt8Array_ensureLength(self->output, self->offset + 1)))
-      return error;
-    
-    self->output->array[self->offset++] = (uint8_t)(x % 10 + '0');
-    x /= 10;
-    
-    if (x == 0)
-      break;
+  while (nBytes > 0) {
+    --nBytes;
+    array[nBytes] = (uint8_t)(x & 0xff);
+    x >>= 8;
   }
-  
-  return NDN_ERROR_success;
-}
-
-/**
- * Reverse the buffer in self->output->array from startOffset to the current offset, then shift it right by the amount 
- * needed to prefix a header with type, then encode the header at startOffset.
- * We reverse and shift in the same function to avoid unnecessary copying if we first reverse then shift.
- * @param self pointer to the ndn_BinaryXmlEncoder struct
- * @param startOffset the offset in self->output->array of the start of the buffer to shift right
- * @param type the header type
- * @return 0 for success, else an error code
- */
-static ndn_Error reverseBufferAndInsertHeader
-  (struct ndn_BinaryXmlEncoder *self, size_t startOffset, unsigned int type)
-{
-  size_t nBufferBytes = self->offset - startOffset;
-  size_t nHeaderBytes = getNHeaderEncodingBytes(nBufferBytes);
-  ndn_Error error;
-  if ((error = ndn_DynamicUInt8Array_ensureLength(self->output, self->offset + nHeaderBytes)))
-    return error;
-  
-  // To reverse and shift at the same time, we first shift nHeaderBytes to the destination while reversing,
-  //   then reverse the remaining bytes in place.
-  uint8_t *from = self->output->array + startOffset;
-  uint8_t *fromEnd = from + nHeaderBytes;
-  uint8_t *to = self->output->array + startOffset + nBufferBytes + nHeaderBytes - 1;
-  while (from < fromEnd)
-    *(to--) = *(from++);
-  // Reverse the remaining bytes in place (if any).
-  if (nBufferBytes > nHeaderBytes)
-    reverse(self->output->array + startOffset + nHeaderBytes, nBufferBytes - nHeaderBytes);
-  
-  // Override the offset to force encodeTypeAndValue to encode at startOffset, then fix the offset.
-  self->offset = startOffset;
-  if ((error = ndn_BinaryXmlEncoder_encodeTypeAndValue(self, type, nBufferBytes)))
-    // We don't really expect to get an error, since we have already ensured the length.
-    return error;
-  self->offset = startOffset + nHeaderBytes + nBufferBytes;
-  
-  return NDN_ERROR_success;
 }
 
 /**
@@ -175,7 +85,7 @@ ndn_Error ndn_BinaryXmlEncoder_encodeTypeAndValue(struct ndn_BinaryXmlEncoder *s
     return NDN_ERROR_header_type_is_out_of_range;
   
   // Encode backwards. Calculate how many bytes we need.
-  size_t nEncodingBytes = getNHeaderEncodingBytes(value);
+  size_t nEncodingBytes = ndn_BinaryXmlEncoder_getHeaderLength(value);
   ndn_Error error;
   if ((error = ndn_DynamicUInt8Array_ensureLength(self->output, self->offset + nEncodingBytes)))
     return error;
@@ -195,7 +105,7 @@ ndn_Error ndn_BinaryXmlEncoder_encodeTypeAndValue(struct ndn_BinaryXmlEncoder *s
     --i;
   }
   if (value != 0)
-    // This should not happen if getNHeaderEncodingBytes is correct.
+    // This should not happen if ndn_BinaryXmlEncoder_getHeaderLength is correct.
     return NDN_ERROR_encodeTypeAndValue_miscalculated_N_encoding_bytes;
   
   self->offset+= nEncodingBytes;
@@ -271,16 +181,23 @@ ndn_Error ndn_BinaryXmlEncoder_writeUDataDTagElement(struct ndn_BinaryXmlEncoder
 
 ndn_Error ndn_BinaryXmlEncoder_writeUnsignedDecimalInt(struct ndn_BinaryXmlEncoder *self, unsigned int value)
 {
-  // First write the decimal int (to find out how many bytes it is), then shift it forward to make room for the header.
-  size_t startOffset = self->offset;
+  // Count the digits first so that we can write the header, then the digits in place.
+  size_t nDigits = ndn_BinaryXmlEncoder_getNDecimalDigits(value);
   
   ndn_Error error;
-  if ((error = encodeReversedUnsignedDecimalInt(self, value)))
+  if ((error = ndn_BinaryXmlEncoder_encodeTypeAndValue(self, ndn_BinaryXml_UDATA, nDigits)))
     return error;
-  
-  if ((error = reverseBufferAndInsertHeader(self, startOffset, ndn_BinaryXml_UDATA)))
+  if ((error = ndn_DynamicUInt8Array_ensureLength(self->output, self->offset + nDigits)))
     return error;
   
+  // Write the digits from the last one.
+  uint8_t *digit = self->output->array + self->offset + nDigits;
+  do {
+    *(--digit) = (uint8_t)(value % 10 + '0');
+    value /= 10;
+  } while (value != 0);
+  self->offset += nDigits;
+  
   return NDN_ERROR_success;
 }
 
@@ -304,40 +221,22 @@ ndn_Error ndn_BinaryXmlEncoder_writeAbsDoubleBigEndianBlob(struct ndn_BinaryXmlE
   unsigned long hi32, lo32;
   splitAbsDouble(value, &hi32, &lo32);
   
-  // First encode the big endian backwards, then reverseBufferAndInsertHeader will reverse it.
-  size_t startOffset = self->offset;
+  // Count the bytes first so that we can write the header, then the big endian value in place.  If hi32 is not 0,
+  // lo32 is padded out to 4 bytes.
+  size_t nHiBytes = getNBigEndianBytes(hi32);
+  size_t nLoBytes = nHiBytes > 0 ? 4 : getNBigEndianBytes(lo32);
   
   ndn_Error error;
-  while (lo32 != 0) {
-    if ((error = ndn_DynamicUInt8Array_ensureLength(self->output, self->offset + 1)))
-      return error;
-    
-    self->output->array[self->offset++] = (uint8_t)(lo32 & 0xff);
-    lo32 >>= 8;
-  }
-  
-  if (hi32 != 0) {
-    // Pad the lo values out to 4 bytes.
-    while (self->offset - startOffset < 4) {
-      if ((error = ndn_DynamicUInt8Array_ensureLength(self->output, self->offset + 1)))
-        return error;
-    
-      self->output->array[self->offset++] = 0;
-    }
-    
-    // Encode hi32
-    while (hi32 != 0) {
-      if ((error = ndn_DynamicUInt8Array_ensureLength(self->output, self->offset + 1)))
-        return error;
-    
-      self->output->array[self->offset++] = (uint8_t)(hi32 & 0xff);
-      hi32 >>= 8;
-    }
-  }
+  if ((error = ndn_BinaryXmlEncoder_encodeTypeAndValue(self, ndn_BinaryXml_BLOB, nHiBytes + nLoBytes)))
+    return error;
   
-  if ((error = reverseBufferAndInsertHeader(self, startOffset, ndn_BinaryXml_BLOB)))
+  if ((error = ndn_DynamicUInt8Array_ensureLength(self->output, self->offset + nHiBytes + nLoBytes)))
     return error;
   
+  writeBigEndian(self->output->array + self->offset, nHiBytes, hi32);
+  writeBigEndian(self->output->array + self->offset + nHiBytes, nLoBytes, lo32);
+  self->offset += nHiBytes + nLoBytes;
+  
   return NDN_ERROR_success;
 }
 
@@ -355,3 +254,13 @@ ndn_Error ndn_BinaryXmlEncoder_writeTimeMillisecondsDTagElement(struct ndn_Binar
   
   return NDN_ERROR_success;
 }
+
+size_t ndn_BinaryXmlEncoder_getTimeMillisecondsDTagElementLength(unsigned int tag, double milliseconds)
+{
+  unsigned long hi32, lo32;
+  splitAbsDouble((milliseconds / 1000.0) * 4096.0, &hi32, &lo32);
+  size_t nHiBytes = getNBigEndianBytes(hi32);
+  size_t nBytes = nHiBytes > 0 ? nHiBytes + 4 : getNBigEndianBytes(lo32);
+  
+  return ndn_BinaryXmlEncoder_getBlobDTagElementLength(tag, nBytes);
+}
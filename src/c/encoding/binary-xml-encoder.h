@@ -202,6 +202,134 @@ static inline ndn_Error ndn_BinaryXmlEncoder_writeOptionalTimeMillisecondsDTagEl
     return NDN_ERROR_success;
 }
 
+enum {
+  ndn_BinaryXmlEncoder_ENCODING_LIMIT_1_BYTE = ((1 << ndn_BinaryXml_TT_VALUE_BITS) - 1),
+  ndn_BinaryXmlEncoder_ENCODING_LIMIT_2_BYTES = ((1 << (ndn_BinaryXml_TT_VALUE_BITS + ndn_BinaryXml_REGULAR_VALUE_BITS)) - 1),
+  ndn_BinaryXmlEncoder_ENCODING_LIMIT_3_BYTES = ((1 << (ndn_BinaryXml_TT_VALUE_BITS + 2 * ndn_BinaryXml_REGULAR_VALUE_BITS)) - 1)
+};
+
+/**
+ * Return the number of bytes to encode a header of value x.
+ * @param x the header value
+ * @return the number of header bytes
+ */
+static inline size_t ndn_BinaryXmlEncoder_getHeaderLength(unsigned int x)
+{
+  // Do a quick check for pre-compiled results.
+  if (x <= ndn_BinaryXmlEncoder_ENCODING_LIMIT_1_BYTE) 
+    return 1;
+  if (x <= ndn_BinaryXmlEncoder_ENCODING_LIMIT_2_BYTES) 
+    return 2;
+  if (x <= ndn_BinaryXmlEncoder_ENCODING_LIMIT_3_BYTES) 
+    return 3;
+  
+  size_t nBytes = 1;
+  
+  // Last byte gives you TT_VALUE_BITS.
+  // Remainder each gives you REGULAR_VALUE_BITS.
+  x >>= ndn_BinaryXml_TT_VALUE_BITS;
+  while (x != 0) {
+    ++nBytes;
+    x >>= ndn_BinaryXml_REGULAR_VALUE_BITS;
+  }
+  
+  return nBytes;
+}
+
+/**
+ * Return the number of decimal digits to write x.  If x is 0, return 1.
+ * @param x the unsigned int
+ * @return the number of digits
+ */
+static inline size_t ndn_BinaryXmlEncoder_getNDecimalDigits(unsigned int x)
+{
+  size_t nDigits = 1;
+  while (x >= 10) {
+    ++nDigits;
+    x /= 10;
+  }
+  
+  return nDigits;
+}
+
+/**
+ * Return the number of bytes which ndn_BinaryXmlEncoder_writeBlobDTagElement writes for a value of valueLength
+ * bytes.  This is also the length for ndn_BinaryXmlEncoder_writeUDataDTagElement.
+ * @param tag the DTAG tag
+ * @param valueLength the number of bytes in the value
+ * @return the encoding length
+ */
+static inline size_t ndn_BinaryXmlEncoder_getBlobDTagElementLength(unsigned int tag, size_t valueLength)
+{
+  return ndn_BinaryXmlEncoder_getHeaderLength(tag) + ndn_BinaryXmlEncoder_getHeaderLength(valueLength) + 
+         valueLength + 1;
+}
+
+/**
+ * Return the number of bytes which ndn_BinaryXmlEncoder_writeOptionalBlobDTagElement writes, which is 0 if value or
+ * valueLen is 0.  This is also the length for ndn_BinaryXmlEncoder_writeOptionalUDataDTagElement.
+ * @param tag the DTAG tag
+ * @param value A Blob with the array of bytes for the value.
+ * @return the encoding length
+ */
+static inline size_t ndn_BinaryXmlEncoder_getOptionalBlobDTagElementLength(unsigned int tag, struct ndn_Blob *value)
+{
+  if (value->value && value->length > 0)
+    return ndn_BinaryXmlEncoder_getBlobDTagElementLength(tag, value->length);
+  else
+    return 0;
+}
+
+/**
+ * Return the number of bytes which ndn_BinaryXmlEncoder_writeUnsignedDecimalIntDTagElement writes.
+ * @param tag the DTAG tag
+ * @param value the unsigned int
+ * @return the encoding length
+ */
+static inline size_t ndn_BinaryXmlEncoder_getUnsignedDecimalIntDTagElementLength(unsigned int tag, unsigned int value)
+{
+  return ndn_BinaryXmlEncoder_getBlobDTagElementLength(tag, ndn_BinaryXmlEncoder_getNDecimalDigits(value));
+}
+
+/**
+ * Return the number of bytes which ndn_BinaryXmlEncoder_writeOptionalUnsignedDecimalIntDTagElement writes, which is
+ * 0 if value is negative.
+ * @param tag the DTAG tag
+ * @param value negative for none, otherwise use (unsigned int)value
+ * @return the encoding length
+ */
+static inline size_t ndn_BinaryXmlEncoder_getOptionalUnsignedDecimalIntDTagElementLength(unsigned int tag, int value)
+{
+  if (value >= 0)
+    return ndn_BinaryXmlEncoder_getUnsignedDecimalIntDTagElementLength(tag, (unsigned int)value);
+  else
+    return 0;
+}
+
+/**
+ * Return the number of bytes which ndn_BinaryXmlEncoder_writeTimeMillisecondsDTagElement writes.
+ * @param tag the DTAG tag
+ * @param milliseconds the the number of milliseconds
+ * @return the encoding length
+ */
+size_t ndn_BinaryXmlEncoder_getTimeMillisecondsDTagElementLength(unsigned int tag, double milliseconds);
+
+/**
+ * Return the number of bytes which ndn_BinaryXmlEncoder_writeOptionalTimeMillisecondsDTagElement writes, which is 0
+ * if milliseconds is negative.
+ * @param tag the DTAG tag
+ * @param milliseconds negative for none, otherwise the number of milliseconds
+ * @return the encoding length
+ */
+static inline size_t ndn_BinaryXmlEncoder_getOptionalTimeMillisecondsDTagElementLength
+  (unsigned int tag, double milliseconds)
+{
+  if (milliseconds >= 0)
+    return ndn_BinaryXmlEncoder_getTimeMillisecondsDTagElementLength(tag, milliseconds);
+  else
+    return 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -42,6 +42,20 @@ ndn_Error ndn_encodeBinaryXmlForwardingEntry(struct ndn_ForwardingEntry *forward
   return NDN_ERROR_success;  
 }
 
+size_t ndn_getBinaryXmlForwardingEntryEncodingLength(struct ndn_ForwardingEntry *forwardingEntry)
+{
+  return ndn_BinaryXmlEncoder_getHeaderLength(ndn_BinaryXml_DTag_ForwardingEntry) + 1 +
+    ndn_BinaryXmlEncoder_getOptionalBlobDTagElementLength(ndn_BinaryXml_DTag_Action, &forwardingEntry->action) +
+    ndn_getBinaryXmlNameEncodingLength(&forwardingEntry->prefix) +
+    ndn_getBinaryXmlPublisherPublicKeyDigestEncodingLength(&forwardingEntry->publisherPublicKeyDigest) +
+    ndn_BinaryXmlEncoder_getOptionalUnsignedDecimalIntDTagElementLength
+      (ndn_BinaryXml_DTag_FaceID, forwardingEntry->faceId) +
+    ndn_BinaryXmlEncoder_getUnsignedDecimalIntDTagElementLength
+      (ndn_BinaryXml_DTag_ForwardingFlags, ndn_ForwardingFlags_getForwardingEntryFlags(&forwardingEntry->forwardingFlags)) +
+    ndn_BinaryXmlEncoder_getOptionalUnsignedDecimalIntDTagElementLength
+      (ndn_BinaryXml_DTag_FreshnessSeconds, forwardingEntry->freshnessSeconds);
+}
+
 ndn_Error ndn_decodeBinaryXmlForwardingEntry(struct ndn_ForwardingEntry *forwardingEntry, struct ndn_BinaryXmlDecoder *decoder)
 {
   ndn_Error error;
@@ -24,6 +24,13 @@ extern "C" {
  */
 ndn_Error ndn_encodeBinaryXmlForwardingEntry(struct ndn_ForwardingEntry *forwardingEntry, struct ndn_BinaryXmlEncoder *encoder);
 
+/**
+ * Return the number of bytes which ndn_encodeBinaryXmlForwardingEntry writes for the forwarding entry.
+ * @param forwardingEntry A pointer to the ndn_ForwardingEntry struct.
+ * @return The encoding length.
+ */
+size_t ndn_getBinaryXmlForwardingEntryEncodingLength(struct ndn_ForwardingEntry *forwardingEntry);
+
 /**
  * Expect the next element to be a Binary XML ForwardingEntry and decode into the ndn_ForwardingEntry struct.
  * @param forwardingEntry pointer to the ndn_ForwardingEntry struct
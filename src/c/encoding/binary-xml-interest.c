@@ -43,6 +43,29 @@ static ndn_Error encodeExclude(struct ndn_Exclude *exclude, struct ndn_BinaryXml
   return NDN_ERROR_success;  
 }
 
+/**
+ * Return the number of bytes which encodeExclude writes, which is 0 if there are no entries.
+ */
+static size_t getExcludeEncodingLength(struct ndn_Exclude *exclude)
+{
+  if (exclude->nEntries == 0)
+    return 0;
+  
+  size_t length = ndn_BinaryXmlEncoder_getHeaderLength(ndn_BinaryXml_DTag_Exclude) + 1;
+  size_t i;
+  for (i = 0; i < exclude->nEntries; ++i) {
+    struct ndn_ExcludeEntry *entry = &exclude->entries[i];
+    
+    if (entry->type == ndn_Exclude_COMPONENT)
+      length += ndn_BinaryXmlEncoder_getBlobDTagElementLength(ndn_BinaryXml_DTag_Component, entry->component.value.length);
+    else
+      // ndn_Exclude_ANY is an empty element.
+      length += ndn_BinaryXmlEncoder_getHeaderLength(ndn_BinaryXml_DTag_Any) + 1;
+  }
+  
+  return length;
+}
+
 static ndn_Error decodeExclude(struct ndn_Exclude *exclude, struct ndn_BinaryXmlDecoder *decoder)
 {
   ndn_Error error;
@@ -164,6 +187,30 @@ ndn_Error ndn_encodeBinaryXmlInterest(struct ndn_Interest *interest, struct ndn_
   return NDN_ERROR_success;  
 }
 
+size_t ndn_getBinaryXmlInterestEncodingLength(struct ndn_Interest *interest)
+{
+  size_t length = ndn_BinaryXmlEncoder_getHeaderLength(ndn_BinaryXml_DTag_Interest) + 1 +
+    ndn_getBinaryXmlNameEncodingLength(&interest->name) +
+    ndn_BinaryXmlEncoder_getOptionalUnsignedDecimalIntDTagElementLength
+      (ndn_BinaryXml_DTag_MinSuffixComponents, interest->minSuffixComponents) +
+    ndn_BinaryXmlEncoder_getOptionalUnsignedDecimalIntDTagElementLength
+      (ndn_BinaryXml_DTag_MaxSuffixComponents, interest->maxSuffixComponents) +
+    ndn_getBinaryXmlPublisherPublicKeyDigestEncodingLength(&interest->publisherPublicKeyDigest) +
+    getExcludeEncodingLength(&interest->exclude) +
+    ndn_BinaryXmlEncoder_getOptionalUnsignedDecimalIntDTagElementLength
+      (ndn_BinaryXml_DTag_ChildSelector, interest->childSelector);
+  if (interest->answerOriginKind >= 0 && interest->answerOriginKind != ndn_Interest_DEFAULT_ANSWER_ORIGIN_KIND)
+    length += ndn_BinaryXmlEncoder_getUnsignedDecimalIntDTagElementLength
+      (ndn_BinaryXml_DTag_AnswerOriginKind, (unsigned int)interest->answerOriginKind);
+  length += 
+    ndn_BinaryXmlEncoder_getOptionalUnsignedDecimalIntDTagElementLength(ndn_BinaryXml_DTag_Scope, interest->scope) +
+    ndn_BinaryXmlEncoder_getOptionalTimeMillisecondsDTagElementLength
+      (ndn_BinaryXml_DTag_InterestLifetime, interest->interestLifetimeMilliseconds) +
+    ndn_BinaryXmlEncoder_getOptionalBlobDTagElementLength(ndn_BinaryXml_DTag_Nonce, &interest->nonce);
+  
+  return length;
+}
+
 ndn_Error ndn_decodeBinaryXmlInterest(struct ndn_Interest *interest, struct ndn_BinaryXmlDecoder *decoder)
 {
   ndn_Error error;
@@ -216,3 +263,12 @@ ndn_Error ndn_decodeBinaryXmlInterest(struct ndn_Interest *interest, struct ndn_
   
   return NDN_ERROR_success;
 }
+
+ndn_Error ndn_decodeBinaryXmlInterestName(struct ndn_Name *name, struct ndn_BinaryXmlDecoder *decoder)
+{
+  ndn_Error error;
+  if ((error = ndn_BinaryXmlDecoder_readElementStartDTag(decoder, ndn_BinaryXml_DTag_Interest)))
+    return error;
+
+  return ndn_decodeBinaryXmlName(name, decoder);
+}
@@ -18,8 +18,25 @@ extern "C" {
 
 ndn_Error ndn_encodeBinaryXmlInterest(struct ndn_Interest *interest, struct ndn_BinaryXmlEncoder *encoder);
 
+/**
+ * Return the number of bytes which ndn_encodeBinaryXmlInterest writes for the interest, so that you can allocate the
+ * output once before encoding.
+ * @param interest A pointer to the ndn_Interest struct.
+ * @return The encoding length.
+ */
+size_t ndn_getBinaryXmlInterestEncodingLength(struct ndn_Interest *interest);
+
 ndn_Error ndn_decodeBinaryXmlInterest(struct ndn_Interest *interest, struct ndn_BinaryXmlDecoder *decoder);
 
+/**
+ * Decode only the name of the binary XML interest.  This leaves the decoder offset after the Name element, so the
+ * selectors and the rest of the interest are not checked.
+ * @param name Pointer to the name object whose fields are updated.
+ * @param decoder Pointer to the ndn_BinaryXmlDecoder struct which has been initialized with the buffer to decode.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error ndn_decodeBinaryXmlInterestName(struct ndn_Name *name, struct ndn_BinaryXmlDecoder *decoder);
+
 #ifdef __cplusplus
 }
 #endif
@@ -121,6 +121,31 @@ ndn_Error ndn_encodeBinaryXmlKeyLocator(struct ndn_KeyLocator *keyLocator, struc
   return NDN_ERROR_success;
 }
 
+size_t ndn_getBinaryXmlKeyLocatorEncodingLength(struct ndn_KeyLocator *keyLocator)
+{
+  if ((int)keyLocator->type < 0)
+    return 0;
+
+  size_t length = ndn_BinaryXmlEncoder_getHeaderLength(ndn_BinaryXml_DTag_KeyLocator) + 1;
+  if (keyLocator->type == ndn_KeyLocatorType_KEY)
+    length += ndn_BinaryXmlEncoder_getBlobDTagElementLength(ndn_BinaryXml_DTag_Key, keyLocator->keyData.length);
+  else if (keyLocator->type == ndn_KeyLocatorType_CERTIFICATE)
+    length += ndn_BinaryXmlEncoder_getBlobDTagElementLength(ndn_BinaryXml_DTag_Certificate, keyLocator->keyData.length);
+  else if (keyLocator->type == ndn_KeyLocatorType_KEYNAME) {
+    length += ndn_BinaryXmlEncoder_getHeaderLength(ndn_BinaryXml_DTag_KeyName) + 1 + 
+              ndn_getBinaryXmlNameEncodingLength(&keyLocator->keyName);
+    
+    if ((int)keyLocator->keyNameType >= 0 && keyLocator->keyData.length > 0) {
+      // All the key name type tags are below ENCODING_LIMIT_2_BYTES so they have the same length, and an unrecognized 
+      // keyNameType is an encoding error anyway.
+      length += ndn_BinaryXmlEncoder_getBlobDTagElementLength
+        (ndn_BinaryXml_DTag_PublisherPublicKeyDigest, keyLocator->keyData.length);
+    }
+  }
+
+  return length;
+}
+
 ndn_Error ndn_decodeBinaryXmlKeyLocator(struct ndn_KeyLocator *keyLocator, struct ndn_BinaryXmlDecoder *decoder)
 {
   ndn_Error error;
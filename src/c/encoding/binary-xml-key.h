@@ -24,6 +24,14 @@ extern "C" {
  */
 ndn_Error ndn_encodeBinaryXmlKeyLocator(struct ndn_KeyLocator *keyLocator, struct ndn_BinaryXmlEncoder *encoder);
 
+/**
+ * Return the number of bytes which ndn_encodeBinaryXmlKeyLocator writes for the key locator, which is 0 if the
+ * type is none.
+ * @param keyLocator A pointer to the ndn_KeyLocator struct.
+ * @return The encoding length.
+ */
+size_t ndn_getBinaryXmlKeyLocatorEncodingLength(struct ndn_KeyLocator *keyLocator);
+
 /**
  * Expect the next element to be a Binary XML KeyLocator and decode into the ndn_KeyLocator struct.
  * @param keyLocator pointer to the ndn_KeyLocator struct
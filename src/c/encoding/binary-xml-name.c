@@ -25,6 +25,17 @@ ndn_Error ndn_encodeBinaryXmlName(struct ndn_Name *name, struct ndn_BinaryXmlEnc
   return NDN_ERROR_success;
 }
 
+size_t ndn_getBinaryXmlNameEncodingLength(struct ndn_Name *name)
+{
+  size_t length = ndn_BinaryXmlEncoder_getHeaderLength(ndn_BinaryXml_DTag_Name) + 1;
+  size_t i;
+  for (i = 0; i < name->nComponents; ++i)
+    length += ndn_BinaryXmlEncoder_getBlobDTagElementLength
+      (ndn_BinaryXml_DTag_Component, name->components[i].value.length);
+  
+  return length;
+}
+
 ndn_Error ndn_decodeBinaryXmlName(struct ndn_Name *name, struct ndn_BinaryXmlDecoder *decoder)
 {
   ndn_Error error;
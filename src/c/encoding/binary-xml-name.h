@@ -18,6 +18,13 @@ extern "C" {
 
 ndn_Error ndn_encodeBinaryXmlName(struct ndn_Name *name, struct ndn_BinaryXmlEncoder *encoder);
 
+/**
+ * Return the number of bytes which ndn_encodeBinaryXmlName writes for the name.
+ * @param name A pointer to the ndn_Name struct.
+ * @return The encoding length.
+ */
+size_t ndn_getBinaryXmlNameEncodingLength(struct ndn_Name *name);
+
 ndn_Error ndn_decodeBinaryXmlName(struct ndn_Name *name, struct ndn_BinaryXmlDecoder *decoder);
 
 #ifdef __cplusplus
@@ -22,6 +22,12 @@ ndn_Error ndn_encodeBinaryXmlPublisherPublicKeyDigest
   return NDN_ERROR_success;
 }
 
+size_t ndn_getBinaryXmlPublisherPublicKeyDigestEncodingLength(struct ndn_PublisherPublicKeyDigest *publisherPublicKeyDigest)
+{
+  return ndn_BinaryXmlEncoder_getOptionalBlobDTagElementLength
+    (ndn_BinaryXml_DTag_PublisherPublicKeyDigest, &publisherPublicKeyDigest->publisherPublicKeyDigest);
+}
+
 ndn_Error ndn_decodeBinaryXmlPublisherPublicKeyDigest
   (struct ndn_PublisherPublicKeyDigest *publisherPublicKeyDigest, struct ndn_BinaryXmlDecoder *decoder)
 {
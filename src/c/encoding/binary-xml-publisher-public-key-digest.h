@@ -26,6 +26,14 @@ extern "C" {
 ndn_Error ndn_encodeBinaryXmlPublisherPublicKeyDigest
   (struct ndn_PublisherPublicKeyDigest *publisherPublicKeyDigest, struct ndn_BinaryXmlEncoder *encoder);
 
+/**
+ * Return the number of bytes which ndn_encodeBinaryXmlPublisherPublicKeyDigest writes, which is 0 if there is no
+ * publisherPublicKeyDigest.
+ * @param publisherPublicKeyDigest A pointer to the ndn_PublisherPublicKeyDigest struct.
+ * @return The encoding length.
+ */
+size_t ndn_getBinaryXmlPublisherPublicKeyDigestEncodingLength(struct ndn_PublisherPublicKeyDigest *publisherPublicKeyDigest);
+
 /**
  * Expect the next element to be a Binary XML PublisherPublicKeyDigest and decode into the ndn_PublisherPublicKeyDigest struct.
  * @param publisherPublicKeyDigest pointer to the ndn_PublisherPublicKeyDigest struct
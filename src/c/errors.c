@@ -73,6 +73,24 @@ char *ndn_getErrorString(int error)
     return      "SocketTransport error in recv";
   case NDN_ERROR_SocketTransport_error_in_close:
     return      "SocketTransport error in close";
+  case NDN_ERROR_SocketTransport_error_in_getsockopt:
+    return      "SocketTransport error in getsockopt";
+  case NDN_ERROR_SocketTransport_connection_closed_by_the_peer:
+    return      "SocketTransport connection closed by the peer";
+  case NDN_ERROR_ShmTransport_eventfd_is_not_supported:
+    return      "ShmTransport eventfd is not supported";
+  case NDN_ERROR_ShmTransport_cannot_create_shared_memory:
+    return      "ShmTransport cannot create shared memory";
+  case NDN_ERROR_ShmTransport_error_in_handshake:
+    return      "ShmTransport error in handshake";
+  case NDN_ERROR_ShmTransport_transport_is_not_open:
+    return      "ShmTransport transport is not open";
+  case NDN_ERROR_ShmTransport_element_is_too_large_for_the_ring:
+    return      "ShmTransport element is too large for the ring";
+  case NDN_ERROR_ShmTransport_invalid_shared_memory_from_the_peer:
+    return      "ShmTransport invalid shared memory from the peer";
+  case NDN_ERROR_ShmTransport_invalid_record_in_the_receive_ring:
+    return      "ShmTransport invalid record in the receive ring";
   case NDN_ERROR_Name_component_does_not_begin_with_the_expected_marker:
     return      "Name component does not begin with the expected marker";
   case NDN_ERROR_Time_functions_are_not_supported_by_the_standard_library:
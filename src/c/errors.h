@@ -45,6 +45,15 @@ typedef enum {
   NDN_ERROR_SocketTransport_error_in_poll,
   NDN_ERROR_SocketTransport_error_in_recv,
   NDN_ERROR_SocketTransport_error_in_close,
+  NDN_ERROR_SocketTransport_error_in_getsockopt,
+  NDN_ERROR_SocketTransport_connection_closed_by_the_peer,
+  NDN_ERROR_ShmTransport_eventfd_is_not_supported,
+  NDN_ERROR_ShmTransport_cannot_create_shared_memory,
+  NDN_ERROR_ShmTransport_error_in_handshake,
+  NDN_ERROR_ShmTransport_transport_is_not_open,
+  NDN_ERROR_ShmTransport_element_is_too_large_for_the_ring,
+  NDN_ERROR_ShmTransport_invalid_shared_memory_from_the_peer,
+  NDN_ERROR_ShmTransport_invalid_record_in_the_receive_ring,
   NDN_ERROR_Name_component_does_not_begin_with_the_expected_marker,
   NDN_ERROR_Time_functions_are_not_supported_by_the_standard_library,
   NDN_ERROR_Calendar_time_value_out_of_range
@@ -42,13 +42,17 @@ int ndn_Name_match(struct ndn_Name *self, struct ndn_Name *name)
   if (self->nComponents > name->nComponents)
     return 0;
 
-  // Check if at least one of given components doesn't match.
+  // Check if at least one of given components doesn't match.  Names in the same namespace usually differ in the last
+  // components, so check from the last component to find a mismatch sooner.
   size_t i;
-  for (i = 0; i < self->nComponents; ++i) {
-    struct ndn_NameComponent *selfComponent = self->components + i;
-    struct ndn_NameComponent *nameComponent = name->components + i;
+  for (i = self->nComponents; i > 0; --i) {
+    struct ndn_NameComponent *selfComponent = self->components + i - 1;
+    struct ndn_NameComponent *nameComponent = name->components + i - 1;
 
-    if (selfComponent->value.length != nameComponent->value.length ||
+    if (selfComponent->value.length != nameComponent->value.length)
+      return 0;
+    // Values which share the same bytes are equal without comparing them.
+    if (selfComponent->value.value != nameComponent->value.value &&
         ndn_memcmp(selfComponent->value.value, nameComponent->value.value, selfComponent->value.length) != 0)
       return 0;
   }
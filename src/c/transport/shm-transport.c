@@ -0,0 +1,385 @@
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <ndn-cpp/ndn-cpp-config.h>
+#include "shm-transport.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#if NDN_CPP_HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#endif
+#include "../util/ndn_memory.h"
+
+// The record length which tells the reader that the rest of the ring is unused and the next record is at the start.
+#define WRAP_RECORD_LENGTH 0xffffffff
+
+/**
+ * Get the number of bytes that a record uses in the ring, which is the 4-byte length, then the data, padded so that
+ * the next record is 8-byte aligned.
+ */
+static size_t recordSize(size_t dataLength)
+{
+  return (4 + dataLength + 7) & ~(size_t)7;
+}
+
+static void signalEvent(int eventFd)
+{
+  uint64_t value = 1;
+  // Ignore other errors since the count only overflows if the peer never reads it.
+  while (write(eventFd, &value, sizeof(value)) < 0 && errno == EINTR)
+    ;
+}
+
+/**
+ * Create an unlinked file of the given length for the shared memory, preferring /dev/shm which is in memory.
+ * @return The file descriptor, or -1 if it can't be created.
+ */
+static int createSharedMemoryFile(size_t length)
+{
+  char shmPath[] = "/dev/shm/ndn-cpp-shm-XXXXXX";
+  char tmpPath[] = "/tmp/ndn-cpp-shm-XXXXXX";
+  char *path = shmPath;
+  int fileDescriptor = mkstemp(path);
+  if (fileDescriptor < 0) {
+    path = tmpPath;
+    if ((fileDescriptor = mkstemp(path)) < 0)
+      return -1;
+  }
+  // The peer gets the file descriptor, so we don't need the name.
+  unlink(path);
+
+  if (ftruncate(fileDescriptor, length) != 0) {
+    close(fileDescriptor);
+    return -1;
+  }
+  return fileDescriptor;
+}
+
+/**
+ * Map the shared memory and set the ring pointers.  Ring 0 carries records from the listener to the connector, and
+ * ring 1 carries records from the connector to the listener.
+ */
+static ndn_Error mapRegion(struct ndn_ShmTransport *self, int regionFileDescriptor, size_t capacity, int isListener)
+{
+  size_t regionLength = 2 * (sizeof(struct ndn_ShmRingHeader) + capacity);
+  void *region = mmap(0, regionLength, PROT_READ | PROT_WRITE, MAP_SHARED, regionFileDescriptor, 0);
+  if (region == MAP_FAILED)
+    return NDN_ERROR_ShmTransport_cannot_create_shared_memory;
+
+  self->region = (uint8_t *)region;
+  self->regionLength = regionLength;
+  self->capacity = capacity;
+  struct ndn_ShmRingHeader *header0 = (struct ndn_ShmRingHeader *)self->region;
+  uint8_t *data0 = self->region + sizeof(struct ndn_ShmRingHeader);
+  struct ndn_ShmRingHeader *header1 = (struct ndn_ShmRingHeader *)(data0 + capacity);
+  uint8_t *data1 = (uint8_t *)header1 + sizeof(struct ndn_ShmRingHeader);
+  if (isListener) {
+    self->sendHeader = header0;
+    self->sendData = data0;
+    self->receiveHeader = header1;
+    self->receiveData = data1;
+  }
+  else {
+    self->sendHeader = header1;
+    self->sendData = data1;
+    self->receiveHeader = header0;
+    self->receiveData = data0;
+  }
+  self->receivePosition = self->receiveHeader->readPosition;
+
+  return NDN_ERROR_success;
+}
+
+/**
+ * Make a sockaddr_un for the Unix socket file path.
+ * @return 0 for success, or -1 if the path is too long.
+ */
+static int makeUnixAddress(struct sockaddr_un *address, char *filePath)
+{
+  size_t pathLength = strlen(filePath);
+  if (pathLength >= sizeof(address->sun_path))
+    return -1;
+
+  ndn_memset((uint8_t *)address, 0, sizeof(*address));
+  address->sun_family = AF_UNIX;
+  ndn_memcpy((uint8_t *)address->sun_path, (uint8_t *)filePath, pathLength);
+  return 0;
+}
+
+ndn_Error ndn_ShmTransport_listen(struct ndn_ShmTransport *self, char *filePath, size_t capacity)
+{
+#if NDN_CPP_HAVE_SYS_EVENTFD_H
+  ndn_ShmTransport_close(self);
+  // Keep the second ring header in its own cache line.
+  capacity = (capacity + 63) & ~(size_t)63;
+
+  struct sockaddr_un address;
+  if (makeUnixAddress(&address, filePath) != 0)
+    return NDN_ERROR_SocketTransport_cannot_connect_to_socket;
+  unlink(filePath);
+  int listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listenSocket < 0)
+    return NDN_ERROR_ShmTransport_error_in_handshake;
+  if (bind(listenSocket, (struct sockaddr *)&address, sizeof(address)) != 0 || listen(listenSocket, 1) != 0) {
+    close(listenSocket);
+    return NDN_ERROR_ShmTransport_error_in_handshake;
+  }
+
+  int peerSocket;
+  while ((peerSocket = accept(listenSocket, 0, 0)) < 0 && errno == EINTR)
+    ;
+  close(listenSocket);
+  unlink(filePath);
+  if (peerSocket < 0)
+    return NDN_ERROR_ShmTransport_error_in_handshake;
+
+  int fileDescriptors[3];
+  fileDescriptors[0] = createSharedMemoryFile(2 * (sizeof(struct ndn_ShmRingHeader) + capacity));
+  fileDescriptors[1] = eventfd(0, EFD_NONBLOCK);
+  fileDescriptors[2] = eventfd(0, EFD_NONBLOCK);
+  ndn_Error error = NDN_ERROR_success;
+  if (fileDescriptors[0] < 0 || fileDescriptors[1] < 0 || fileDescriptors[2] < 0)
+    error = NDN_ERROR_ShmTransport_cannot_create_shared_memory;
+  if (!error)
+    error = mapRegion(self, fileDescriptors[0], capacity, 1);
+
+  if (!error) {
+    // Send the capacity with the shared memory file and the eventfds of the listener and the connector.
+    uint64_t capacityValue = capacity;
+    struct iovec ioVector;
+    ioVector.iov_base = &capacityValue;
+    ioVector.iov_len = sizeof(capacityValue);
+    union {
+      struct cmsghdr header;
+      uint8_t buffer[CMSG_SPACE(sizeof(fileDescriptors))];
+    } control;
+    ndn_memset((uint8_t *)&control, 0, sizeof(control));
+    struct msghdr message;
+    ndn_memset((uint8_t *)&message, 0, sizeof(message));
+    message.msg_iov = &ioVector;
+    message.msg_iovlen = 1;
+    message.msg_control = control.buffer;
+    message.msg_controllen = sizeof(control.buffer);
+    struct cmsghdr *controlHeader = CMSG_FIRSTHDR(&message);
+    controlHeader->cmsg_level = SOL_SOCKET;
+    controlHeader->cmsg_type = SCM_RIGHTS;
+    controlHeader->cmsg_len = CMSG_LEN(sizeof(fileDescriptors));
+    ndn_memcpy(CMSG_DATA(controlHeader), (uint8_t *)fileDescriptors, sizeof(fileDescriptors));
+
+    if (sendmsg(peerSocket, &message, 0) != sizeof(capacityValue))
+      error = NDN_ERROR_ShmTransport_error_in_handshake;
+  }
+
+  // The mapping keeps the shared memory after closing its file.
+  if (fileDescriptors[0] >= 0)
+    close(fileDescriptors[0]);
+  close(peerSocket);
+  if (error) {
+    if (fileDescriptors[1] >= 0)
+      close(fileDescriptors[1]);
+    if (fileDescriptors[2] >= 0)
+      close(fileDescriptors[2]);
+    ndn_ShmTransport_close(self);
+    return error;
+  }
+
+  self->eventFd = fileDescriptors[1];
+  self->peerEventFd = fileDescriptors[2];
+  return NDN_ERROR_success;
+#else
+  return NDN_ERROR_ShmTransport_eventfd_is_not_supported;
+#endif
+}
+
+ndn_Error ndn_ShmTransport_connect(struct ndn_ShmTransport *self, char *filePath)
+{
+#if NDN_CPP_HAVE_SYS_EVENTFD_H
+  ndn_ShmTransport_close(self);
+
+  struct sockaddr_un address;
+  if (makeUnixAddress(&address, filePath) != 0)
+    return NDN_ERROR_SocketTransport_cannot_connect_to_socket;
+  int socketDescriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (socketDescriptor < 0)
+    return NDN_ERROR_SocketTransport_cannot_connect_to_socket;
+  if (connect(socketDescriptor, (struct sockaddr *)&address, sizeof(address)) != 0) {
+    close(socketDescriptor);
+    return NDN_ERROR_SocketTransport_cannot_connect_to_socket;
+  }
+
+  uint64_t capacity;
+  struct iovec ioVector;
+  ioVector.iov_base = &capacity;
+  ioVector.iov_len = sizeof(capacity);
+  int fileDescriptors[3];
+  union {
+    struct cmsghdr header;
+    uint8_t buffer[CMSG_SPACE(sizeof(fileDescriptors))];
+  } control;
+  struct msghdr message;
+  ndn_memset((uint8_t *)&message, 0, sizeof(message));
+  message.msg_iov = &ioVector;
+  message.msg_iovlen = 1;
+  message.msg_control = control.buffer;
+  message.msg_controllen = sizeof(control.buffer);
+
+  ssize_t nBytes;
+  while ((nBytes = recvmsg(socketDescriptor, &message, 0)) < 0 && errno == EINTR)
+    ;
+  close(socketDescriptor);
+  struct cmsghdr *controlHeader = CMSG_FIRSTHDR(&message);
+  if (nBytes != sizeof(capacity) || !controlHeader || controlHeader->cmsg_level != SOL_SOCKET ||
+      controlHeader->cmsg_type != SCM_RIGHTS || controlHeader->cmsg_len != CMSG_LEN(sizeof(fileDescriptors)))
+    return NDN_ERROR_ShmTransport_error_in_handshake;
+  ndn_memcpy((uint8_t *)fileDescriptors, CMSG_DATA(controlHeader), sizeof(fileDescriptors));
+
+  // Don't trust the capacity from the peer.  The listener rounds it to a multiple of 64, and the shared memory file
+  // must hold both rings so that mapping it doesn't leave ring pages past the end of the file.
+  ndn_Error error = NDN_ERROR_success;
+  struct stat fileStatus;
+  if (capacity == 0 || capacity % 64 != 0 ||
+      capacity > ((size_t)-1 / 2 - sizeof(struct ndn_ShmRingHeader)) ||
+      fstat(fileDescriptors[0], &fileStatus) != 0 || fileStatus.st_size < 0 ||
+      (uint64_t)fileStatus.st_size < 2 * (sizeof(struct ndn_ShmRingHeader) + capacity))
+    error = NDN_ERROR_ShmTransport_invalid_shared_memory_from_the_peer;
+  if (!error)
+    error = mapRegion(self, fileDescriptors[0], (size_t)capacity, 0);
+  close(fileDescriptors[0]);
+  if (error) {
+    close(fileDescriptors[1]);
+    close(fileDescriptors[2]);
+    return error;
+  }
+
+  // The connector waits on the second eventfd and signals the listener on the first.
+  self->eventFd = fileDescriptors[2];
+  self->peerEventFd = fileDescriptors[1];
+  return NDN_ERROR_success;
+#else
+  return NDN_ERROR_ShmTransport_eventfd_is_not_supported;
+#endif
+}
+
+ndn_Error ndn_ShmTransport_send(struct ndn_ShmTransport *self, uint8_t *data, size_t dataLength, int *isSent)
+{
+  *isSent = 0;
+  if (!self->region)
+    return NDN_ERROR_ShmTransport_transport_is_not_open;
+  size_t size = recordSize(dataLength);
+  if (size > self->capacity / 2)
+    return NDN_ERROR_ShmTransport_element_is_too_large_for_the_ring;
+
+  // Only this process changes writePosition, so it doesn't need an atomic load.
+  uint64_t writePosition = self->sendHeader->writePosition;
+  size_t offset = (size_t)(writePosition % self->capacity);
+  size_t toEnd = self->capacity - offset;
+  // A record doesn't wrap, so if it doesn't fit before the end then it also uses the rest of the ring.
+  size_t needed = size > toEnd ? toEnd + size : size;
+  uint64_t readPosition = __atomic_load_n(&self->sendHeader->readPosition, __ATOMIC_SEQ_CST);
+  if (self->capacity - (size_t)(writePosition - readPosition) < needed) {
+    // The ring is full.  Ask the reader to signal when it frees space, then check again in case it just did.
+    __atomic_store_n(&self->sendHeader->writerIsWaiting, 1, __ATOMIC_SEQ_CST);
+    readPosition = __atomic_load_n(&self->sendHeader->readPosition, __ATOMIC_SEQ_CST);
+    if (self->capacity - (size_t)(writePosition - readPosition) < needed)
+      return NDN_ERROR_success;
+  }
+
+  uint64_t previousWritePosition = writePosition;
+  if (size > toEnd) {
+    *(uint32_t *)(self->sendData + offset) = WRAP_RECORD_LENGTH;
+    writePosition += toEnd;
+    offset = 0;
+  }
+  *(uint32_t *)(self->sendData + offset) = (uint32_t)dataLength;
+  ndn_memcpy(self->sendData + offset + 4, data, dataLength);
+  writePosition += size;
+  __atomic_store_n(&self->sendHeader->writePosition, writePosition, __ATOMIC_SEQ_CST);
+
+  // Only signal if the reader already released everything before this record.  Otherwise, it checks for this record
+  // after it calls ndn_ShmTransport_releaseReceived.
+  if (__atomic_load_n(&self->sendHeader->readPosition, __ATOMIC_SEQ_CST) == previousWritePosition)
+    signalEvent(self->peerEventFd);
+
+  *isSent = 1;
+  return NDN_ERROR_success;
+}
+
+ndn_Error ndn_ShmTransport_receive(struct ndn_ShmTransport *self, uint8_t **record, size_t *recordLength)
+{
+  *record = 0;
+  *recordLength = 0;
+  if (!self->region)
+    return NDN_ERROR_success;
+
+  uint64_t writePosition = __atomic_load_n(&self->receiveHeader->writePosition, __ATOMIC_SEQ_CST);
+  while (self->receivePosition != writePosition) {
+    // The peer writes the positions and lengths, so check that each record is inside the ring and was written.
+    size_t available = (size_t)(writePosition - self->receivePosition);
+    size_t offset = (size_t)(self->receivePosition % self->capacity);
+    if (offset > self->capacity - 4 || available > self->capacity)
+      return NDN_ERROR_ShmTransport_invalid_record_in_the_receive_ring;
+    uint32_t length = *(uint32_t *)(self->receiveData + offset);
+    if (length == WRAP_RECORD_LENGTH) {
+      if (self->capacity - offset > available)
+        return NDN_ERROR_ShmTransport_invalid_record_in_the_receive_ring;
+      self->receivePosition += self->capacity - offset;
+      continue;
+    }
+    if (length > self->capacity - offset - 4 || recordSize(length) > available)
+      return NDN_ERROR_ShmTransport_invalid_record_in_the_receive_ring;
+
+    *record = self->receiveData + offset + 4;
+    *recordLength = length;
+    self->receivePosition += recordSize(length);
+    return NDN_ERROR_success;
+  }
+
+  return NDN_ERROR_success;
+}
+
+void ndn_ShmTransport_releaseReceived(struct ndn_ShmTransport *self)
+{
+  if (!self->region)
+    return;
+
+  __atomic_store_n(&self->receiveHeader->readPosition, self->receivePosition, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&self->receiveHeader->writerIsWaiting, __ATOMIC_SEQ_CST)) {
+    __atomic_store_n(&self->receiveHeader->writerIsWaiting, 0, __ATOMIC_SEQ_CST);
+    signalEvent(self->peerEventFd);
+  }
+}
+
+void ndn_ShmTransport_clearEvent(struct ndn_ShmTransport *self)
+{
+  if (self->eventFd < 0)
+    return;
+
+  // eventFd is non-blocking, so this returns EAGAIN if it was not signaled.
+  uint64_t value;
+  while (read(self->eventFd, &value, sizeof(value)) < 0 && errno == EINTR)
+    ;
+}
+
+ndn_Error ndn_ShmTransport_close(struct ndn_ShmTransport *self)
+{
+  if (self->region)
+    munmap(self->region, self->regionLength);
+  if (self->eventFd >= 0)
+    close(self->eventFd);
+  if (self->peerEventFd >= 0)
+    close(self->peerEventFd);
+  ndn_ShmTransport_initialize(self);
+
+  return NDN_ERROR_success;
+}
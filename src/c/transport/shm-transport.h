@@ -0,0 +1,134 @@
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_SHMTRANSPORT_H
+#define NDN_SHMTRANSPORT_H
+
+#include <ndn-cpp/c/common.h>
+#include "../errors.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * An ndn_ShmRingHeader is at the start of each ring in the shared memory.  The positions count all the bytes written
+ * or read since the connection was made, so the ring is empty when they are equal.  The reader and writer fields are
+ * in separate cache lines so that the two processes don't contend for one line.
+ */
+struct ndn_ShmRingHeader {
+  uint64_t writePosition;   /**< Only the writer changes this. */
+  uint8_t padding1[56];
+  uint64_t readPosition;    /**< Only the reader changes this. */
+  uint32_t writerIsWaiting; /**< The writer sets this to 1 when the ring is full, and the reader clears it. */
+  uint8_t padding2[52];
+};
+
+/**
+ * An ndn_ShmTransport sends records through a single-producer single-consumer ring in shared memory and receives
+ * records through a second ring from the peer process.  Each process waits on its own eventfd, which the peer signals
+ * when the receive ring becomes non-empty or when it frees space for a writer which found the send ring full.
+ */
+struct ndn_ShmTransport {
+  uint8_t *region;          /**< The mapped shared memory, or 0 if not connected. */
+  size_t regionLength;
+  size_t capacity;          /**< The number of data bytes in each ring. */
+  struct ndn_ShmRingHeader *receiveHeader;
+  uint8_t *receiveData;
+  uint64_t receivePosition; /**< The read position up to which records were returned by ndn_ShmTransport_receive. */
+  struct ndn_ShmRingHeader *sendHeader;
+  uint8_t *sendData;
+  int eventFd;              /**< The eventfd which this process waits on, or -1 if not connected. */
+  int peerEventFd;          /**< The eventfd which the peer process waits on, or -1 if not connected. */
+};
+
+/**
+ * Initialize the ndn_ShmTransport struct with default values for no connection yet.
+ * @param self A pointer to the ndn_ShmTransport struct.
+ */
+static inline void ndn_ShmTransport_initialize(struct ndn_ShmTransport *self)
+{
+  self->region = 0;
+  self->regionLength = 0;
+  self->capacity = 0;
+  self->receiveHeader = 0;
+  self->receiveData = 0;
+  self->receivePosition = 0;
+  self->sendHeader = 0;
+  self->sendData = 0;
+  self->eventFd = -1;
+  self->peerEventFd = -1;
+}
+
+/**
+ * Listen on the Unix socket file path and block until a peer connects with ndn_ShmTransport_connect.  Then create the
+ * shared memory and eventfds, pass them to the peer, and close the Unix socket.
+ * @param self A pointer to the ndn_ShmTransport struct.
+ * @param filePath The path of the Unix socket file.  This removes an existing file.
+ * @param capacity The number of data bytes in each ring.  This is rounded up to a multiple of 8.  The largest record
+ * is half of the capacity.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error ndn_ShmTransport_listen(struct ndn_ShmTransport *self, char *filePath, size_t capacity);
+
+/**
+ * Connect to the Unix socket file path where the peer called ndn_ShmTransport_listen, and map the shared memory which
+ * the peer passes back.
+ * @param self A pointer to the ndn_ShmTransport struct.
+ * @param filePath The path of the Unix socket file.
+ * @return 0 for success, NDN_ERROR_ShmTransport_invalid_shared_memory_from_the_peer if the capacity from the peer is
+ * not a non-zero multiple of 64 or the shared memory file is too small for the two rings, else an error code.
+ */
+ndn_Error ndn_ShmTransport_connect(struct ndn_ShmTransport *self, char *filePath);
+
+/**
+ * Copy the data as one record into the send ring without blocking, and signal the peer if the ring was empty.
+ * @param self A pointer to the ndn_ShmTransport struct.
+ * @param data A pointer to the buffer of data to send.
+ * @param dataLength The number of bytes in data.
+ * @param isSent Set to 1 if the record was sent, or 0 if the ring is full.  If 0, the peer will signal eventFd when
+ * it frees space.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error ndn_ShmTransport_send(struct ndn_ShmTransport *self, uint8_t *data, size_t dataLength, int *isSent);
+
+/**
+ * Get the next record in the receive ring.  The record stays valid in the shared memory until
+ * ndn_ShmTransport_releaseReceived, so the caller can use it in place.
+ * @param self A pointer to the ndn_ShmTransport struct.
+ * @param record Set to a pointer to the record, or 0 if the receive ring has no more records.
+ * @param recordLength Set to the number of bytes in the record.
+ * @return 0 for success, NDN_ERROR_ShmTransport_invalid_record_in_the_receive_ring if the peer wrote a record length
+ * or position outside the ring, else an error code.  After an error, the caller should close the transport.
+ */
+ndn_Error ndn_ShmTransport_receive(struct ndn_ShmTransport *self, uint8_t **record, size_t *recordLength);
+
+/**
+ * Give the space of the records returned by ndn_ShmTransport_receive back to the peer, and signal the peer if it is
+ * waiting for space.  After this, call ndn_ShmTransport_receive again since the peer doesn't signal for records that
+ * it sends while the receive ring is not empty.
+ * @param self A pointer to the ndn_ShmTransport struct.
+ */
+void ndn_ShmTransport_releaseReceived(struct ndn_ShmTransport *self);
+
+/**
+ * Clear the signal count of eventFd so that it is not readable until the peer signals again.
+ * @param self A pointer to the ndn_ShmTransport struct.
+ */
+void ndn_ShmTransport_clearEvent(struct ndn_ShmTransport *self);
+
+/**
+ * Unmap the shared memory and close the eventfds.
+ * @param self A pointer to the ndn_ShmTransport struct.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error ndn_ShmTransport_close(struct ndn_ShmTransport *self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,17 +4,26 @@
  * See COPYING for copyright and distribution information.
  */
 
+// Define _GNU_SOURCE so that sys/socket.h declares recvmmsg and sendmmsg.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <ndn-cpp/ndn-cpp-config.h>
 #include "socket-transport.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <netdb.h>
 #include <sys/types.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
 #include <arpa/inet.h>
 #include <poll.h>
+#include <errno.h>
 #include "../util/ndn_memory.h"
 
 ndn_Error ndn_SocketTransport_connect(struct ndn_SocketTransport *self, ndn_SocketType socketType, char *host, unsigned short port)
@@ -24,6 +33,27 @@ ndn_Error ndn_SocketTransport_connect(struct ndn_SocketTransport *self, ndn_Sock
     self->socketDescriptor = -1;
   }
   
+  if (socketType == SOCKET_UNIX) {
+    struct sockaddr_un address;
+    size_t pathLength = strlen(host);
+    if (pathLength >= sizeof(address.sun_path))
+      return NDN_ERROR_SocketTransport_cannot_connect_to_socket;
+    ndn_memset((uint8_t *)&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    ndn_memcpy((uint8_t *)address.sun_path, (uint8_t *)host, pathLength);
+    
+    int socketDescriptor;
+    if ((socketDescriptor = socket(AF_UNIX, SOCK_STREAM, 0)) == -1)
+      return NDN_ERROR_SocketTransport_cannot_connect_to_socket;
+    if (connect(socketDescriptor, (struct sockaddr *)&address, sizeof(address)) == -1) {
+      close(socketDescriptor);
+      return NDN_ERROR_SocketTransport_cannot_connect_to_socket;
+    }
+    
+    self->socketDescriptor = socketDescriptor;
+    return NDN_ERROR_success;
+  }
+  
   struct addrinfo hints;
   ndn_memset((uint8_t *)&hints, 0, sizeof(hints));
   hints.ai_family = AF_UNSPEC;
@@ -79,13 +109,98 @@ ndn_Error ndn_SocketTransport_send(struct ndn_SocketTransport *self, uint8_t *da
     if (nBytes >= dataLength)
       break;
     
-    // Send more.
+    // Send the rest.
+    data += nBytes;
     dataLength -= nBytes;
   }
 
   return NDN_ERROR_success;  
 }
 
+ndn_Error ndn_SocketTransport_sendBuffersNonBlocking
+  (struct ndn_SocketTransport *self, struct ndn_Blob *buffers, size_t nBuffers, size_t *nBytesSent)
+{
+  *nBytesSent = 0;
+  if (self->socketDescriptor < 0)
+    return NDN_ERROR_SocketTransport_socket_is_not_open;
+
+  // Gather the buffers so that the kernel copies them all in one call.
+  struct iovec ioVector[ndn_SocketTransport_MAX_SEND_BUFFERS];
+  if (nBuffers > ndn_SocketTransport_MAX_SEND_BUFFERS)
+    nBuffers = ndn_SocketTransport_MAX_SEND_BUFFERS;
+  size_t i;
+  for (i = 0; i < nBuffers; ++i) {
+    ioVector[i].iov_base = buffers[i].value;
+    ioVector[i].iov_len = buffers[i].length;
+  }
+  
+  struct msghdr message;
+  ndn_memset((uint8_t *)&message, 0, sizeof(message));
+  message.msg_iov = ioVector;
+  message.msg_iovlen = nBuffers;
+
+  ssize_t nBytes;
+  while ((nBytes = sendmsg(self->socketDescriptor, &message, MSG_DONTWAIT)) < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+      // The socket send buffer is full.
+      return NDN_ERROR_success;
+    if (errno != EINTR)
+      return NDN_ERROR_SocketTransport_error_in_send;
+  }
+
+  *nBytesSent = (size_t)nBytes;
+
+  return NDN_ERROR_success;
+}
+
+ndn_Error ndn_SocketTransport_sendDatagramsNonBlocking
+  (struct ndn_SocketTransport *self, struct ndn_Blob *datagrams, size_t nDatagrams, size_t *nDatagramsSent)
+{
+  *nDatagramsSent = 0;
+  if (self->socketDescriptor < 0)
+    return NDN_ERROR_SocketTransport_socket_is_not_open;
+  if (nDatagrams > ndn_SocketTransport_MAX_SEND_BUFFERS)
+    nDatagrams = ndn_SocketTransport_MAX_SEND_BUFFERS;
+  
+#if NDN_CPP_HAVE_SENDMMSG
+  struct iovec ioVectors[ndn_SocketTransport_MAX_SEND_BUFFERS];
+  struct mmsghdr messages[ndn_SocketTransport_MAX_SEND_BUFFERS];
+  ndn_memset((uint8_t *)messages, 0, nDatagrams * sizeof(messages[0]));
+  size_t i;
+  for (i = 0; i < nDatagrams; ++i) {
+    ioVectors[i].iov_base = datagrams[i].value;
+    ioVectors[i].iov_len = datagrams[i].length;
+    messages[i].msg_hdr.msg_iov = &ioVectors[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+  }
+  
+  int nSent;
+  while ((nSent = sendmmsg(self->socketDescriptor, messages, nDatagrams, MSG_DONTWAIT)) < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+      // The socket send buffer is full.
+      return NDN_ERROR_success;
+    if (errno != EINTR)
+      return NDN_ERROR_SocketTransport_error_in_send;
+  }
+  *nDatagramsSent = (size_t)nSent;
+#else
+  while (*nDatagramsSent < nDatagrams) {
+    struct ndn_Blob *datagram = &datagrams[*nDatagramsSent];
+    if (send(self->socketDescriptor, datagram->value, datagram->length, MSG_DONTWAIT) < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        // The socket send buffer is full.
+        return NDN_ERROR_success;
+      return NDN_ERROR_SocketTransport_error_in_send;
+    }
+    ++*nDatagramsSent;
+  }
+#endif
+  
+  return NDN_ERROR_success;
+}
+
 ndn_Error ndn_SocketTransport_receiveIsReady(struct ndn_SocketTransport *self, int *receiveIsReady)
 {
   // Default to not ready.
@@ -129,6 +244,115 @@ ndn_Error ndn_SocketTransport_receive
   return NDN_ERROR_success;  
 }
 
+ndn_Error ndn_SocketTransport_receiveNonBlocking
+  (struct ndn_SocketTransport *self, uint8_t *buffer, size_t bufferLength, size_t *nBytesOut)
+{
+  *nBytesOut = 0;
+  if (self->socketDescriptor < 0)
+    // The socket is not open.  Just silently return.
+    return NDN_ERROR_success;
+
+  int nBytes;
+  while ((nBytes = recv(self->socketDescriptor, buffer, bufferLength, MSG_DONTWAIT)) == -1) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+      // No data is ready.
+      return NDN_ERROR_success;
+    if (errno != EINTR)
+      return NDN_ERROR_SocketTransport_error_in_recv;
+  }
+
+  if (nBytes == 0 && bufferLength > 0) {
+    // For a stream socket, this is the end of the stream.  For a datagram socket, this is an empty datagram.
+    int socketType;
+    socklen_t optionLength = sizeof(socketType);
+    if (getsockopt(self->socketDescriptor, SOL_SOCKET, SO_TYPE, &socketType, &optionLength) == 0 &&
+        socketType == SOCK_STREAM)
+      return NDN_ERROR_SocketTransport_connection_closed_by_the_peer;
+  }
+
+  *nBytesOut = (size_t)nBytes;
+
+  return NDN_ERROR_success;
+}
+
+ndn_Error ndn_SocketTransport_receiveDatagramsNonBlocking
+  (struct ndn_SocketTransport *self, uint8_t **buffers, size_t bufferLength, size_t nBuffers, size_t *datagramLengths,
+   size_t *nDatagrams)
+{
+  *nDatagrams = 0;
+  if (self->socketDescriptor < 0)
+    // The socket is not open.  Just silently return.
+    return NDN_ERROR_success;
+  if (nBuffers > ndn_SocketTransport_MAX_RECEIVE_BUFFERS)
+    nBuffers = ndn_SocketTransport_MAX_RECEIVE_BUFFERS;
+
+  struct iovec ioVectors[ndn_SocketTransport_MAX_RECEIVE_BUFFERS];
+  size_t i;
+  for (i = 0; i < nBuffers; ++i) {
+    ioVectors[i].iov_base = buffers[i];
+    ioVectors[i].iov_len = bufferLength;
+  }
+  
+#if NDN_CPP_HAVE_RECVMMSG
+  struct mmsghdr messages[ndn_SocketTransport_MAX_RECEIVE_BUFFERS];
+  ndn_memset((uint8_t *)messages, 0, nBuffers * sizeof(messages[0]));
+  for (i = 0; i < nBuffers; ++i) {
+    messages[i].msg_hdr.msg_iov = &ioVectors[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+  }
+  
+  int nReceived;
+  while ((nReceived = recvmmsg(self->socketDescriptor, messages, nBuffers, MSG_DONTWAIT, 0)) < 0) {
+    if (errno == EAGAIN || errno == EWOULDBLOCK)
+      // No data is ready.
+      return NDN_ERROR_success;
+    if (errno != EINTR)
+      return NDN_ERROR_SocketTransport_error_in_recv;
+  }
+  
+  for (i = 0; i < (size_t)nReceived; ++i)
+    datagramLengths[i] = (messages[i].msg_hdr.msg_flags & MSG_TRUNC) ? 0 : (size_t)messages[i].msg_len;
+  *nDatagrams = (size_t)nReceived;
+#else
+  while (*nDatagrams < nBuffers) {
+    struct msghdr message;
+    ndn_memset((uint8_t *)&message, 0, sizeof(message));
+    message.msg_iov = &ioVectors[*nDatagrams];
+    message.msg_iovlen = 1;
+    
+    ssize_t nBytes = recvmsg(self->socketDescriptor, &message, MSG_DONTWAIT);
+    if (nBytes < 0) {
+      if (errno == EINTR)
+        continue;
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+        // No more data is ready.
+        return NDN_ERROR_success;
+      return NDN_ERROR_SocketTransport_error_in_recv;
+    }
+    
+    datagramLengths[*nDatagrams] = (message.msg_flags & MSG_TRUNC) ? 0 : (size_t)nBytes;
+    ++*nDatagrams;
+  }
+#endif
+
+  return NDN_ERROR_success;
+}
+
+ndn_Error ndn_SocketTransport_getReceiveBufferSize(struct ndn_SocketTransport *self, size_t *receiveBufferSize)
+{
+  if (self->socketDescriptor < 0)
+    return NDN_ERROR_SocketTransport_socket_is_not_open;
+
+  int size;
+  socklen_t sizeLength = sizeof(size);
+  if (getsockopt(self->socketDescriptor, SOL_SOCKET, SO_RCVBUF, &size, &sizeLength) != 0)
+    return NDN_ERROR_SocketTransport_error_in_getsockopt;
+
+  *receiveBufferSize = (size_t)size;
+
+  return NDN_ERROR_success;
+}
+
 ndn_Error ndn_SocketTransport_close(struct ndn_SocketTransport *self)
 {
   if (self->socketDescriptor < 0)
@@ -10,6 +10,7 @@
 #include <sys/socket.h>
 #include <ndn-cpp/c/common.h>
 #include "../errors.h"
+#include "../util/blob.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -17,7 +18,8 @@ extern "C" {
 
 typedef enum {
   SOCKET_TCP,
-  SOCKET_UDP
+  SOCKET_UDP,
+  SOCKET_UNIX
 } ndn_SocketType;
   
 struct ndn_SocketTransport {
@@ -34,11 +36,11 @@ static inline void ndn_SocketTransport_initialize(struct ndn_SocketTransport *se
 }
 
 /**
- * Connect with TCP or UDP to the host:port.
+ * Connect with TCP or UDP to the host:port, or with a Unix domain stream socket to the socket file path.
  * @param self A pointer to the ndn_SocketTransport struct.
- * @param socketType SOCKET_TCP or SOCKET_UDP.
- * @param host The host to connect to.
- * @param port The port to connect to.
+ * @param socketType SOCKET_TCP, SOCKET_UDP or SOCKET_UNIX.
+ * @param host The host to connect to, or for SOCKET_UNIX the path of the socket file.
+ * @param port The port to connect to.  This is ignored for SOCKET_UNIX.
  * @return 0 for success, else an error code.
  */
 ndn_Error ndn_SocketTransport_connect(struct ndn_SocketTransport *self, ndn_SocketType socketType, char *host, unsigned short port);
@@ -52,6 +54,37 @@ ndn_Error ndn_SocketTransport_connect(struct ndn_SocketTransport *self, ndn_Sock
  */
 ndn_Error ndn_SocketTransport_send(struct ndn_SocketTransport *self, uint8_t *data, size_t dataLength);
 
+/**
+ * The maximum number of buffers which ndn_SocketTransport_sendBuffersNonBlocking sends in one call.
+ */
+#define ndn_SocketTransport_MAX_SEND_BUFFERS 64
+
+/**
+ * Send the data in the buffers to the socket in one call to sendmsg, without blocking.  This sends at most the first
+ * ndn_SocketTransport_MAX_SEND_BUFFERS buffers.
+ * @param self A pointer to the ndn_SocketTransport struct.
+ * @param buffers An array of ndn_Blob with the data to send, in order.
+ * @param nBuffers The number of entries in buffers.
+ * @param nBytesSent Return the number of bytes sent.  This can be less than the total length of the buffers (or 0)
+ * if the socket send buffer is full.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error ndn_SocketTransport_sendBuffersNonBlocking
+  (struct ndn_SocketTransport *self, struct ndn_Blob *buffers, size_t nBuffers, size_t *nBytesSent);
+
+/**
+ * Send each buffer as a separate datagram without blocking, in one call to sendmmsg if available.  This sends at most
+ * the first ndn_SocketTransport_MAX_SEND_BUFFERS datagrams.
+ * @param self A pointer to the ndn_SocketTransport struct.
+ * @param datagrams An array of ndn_Blob with the datagrams to send, in order.
+ * @param nDatagrams The number of entries in datagrams.
+ * @param nDatagramsSent Return the number of datagrams sent.  This can be less than nDatagrams (or 0) if the socket
+ * send buffer is full.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error ndn_SocketTransport_sendDatagramsNonBlocking
+  (struct ndn_SocketTransport *self, struct ndn_Blob *datagrams, size_t nDatagrams, size_t *nDatagramsSent);
+
 /**
  * Check if there is data ready on the socket to be received with ndn_SocketTransport_receive.
  * This does not block, and returns immediately.
@@ -73,6 +106,50 @@ ndn_Error ndn_SocketTransport_receiveIsReady(struct ndn_SocketTransport *self, i
 ndn_Error ndn_SocketTransport_receive
   (struct ndn_SocketTransport *self, uint8_t *buffer, size_t bufferLength, size_t *nBytes);
 
+/**
+ * Receive data from the socket without blocking.  You don't need to call ndn_SocketTransport_receiveIsReady first.
+ * To drain all the data which is ready, call this repeatedly until nBytes is 0.
+ * @param self A pointer to the ndn_SocketTransport struct.
+ * @param buffer A pointer to the buffer to receive the data.
+ * @param bufferLength The maximum length of buffer.
+ * @param nBytes Return the number of bytes received into buffer.  This is 0 if no data is ready or if the socket is
+ * not open.
+ * @return 0 for success, NDN_ERROR_SocketTransport_connection_closed_by_the_peer if this is a stream socket and the
+ * peer closed the connection, else an error code.
+ */
+ndn_Error ndn_SocketTransport_receiveNonBlocking
+  (struct ndn_SocketTransport *self, uint8_t *buffer, size_t bufferLength, size_t *nBytes);
+
+/**
+ * The maximum number of buffers which ndn_SocketTransport_receiveDatagramsNonBlocking fills in one call.
+ */
+#define ndn_SocketTransport_MAX_RECEIVE_BUFFERS 64
+
+/**
+ * Receive datagrams from the socket without blocking, each into its own buffer, in one call to recvmmsg if available.
+ * This fills at most the first ndn_SocketTransport_MAX_RECEIVE_BUFFERS buffers.
+ * @param self A pointer to the ndn_SocketTransport struct.
+ * @param buffers An array of pointers to the buffers to receive the datagrams.
+ * @param bufferLength The length of each buffer.
+ * @param nBuffers The number of entries in buffers.
+ * @param datagramLengths An array of nBuffers entries.  Return the number of bytes received into each buffer.  If a
+ * datagram was longer than bufferLength, its length is set to 0 so that the caller discards it.
+ * @param nDatagrams Return the number of datagrams received.  This is 0 if no data is ready or if the socket is not
+ * open.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error ndn_SocketTransport_receiveDatagramsNonBlocking
+  (struct ndn_SocketTransport *self, uint8_t **buffers, size_t bufferLength, size_t nBuffers, size_t *datagramLengths,
+   size_t *nDatagrams);
+
+/**
+ * Get the size of the receive buffer which the operating system allocated for the socket (SO_RCVBUF).
+ * @param self A pointer to the ndn_SocketTransport struct.
+ * @param receiveBufferSize Return the size in bytes.
+ * @return 0 for success, else an error code.
+ */
+ndn_Error ndn_SocketTransport_getReceiveBufferSize(struct ndn_SocketTransport *self, size_t *receiveBufferSize);
+
 /**
  * Close the socket.
  * @param self A pointer to the ndn_SocketTransport struct.
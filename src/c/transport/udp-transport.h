@@ -50,6 +50,22 @@ static inline ndn_Error ndn_UdpTransport_send(struct ndn_UdpTransport *self, uin
   return ndn_SocketTransport_send(&self->base, data, dataLength);
 }
 
+/**
+ * Send each buffer as a separate datagram without blocking, in one system call if possible.  This sends at most the
+ * first ndn_SocketTransport_MAX_SEND_BUFFERS datagrams.
+ * @param self A pointer to the ndn_UdpTransport struct.
+ * @param datagrams An array of ndn_Blob with the datagrams to send, in order.
+ * @param nDatagrams The number of entries in datagrams.
+ * @param nDatagramsSent Return the number of datagrams sent.  This can be less than nDatagrams (or 0) if the socket
+ * send buffer is full.
+ * @return 0 for success, else an error code.
+ */
+static inline ndn_Error ndn_UdpTransport_sendDatagramsNonBlocking
+  (struct ndn_UdpTransport *self, struct ndn_Blob *datagrams, size_t nDatagrams, size_t *nDatagramsSent)
+{
+  return ndn_SocketTransport_sendDatagramsNonBlocking(&self->base, datagrams, nDatagrams, nDatagramsSent);
+}
+
 /**
  * Check if there is data ready on the socket to be received with ndn_UdpTransport_receive.
  * This does not block, and returns immediately.
@@ -77,6 +93,54 @@ static inline ndn_Error ndn_UdpTransport_receive
   return ndn_SocketTransport_receive(&self->base, buffer, bufferLength, nBytes);
 }
 
+/**
+ * Receive data from the socket without blocking.  You don't need to call ndn_UdpTransport_receiveIsReady first.
+ * To drain all the data which is ready, call this repeatedly until nBytes is 0.
+ * @param self A pointer to the ndn_UdpTransport struct.
+ * @param buffer A pointer to the buffer to receive the data.
+ * @param bufferLength The maximum length of buffer.
+ * @param nBytes Return the number of bytes received into buffer.  This is 0 if no data is ready, if the datagram is
+ * empty, or if the socket is not open.
+ * @return 0 for success, else an error code.
+ */
+static inline ndn_Error ndn_UdpTransport_receiveNonBlocking
+  (struct ndn_UdpTransport *self, uint8_t *buffer, size_t bufferLength, size_t *nBytes)
+{
+  return ndn_SocketTransport_receiveNonBlocking(&self->base, buffer, bufferLength, nBytes);
+}
+
+/**
+ * Receive datagrams from the socket without blocking, each into its own buffer, in one system call if possible.
+ * This fills at most the first ndn_SocketTransport_MAX_RECEIVE_BUFFERS buffers.
+ * @param self A pointer to the ndn_UdpTransport struct.
+ * @param buffers An array of pointers to the buffers to receive the datagrams.
+ * @param bufferLength The length of each buffer.
+ * @param nBuffers The number of entries in buffers.
+ * @param datagramLengths An array of nBuffers entries.  Return the number of bytes received into each buffer.  If a
+ * datagram was longer than bufferLength, its length is set to 0 so that the caller discards it.
+ * @param nDatagrams Return the number of datagrams received.  This is 0 if no data is ready or if the socket is not
+ * open.
+ * @return 0 for success, else an error code.
+ */
+static inline ndn_Error ndn_UdpTransport_receiveDatagramsNonBlocking
+  (struct ndn_UdpTransport *self, uint8_t **buffers, size_t bufferLength, size_t nBuffers, size_t *datagramLengths,
+   size_t *nDatagrams)
+{
+  return ndn_SocketTransport_receiveDatagramsNonBlocking
+    (&self->base, buffers, bufferLength, nBuffers, datagramLengths, nDatagrams);
+}
+
+/**
+ * Get the size of the receive buffer which the operating system allocated for the socket (SO_RCVBUF).
+ * @param self A pointer to the ndn_UdpTransport struct.
+ * @param receiveBufferSize Return the size in bytes.
+ * @return 0 for success, else an error code.
+ */
+static inline ndn_Error ndn_UdpTransport_getReceiveBufferSize(struct ndn_UdpTransport *self, size_t *receiveBufferSize)
+{
+  return ndn_SocketTransport_getReceiveBufferSize(&self->base, receiveBufferSize);
+}
+
 /**
  * Close the socket.
  * @param self A pointer to the ndn_UdpTransport struct.
@@ -18,9 +18,15 @@ toHex(const vector<uint8_t>& array)
   if (!&array)
     return "";
   
+  return toHex(array.size() > 0 ? &array[0] : 0, array.size());
+}
+
+string 
+toHex(const uint8_t *array, size_t arrayLength) 
+{
   ostringstream result;
   result.flags(ios::hex | ios::uppercase);
-  for (size_t i = 0; i < array.size(); ++i) {
+  for (size_t i = 0; i < arrayLength; ++i) {
     uint8_t x = array[i];
     if (x < 16)
       result << '0';
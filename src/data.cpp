@@ -17,6 +17,12 @@ namespace ndn {
 Signature::~Signature()
 {
 }
+
+void 
+Signature::set(const struct ndn_Signature& signatureStruct, const Blob& buffer)
+{
+  set(signatureStruct);
+}
   
 void 
 MetaInfo::get(struct ndn_MetaInfo& metaInfoStruct) const 
@@ -28,12 +34,12 @@ MetaInfo::get(struct ndn_MetaInfo& metaInfoStruct) const
 }
 
 void 
-MetaInfo::set(const struct ndn_MetaInfo& metaInfoStruct)
+MetaInfo::set(const struct ndn_MetaInfo& metaInfoStruct, const Blob& buffer)
 {
   timestampMilliseconds_ = metaInfoStruct.timestampMilliseconds;
   type_ = metaInfoStruct.type;
   freshnessSeconds_ = metaInfoStruct.freshnessSeconds;
-  finalBlockID_ = Name::Component(Blob(metaInfoStruct.finalBlockID.value));
+  finalBlockID_ = Name::Component(Blob(metaInfoStruct.finalBlockID.value, buffer));
 }
 
 Data::Data()
@@ -82,12 +88,12 @@ Data::get(struct ndn_Data& dataStruct) const
 }
 
 void 
-Data::set(const struct ndn_Data& dataStruct)
+Data::set(const struct ndn_Data& dataStruct, const Blob& buffer)
 {
-  signature_->set(dataStruct.signature);
+  signature_->set(dataStruct.signature, buffer);
   name_.set(dataStruct.name);
-  metaInfo_.set(dataStruct.metaInfo);
-  content_ = Blob(dataStruct.content);
+  metaInfo_.set(dataStruct.metaInfo, buffer);
+  content_ = Blob(dataStruct.content, buffer);
 
   onChanged();
 }
@@ -116,13 +122,20 @@ Data::wireEncode(WireFormat& wireFormat) const
 
 void 
 Data::wireDecode(const uint8_t* input, size_t inputLength, WireFormat& wireFormat) 
+{
+  // Copy the input once so that the decoded fields can share it.
+  wireDecode(Blob(input, inputLength), wireFormat);
+}
+
+void 
+Data::wireDecode(const Blob& input, WireFormat& wireFormat) 
 {
   size_t signedPortionBeginOffset, signedPortionEndOffset;
-  wireFormat.decodeData(*this, input, inputLength, &signedPortionBeginOffset, &signedPortionEndOffset);
+  wireFormat.decodeData(*this, input, &signedPortionBeginOffset, &signedPortionEndOffset);
   
   if (&wireFormat == WireFormat::getDefaultWireFormat())
     // This is the default wire encoding.
-    defaultWireEncoding_ = SignedBlob(input, inputLength, signedPortionBeginOffset, signedPortionEndOffset);
+    defaultWireEncoding_ = SignedBlob(input, signedPortionBeginOffset, signedPortionEndOffset);
   else
     defaultWireEncoding_ = SignedBlob();
 }
@@ -25,7 +25,7 @@ public:
    * @param initialLength The initial size of the output.  If omitted, use 16.
    */
   BinaryXmlEncoder(size_t initialLength = 16) 
-  : output_(16)
+  : output_(initialLength)
   {
     ndn_BinaryXmlEncoder_initialize(this, &output_);
   }
@@ -38,7 +38,8 @@ BinaryXmlWireFormat::encodeInterest(const Interest& interest)
      excludeEntries, sizeof(excludeEntries) / sizeof(excludeEntries[0]));
   interest.get(interestStruct);
 
-  BinaryXmlEncoder encoder;
+  // Compute the exact encoding length first so that the encoder allocates the output once.
+  BinaryXmlEncoder encoder(ndn_getBinaryXmlInterestEncodingLength(&interestStruct));
   ndn_Error error;
   if ((error = ndn_encodeBinaryXmlInterest(&interestStruct, &encoder)))
     throw runtime_error(ndn_getErrorString(error));
@@ -46,8 +47,15 @@ BinaryXmlWireFormat::encodeInterest(const Interest& interest)
   return encoder.getOutput();
 }
 
-void 
-BinaryXmlWireFormat::decodeInterest(Interest& interest, const uint8_t *input, size_t inputLength)
+/**
+ * Decode input as an interest in binary XML and set the fields of the interest object.
+ * @param interest The Interest object whose fields are updated.
+ * @param input A pointer to the input buffer to decode.
+ * @param inputLength The number of bytes in input.
+ * @param buffer If input is the byte array of this Blob, the fields share it instead of copying.  If null, copy.
+ */
+static void
+decodeInterestFromBuffer(Interest& interest, const uint8_t *input, size_t inputLength, const Blob& buffer)
 {
   struct ndn_NameComponent nameComponents[100];
   struct ndn_ExcludeEntry excludeEntries[100];
@@ -61,7 +69,19 @@ BinaryXmlWireFormat::decodeInterest(Interest& interest, const uint8_t *input, si
   if ((error = ndn_decodeBinaryXmlInterest(&interestStruct, &decoder)))
     throw runtime_error(ndn_getErrorString(error));
 
-  interest.set(interestStruct);
+  interest.set(interestStruct, buffer);
+}
+
+void 
+BinaryXmlWireFormat::decodeInterest(Interest& interest, const uint8_t *input, size_t inputLength)
+{
+  decodeInterestFromBuffer(interest, input, inputLength, Blob());
+}
+
+void 
+BinaryXmlWireFormat::decodeInterest(Interest& interest, const Blob& input)
+{
+  decodeInterestFromBuffer(interest, input.buf(), input.size(), input);
 }
 
 Blob 
@@ -75,7 +95,8 @@ BinaryXmlWireFormat::encodeData(const Data& data, size_t *signedPortionBeginOffs
      keyNameComponents, sizeof(keyNameComponents) / sizeof(keyNameComponents[0]));
   data.get(dataStruct);
 
-  BinaryXmlEncoder encoder(1500);
+  // Compute the exact encoding length first so that the encoder allocates the output once.
+  BinaryXmlEncoder encoder(ndn_getBinaryXmlDataEncodingLength(&dataStruct));
   ndn_Error error;
   if ((error = ndn_encodeBinaryXmlData(&dataStruct, signedPortionBeginOffset, signedPortionEndOffset, &encoder)))
     throw runtime_error(ndn_getErrorString(error));
@@ -83,9 +104,19 @@ BinaryXmlWireFormat::encodeData(const Data& data, size_t *signedPortionBeginOffs
   return encoder.getOutput();
 }
 
-void 
-BinaryXmlWireFormat::decodeData
-  (Data& data, const uint8_t *input, size_t inputLength, size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset)
+/**
+ * Decode input as a data packet in binary XML and set the fields in the data object.
+ * @param data The Data object whose fields are updated.
+ * @param input A pointer to the input buffer to decode.
+ * @param inputLength The number of bytes in input.
+ * @param buffer If input is the byte array of this Blob, the fields share it instead of copying.  If null, copy.
+ * @param signedPortionBeginOffset Return the offset in the input buffer of the beginning of the signed portion.
+ * @param signedPortionEndOffset Return the offset in the input buffer of the end of the signed portion.
+ */
+static void
+decodeDataFromBuffer
+  (Data& data, const uint8_t *input, size_t inputLength, const Blob& buffer, size_t *signedPortionBeginOffset, 
+   size_t *signedPortionEndOffset)
 {
   struct ndn_NameComponent nameComponents[100];
   struct ndn_NameComponent keyNameComponents[100];
@@ -99,7 +130,21 @@ BinaryXmlWireFormat::decodeData
   if ((error = ndn_decodeBinaryXmlData(&dataStruct, signedPortionBeginOffset, signedPortionEndOffset, &decoder)))
     throw runtime_error(ndn_getErrorString(error));
 
-  data.set(dataStruct);
+  data.set(dataStruct, buffer);
+}
+
+void 
+BinaryXmlWireFormat::decodeData
+  (Data& data, const uint8_t *input, size_t inputLength, size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset)
+{
+  decodeDataFromBuffer(data, input, inputLength, Blob(), signedPortionBeginOffset, signedPortionEndOffset);
+}
+
+void 
+BinaryXmlWireFormat::decodeData
+  (Data& data, const Blob& input, size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset)
+{
+  decodeDataFromBuffer(data, input.buf(), input.size(), input, signedPortionBeginOffset, signedPortionEndOffset);
 }
 
 Blob 
@@ -111,7 +156,8 @@ BinaryXmlWireFormat::encodeForwardingEntry(const ForwardingEntry& forwardingEntr
     (&forwardingEntryStruct, prefixNameComponents, sizeof(prefixNameComponents) / sizeof(prefixNameComponents[0]));
   forwardingEntry.get(forwardingEntryStruct);
 
-  BinaryXmlEncoder encoder;
+  // Compute the exact encoding length first so that the encoder allocates the output once.
+  BinaryXmlEncoder encoder(ndn_getBinaryXmlForwardingEntryEncodingLength(&forwardingEntryStruct));
   ndn_Error error;
   if ((error = ndn_encodeBinaryXmlForwardingEntry(&forwardingEntryStruct, &encoder)))
     throw runtime_error(ndn_getErrorString(error));
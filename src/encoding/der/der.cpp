@@ -220,7 +220,7 @@ DerComplex::getRaw()
   DerNodePtrList::iterator it = nodeList_.begin();
   for (; it != nodeList_.end(); it++) {
     Blob childBlob = (*it)->getRaw();
-    blob->insert(blob->end(), childBlob->begin(), childBlob->end());
+    blob->insert(blob->end(), childBlob.buf(), childBlob.buf() + childBlob.size());
   }
   return blob;
 }
@@ -41,6 +41,12 @@ WireFormat::decodeInterest(Interest& interest, const uint8_t *input, size_t inpu
   throw logic_error("unimplemented");
 }
 
+void 
+WireFormat::decodeInterest(Interest& interest, const Blob& input) 
+{
+  decodeInterest(interest, input.buf(), input.size());
+}
+
 Blob 
 WireFormat::encodeData(const Data& data, size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset) 
 {
@@ -54,6 +60,13 @@ WireFormat::decodeData
   throw logic_error("unimplemented");
 }
 
+void 
+WireFormat::decodeData
+  (Data& data, const Blob& input, size_t *signedPortionBeginOffset, size_t *signedPortionEndOffset) 
+{
+  decodeData(data, input.buf(), input.size(), signedPortionBeginOffset, signedPortionEndOffset);
+}
+
 Blob 
 WireFormat::encodeForwardingEntry(const ForwardingEntry& forwardingEntry) 
 {
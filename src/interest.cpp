@@ -34,14 +34,14 @@ Exclude::get(struct ndn_Exclude& excludeStruct) const
 }
 
 void 
-Exclude::set(const struct ndn_Exclude& excludeStruct)
+Exclude::set(const struct ndn_Exclude& excludeStruct, const Blob& buffer)
 {
   entries_.clear();
   for (size_t i = 0; i < excludeStruct.nEntries; ++i) {
     ndn_ExcludeEntry *entry = &excludeStruct.entries[i];
     
     if (entry->type == ndn_Exclude_COMPONENT)
-      appendComponent(entry->component.value.value, entry->component.value.length);
+      appendComponent(Blob(entry->component.value, buffer));
     else if (entry->type == ndn_Exclude_ANY)
       appendAny();
     else
@@ -63,27 +63,27 @@ Exclude::toUri() const
     if (entries_[i].getType() == ndn_Exclude_ANY)
       result << "*";
     else
-      Name::toEscapedString(*entries_[i].getComponent().getValue(), result);
+      entries_[i].getComponent().toEscapedString(result);
   }
   
   return result.str();  
 }
 
 void 
-Interest::set(const struct ndn_Interest& interestStruct) 
+Interest::set(const struct ndn_Interest& interestStruct, const Blob& buffer) 
 {
   name_.set(interestStruct.name);
   minSuffixComponents_ = interestStruct.minSuffixComponents;
   maxSuffixComponents_ = interestStruct.maxSuffixComponents;
   
-  publisherPublicKeyDigest_.set(interestStruct.publisherPublicKeyDigest);
+  publisherPublicKeyDigest_.set(interestStruct.publisherPublicKeyDigest, buffer);
   
-  exclude_.set(interestStruct.exclude);
+  exclude_.set(interestStruct.exclude, buffer);
   childSelector_ = interestStruct.childSelector;
   answerOriginKind_ = interestStruct.answerOriginKind;
   scope_ = interestStruct.scope;
   interestLifetimeMilliseconds_ = interestStruct.interestLifetimeMilliseconds;
-  nonce_ = Blob(interestStruct.nonce);
+  nonce_ = Blob(interestStruct.nonce, buffer);
 }
 
 void 
@@ -120,11 +120,13 @@ Interest::toUri() const
     selectors << "&ndn.InterestLifetime=" << interestLifetimeMilliseconds_;
   if (publisherPublicKeyDigest_.getPublisherPublicKeyDigest().size() > 0) {
     selectors << "&ndn.PublisherPublicKeyDigest=";
-    Name::toEscapedString(*publisherPublicKeyDigest_.getPublisherPublicKeyDigest(), selectors);
+    Name::toEscapedString
+      (publisherPublicKeyDigest_.getPublisherPublicKeyDigest().buf(), 
+       publisherPublicKeyDigest_.getPublisherPublicKeyDigest().size(), selectors);
   }
   if (nonce_.size() > 0) {
     selectors << "&ndn.Nonce=";
-    Name::toEscapedString(*nonce_, selectors);
+    Name::toEscapedString(nonce_.buf(), nonce_.size(), selectors);
   }
   if (exclude_.size() > 0)
     selectors << "&ndn.Exclude=" << exclude_.toUri();
@@ -23,10 +23,10 @@ KeyLocator::get(struct ndn_KeyLocator& keyLocatorStruct) const
 }
 
 void 
-KeyLocator::set(const struct ndn_KeyLocator& keyLocatorStruct)
+KeyLocator::set(const struct ndn_KeyLocator& keyLocatorStruct, const Blob& buffer)
 {
   type_ = keyLocatorStruct.type;
-  keyData_ = Blob(keyLocatorStruct.keyData);
+  keyData_ = Blob(keyLocatorStruct.keyData, buffer);
   if (keyLocatorStruct.type == ndn_KeyLocatorType_KEYNAME) {
     keyName_.set(keyLocatorStruct.keyName);
     keyNameType_ = keyLocatorStruct.keyNameType;
@@ -17,51 +17,89 @@ using namespace std;
 
 namespace ndn {
 
-static const char *WHITESPACE_CHARS = " \n\r\t";
+/**
+ * The smallest byte array which Name::append allocates for the component values.
+ */
+static const size_t MIN_BUFFER_LENGTH = 64;
 
 /**
- * Modify str in place to erase whitespace on the left.
- * @param str
+ * The hash code of the empty name, which starts the hash code of every prefix.
  */
-static inline void 
-trimLeft(string& str)
+static const uint64_t EMPTY_NAME_HASH = 0x9e3779b97f4a7c15ULL;
+
+/**
+ * Mix the bits of h so that each input bit affects each output bit.  This is the finalizer of MurmurHash3.
+ */
+static inline uint64_t
+mixHash(uint64_t h)
 {
-  size_t found = str.find_first_not_of(WHITESPACE_CHARS);
-  if (found != string::npos) {
-    if (found > 0)
-      str.erase(0, found);
-  }
-  else
-    // All whitespace
-    str.clear();    
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
 }
 
 /**
- * Modify str in place to erase whitespace on the right.
- * @param str
+ * Compute a 64-bit hash code of the value, reading it a word at a time.  The hash code includes the length so that
+ * values which differ only by trailing zero bytes have different hash codes.
+ * @param value Pointer to the value byte array.
+ * @param valueLength Length of value.
+ * @return The hash code.
  */
-static inline void 
-trimRight(string& str)
+static uint64_t
+hashValue(const uint8_t *value, size_t valueLength)
 {
-  size_t found = str.find_last_not_of(WHITESPACE_CHARS);
-  if (found != string::npos) {
-    if (found + 1 < str.size())
-      str.erase(found + 1);
+  uint64_t h = (valueLength + 1) * 0x9e3779b97f4a7c15ULL;
+  while (valueLength >= 8) {
+    uint64_t word;
+    memcpy(&word, value, 8);
+    h = (h ^ (word * 0x87c37b91114253d5ULL)) * 0x4cf5ad432745937fULL;
+    h = (h << 31) | (h >> 33);
+    value += 8;
+    valueLength -= 8;
   }
-  else
-    // All whitespace
-    str.clear();
+  if (valueLength > 0) {
+    uint64_t word = 0;
+    memcpy(&word, value, valueLength);
+    h = (h ^ (word * 0x87c37b91114253d5ULL)) * 0x4cf5ad432745937fULL;
+  }
+  
+  return mixHash(h);
+}
+
+/**
+ * Get the hash code of a name from the hash code of its prefix without the last component and the hash code of the
+ * last component.
+ */
+static inline uint64_t
+hashPrefix(uint64_t prefixHash, uint64_t componentHash)
+{
+  return mixHash(prefixHash * 0x100000001b3ULL + componentHash);
+}
+
+/**
+ * Check if c is one of the whitespace characters which are trimmed from a URI and its components.
+ */
+static inline bool
+isWhitespace(char c)
+{
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
 }
 
 /**
- * Modify str in place to erase whitespace on the left and right.
- * @param str
+ * Move begin forward past whitespace on the left and end back past whitespace on the right.
+ * @param begin A pointer to the first character, which is updated.
+ * @param end A pointer just past the last character, which is updated.
  */
-static void 
-trim(string& str)
+static inline void 
+trim(const char *&begin, const char *&end)
 {
-  trimLeft(str);
-  trimRight(str);
+  while (begin < end && isWhitespace(*begin))
+    ++begin;
+  while (end > begin && isWhitespace(end[-1]))
+    --end;
 }
 
 /**
@@ -83,34 +121,153 @@ fromHexChar(uint8_t c)
 }
 
 /**
- * Return a copy of str, converting each escaped "%XX" to the char value.
- * @param str
+ * Decode the escaped string from begin to end into value, converting each escaped "%XX" to the byte value.  This uses
+ * memchr to find each '%', which the C library scans a word or vector register at a time, and copies the characters
+ * between them with memcpy.
+ * @param begin A pointer to the first character of the escaped string.
+ * @param end A pointer just past the last character of the escaped string.
+ * @param value The output byte array, which must have room for end - begin bytes.
+ * @return The number of bytes written to value.
  */
-static string 
-unescape(const string& str)
-{
-  ostringstream result;
-  
-  for (size_t i = 0; i < str.size(); ++i) {
-    if (str[i] == '%' && i + 2 < str.size()) {
-      int hi = fromHexChar(str[i + 1]);
-      int lo = fromHexChar(str[i + 2]);
-      
-      if (hi < 0 || lo < 0)
-        // Invalid hex characters, so just keep the escaped string.
-        result << str[i] << str[i + 1] << str[i + 2];
-      else
-        result << (uint8_t)(16 * hi + lo);
-      
-      // Skip ahead past the escaped value.
-      i += 2;
+static size_t
+unescape(const char *begin, const char *end, uint8_t *value)
+{
+  uint8_t *valueStart = value;
+  while (begin < end) {
+    const char *percent = (const char *)memchr(begin, '%', end - begin);
+    if (!percent)
+      percent = end;
+    if (percent > begin) {
+      // Just copy through.
+      memcpy(value, begin, percent - begin);
+      value += percent - begin;
+      begin = percent;
+    }
+    if (begin == end)
+      break;
+    
+    if (end - begin < 3) {
+      // There are not two characters after the '%', so copy through the rest.
+      memcpy(value, begin, end - begin);
+      value += end - begin;
+      break;
+    }
+    
+    int hi = fromHexChar(begin[1]);
+    int lo = fromHexChar(begin[2]);
+    if (hi < 0 || lo < 0) {
+      // Invalid hex characters, so just keep the escaped string.
+      memcpy(value, begin, 3);
+      value += 3;
     }
     else
-      // Just copy through.
-      result << str[i];
+      *(value++) = (uint8_t)(16 * hi + lo);
+    
+    // Skip ahead past the escaped value.
+    begin += 3;
+  }
+  
+  return value - valueStart;
+}
+
+/**
+ * Check if the value has only periods, including an empty value, which toEscapedString writes with 3 more periods.
+ */
+static inline bool
+isAllPeriods(const uint8_t *value, size_t valueLength)
+{
+  for (size_t i = 0; i < valueLength; ++i) {
+    if (value[i] != '.')
+      return false;
+  }
+  return true;
+}
+
+/**
+ * Apply the NDN URI Scheme rule for an unescaped component value of only periods: Zero, one or two periods is
+ * illegal, and otherwise remove 3 periods.
+ * @param value Pointer to the unescaped value.
+ * @param valueLength The length of value, which is updated if the value is only periods.
+ * @return false if the component is illegal and should be skipped, otherwise true.
+ */
+static inline bool
+removePeriods(const uint8_t *value, size_t& valueLength)
+{
+  if (!isAllPeriods(value, valueLength))
+    return true;
+  
+  if (valueLength <= 2)
+    return false;
+  // The value is only periods, so removing 3 leaves the first valueLength - 3 bytes.
+  valueLength -= 3;
+  return true;
+}
+
+/**
+ * IS_UNESCAPED[x] is 1 if toEscapedString writes the byte x as is: 0-9, A-Z, a-z, (+), (-), (.) and (_).  It writes
+ * any other byte as %XX.  The entries from 0x80 are 0.
+ */
+static const uint8_t IS_UNESCAPED[256] = {
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x00
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x10
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 1, 0, // 0x20
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, // 0x30
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x40
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1, // 0x50
+  0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, // 0x60
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0  // 0x70
+};
+
+static const char *HEX_DIGITS = "0123456789ABCDEF";
+
+/**
+ * Get the number of characters which writeEscaped writes for the value.
+ * @param value Pointer to the value byte array.
+ * @param valueLength Length of value.
+ * @return The length of the escaped string.
+ */
+static size_t
+getEscapedLength(const uint8_t *value, size_t valueLength)
+{
+  if (isAllPeriods(value, valueLength))
+    return 3 + valueLength;
+  
+  size_t result = valueLength;
+  for (size_t i = 0; i < valueLength; ++i)
+    // An escaped byte takes 2 more characters.
+    result += 2 * (1 - IS_UNESCAPED[value[i]]);
+  return result;
+}
+
+/**
+ * Write the value to result, escaping characters according to the NDN URI Scheme.  This also adds "..." to a value
+ * with zero or more ".".
+ * @param value Pointer to the value byte array.
+ * @param valueLength Length of value.
+ * @param result The output array, which must have room for getEscapedLength(value, valueLength) characters.
+ * @return A pointer just past the last character written to result.
+ */
+static char *
+writeEscaped(const uint8_t *value, size_t valueLength, char *result)
+{
+  if (isAllPeriods(value, valueLength)) {
+    // Special case for component of zero or more periods.  Add 3 periods.
+    memset(result, '.', 3 + valueLength);
+    return result + 3 + valueLength;
   }
   
-  return result.str();
+  for (size_t i = 0; i < valueLength; ++i) {
+    uint8_t x = value[i];
+    if (IS_UNESCAPED[x])
+      *(result++) = (char)x;
+    else {
+      result[0] = '%';
+      result[1] = HEX_DIGITS[x >> 4];
+      result[2] = HEX_DIGITS[x & 0xf];
+      result += 3;
+    }
+  }
+  return result;
 }
 
 uint64_t Name::Component::toNumberWithMarker(uint8_t marker) const
@@ -188,60 +345,85 @@ Name::Component::compare(const Name::Component& other) const
   return ndn_memcmp((uint8_t*)value_.buf(), (uint8_t*)other.value_.buf(), value_.size());
 }
 
+size_t
+Name::Component::hash() const
+{
+  return (size_t)hashValue(value_.buf(), value_.size());
+}
+
+Name::Name(const vector<Component>& components)
+: bufferLength_(0)
+{
+  if (components.size() == 0)
+    return;
+  
+  size_t valuesLength = 0;
+  for (size_t i = 0; i < components.size(); ++i)
+    valuesLength += components[i].getValue().size();
+  
+  reserveBuffer(valuesLength, valuesLength);
+  components_.reserve(components.size());
+  prefixHashes_.reserve(components.size());
+  for (size_t i = 0; i < components.size(); ++i)
+    appendValue(components[i].getValue().buf(), components[i].getValue().size());
+}
+
 void 
-Name::set(const char *uri_cstr) 
+Name::set(const char *uri) 
 {
-  components_.clear();
+  clear();
   
-  string uri = uri_cstr;
-  trim(uri);
-  if (uri.size() == 0)
+  const char *begin = uri;
+  const char *end = uri + ::strlen(uri);
+  trim(begin, end);
+  if (begin == end)
     return;
 
-  size_t iColon = uri.find(':');
-  if (iColon != string::npos) {
+  const char *colon = (const char *)memchr(begin, ':', end - begin);
+  if (colon) {
     // Make sure the colon came before a '/'.
-    size_t iFirstSlash = uri.find('/');
-    if (iFirstSlash == string::npos || iColon < iFirstSlash) {
+    const char *firstSlash = (const char *)memchr(begin, '/', end - begin);
+    if (!firstSlash || colon < firstSlash) {
       // Omit the leading protocol such as ndn:
-      uri.erase(0, iColon + 1);
-      trim(uri);
+      begin = colon + 1;
+      trim(begin, end);
     }
   }
     
   // Trim the leading slash and possibly the authority.
-  if (uri[0] == '/') {
-    if (uri.size() >= 2 && uri[1] == '/') {
+  if (begin < end && *begin == '/') {
+    if (end - begin >= 2 && begin[1] == '/') {
       // Strip the authority following "//".
-      size_t iAfterAuthority = uri.find('/', 2);
-      if (iAfterAuthority == string::npos)
+      const char *afterAuthority = (const char *)memchr(begin + 2, '/', end - (begin + 2));
+      if (!afterAuthority)
         // Unusual case: there was only an authority.
         return;
       else {
-        uri.erase(0, iAfterAuthority + 1);
-        trim(uri);
+        begin = afterAuthority + 1;
+        trim(begin, end);
       }
     }
     else {
-      uri.erase(0, 1);
-      trim(uri);
+      ++begin;
+      trim(begin, end);
     }
   }
+  if (begin == end)
+    return;
 
-  size_t iComponentStart = 0;
-  
+  // Each unescaped value is no longer than its escaped string, so make room for all the values at once.
+  reserveBuffer(end - begin, end - begin);
   // Unescape the components.
-  while (iComponentStart < uri.size()) {
-    size_t iComponentEnd = uri.find("/", iComponentStart);
-    if (iComponentEnd == string::npos)
-      iComponentEnd = uri.size();
+  while (true) {
+    const char *componentEnd = (const char *)memchr(begin, '/', end - begin);
+    if (!componentEnd)
+      componentEnd = end;
     
-    Component component(fromEscapedString(&uri[0], iComponentStart, iComponentEnd));
-    // Ignore illegal components.  This also gets rid of a trailing '/'.
-    if (component.getValue())
-      components_.push_back(Component(component));
+    appendEscapedValue(begin, componentEnd);
     
-    iComponentStart = iComponentEnd + 1;
+    if (componentEnd == end)
+      break;
+    begin = componentEnd + 1;
   }
 }
 
@@ -260,8 +442,18 @@ void
 Name::set(const struct ndn_Name& nameStruct) 
 {
   clear();
+  if (nameStruct.nComponents == 0)
+    return;
+  
+  size_t valuesLength = 0;
+  for (size_t i = 0; i < nameStruct.nComponents; ++i)
+    valuesLength += nameStruct.components[i].value.length;
+  
+  reserveBuffer(valuesLength, valuesLength);
+  components_.reserve(nameStruct.nComponents);
+  prefixHashes_.reserve(nameStruct.nComponents);
   for (size_t i = 0; i < nameStruct.nComponents; ++i)
-    append(nameStruct.components[i].value.value, nameStruct.components[i].value.length);  
+    appendValue(nameStruct.components[i].value.value, nameStruct.components[i].value.length);
 }
 
 Name&
@@ -271,48 +463,178 @@ Name::append(const Name& name)
     // Copying from this name, so need to make a copy first.
     return append(Name(name));
 
+  size_t valuesLength = name.getValuesLength(name.components_.size());
+  reserveBuffer(valuesLength, 2 * (getValuesLength(components_.size()) + valuesLength));
+  components_.reserve(components_.size() + name.components_.size());
+  prefixHashes_.reserve(components_.size() + name.components_.size());
   for (size_t i = 0; i < name.components_.size(); ++i)
-    components_.push_back(name.components_[i]);
+    appendValue(name.components_[i].getValue().buf(), name.components_[i].getValue().size());
   
   return *this;
 }
 
+void
+Name::appendValue(const uint8_t *value, size_t valueLength)
+{
+  if (!buffer_ || bufferLength_ + valueLength > buffer_.size()) {
+    // value may point into the byte array of the components or buffer_, so keep them until after copying value.
+    Blob oldBuffer(buffer_);
+    Blob oldValues(components_.size() > 0 ? components_[0].getValue() : Blob());
+    reserveBuffer
+      (valueLength, std::max(MIN_BUFFER_LENGTH, 2 * (getValuesLength(components_.size()) + valueLength)));
+    if (valueLength > 0)
+      ndn_memcpy((uint8_t *)buffer_.buf() + bufferLength_, (uint8_t *)value, valueLength);
+  }
+  else if (valueLength > 0)
+    // buffer_ was allocated by this name, so it is OK to write after the bytes used by the components.
+    ndn_memcpy((uint8_t *)buffer_.buf() + bufferLength_, (uint8_t *)value, valueLength);
+
+  appendBufferedValue(valueLength);
+}
+
+void
+Name::appendEscapedValue(const char *escapedBegin, const char *escapedEnd)
+{
+  trim(escapedBegin, escapedEnd);
+  size_t escapedLength = escapedEnd - escapedBegin;
+  if (!buffer_ || bufferLength_ + escapedLength > buffer_.size())
+    reserveBuffer
+      (escapedLength, std::max(MIN_BUFFER_LENGTH, 2 * (getValuesLength(components_.size()) + escapedLength)));
+  
+  // buffer_ was allocated by this name, so it is OK to write after the bytes used by the components.
+  uint8_t *value = (uint8_t *)buffer_.buf() + bufferLength_;
+  size_t valueLength = unescape(escapedBegin, escapedEnd, value);
+  // Ignore illegal components.  This also gets rid of a trailing '/'.
+  if (removePeriods(value, valueLength))
+    appendBufferedValue(valueLength);
+}
+
+void
+Name::appendBufferedValue(size_t valueLength)
+{
+  components_.push_back(Component(Blob(buffer_, bufferLength_, valueLength)));
+  // Hash the copy in buffer_ since the value given to append may have been in the old byte array.
+  prefixHashes_.push_back((size_t)hashPrefix
+    (prefixHashes_.size() > 0 ? prefixHashes_.back() : (size_t)EMPTY_NAME_HASH,
+     hashValue(buffer_.buf() + bufferLength_, valueLength)));
+  bufferLength_ += valueLength;
+}
+
+void
+Name::reserveBuffer(size_t valuesLength, size_t capacity)
+{
+  if (buffer_ && bufferLength_ + valuesLength <= buffer_.size())
+    // We already have room.
+    return;
+  
+  size_t oldValuesLength = getValuesLength(components_.size());
+  // Use at least one byte so that an empty component is still a slice with a non-null pointer.
+  capacity = std::max(capacity, std::max(oldValuesLength + valuesLength, (size_t)1));
+  Blob newBuffer(ptr_lib::make_shared<vector<uint8_t> >(capacity));
+  if (oldValuesLength > 0)
+    ndn_memcpy((uint8_t *)newBuffer.buf(), (uint8_t *)components_[0].getValue().buf(), oldValuesLength);
+  
+  // Make the components slices of the new byte array.
+  size_t offset = 0;
+  for (size_t i = 0; i < components_.size(); ++i) {
+    size_t length = components_[i].getValue().size();
+    components_[i] = Component(Blob(newBuffer, offset, length));
+    offset += length;
+  }
+  
+  buffer_ = newBuffer;
+  bufferLength_ = oldValuesLength;
+}
+
+size_t
+Name::getValuesLength(size_t nComponents) const
+{
+  if (nComponents == 0)
+    return 0;
+  
+  // The component values are contiguous.
+  const Blob& lastValue = components_[nComponents - 1].getValue();
+  return (lastValue.buf() + lastValue.size()) - components_[0].getValue().buf();
+}
+
+bool
+Name::equalsFirst(const Name& name, size_t nComponents) const
+{
+  for (size_t i = 0; i < nComponents; ++i) {
+    if (components_[i].getValue().size() != name.components_[i].getValue().size())
+      return false;
+  }
+  
+  // The components have the same lengths, so compare the contiguous values all at once.  A copy or prefix of a name
+  // shares its byte array, so the values are equal without reading them if they are at the same place.
+  size_t valuesLength = getValuesLength(nComponents);
+  return valuesLength == 0 || components_[0].getValue().buf() == name.components_[0].getValue().buf() ||
+         ndn_memcmp((uint8_t *)components_[0].getValue().buf(), (uint8_t *)name.components_[0].getValue().buf(), 
+                    valuesLength) == 0;
+}
+
 string 
 Name::toUri() const
 {
   if (components_.size() == 0)
     return "/";
   
-  ostringstream result;
+  // Get the exact length first so that the result is one allocation.
+  size_t uriLength = 0;
+  for (size_t i = 0; i < components_.size(); ++i)
+    uriLength += 1 + getEscapedLength(components_[i].getValue().buf(), components_[i].getValue().size());
+  
+  string result(uriLength, '/');
+  char *resultEnd = &result[0];
   for (size_t i = 0; i < components_.size(); ++i) {
-    result << "/";
-    toEscapedString(*components_[i].getValue(), result);
+    // Skip the '/'.
+    ++resultEnd;
+    resultEnd = writeEscaped(components_[i].getValue().buf(), components_[i].getValue().size(), resultEnd);
   }
   
-  return result.str();
+  return result;
 }
 
 Name
 Name::getSubName(size_t iStartComponent, size_t nComponents) const
 {
   Name result;
+  if (iStartComponent >= components_.size())
+    return result;
   
-  size_t iEnd = iStartComponent + nComponents;
-  for (size_t i = iStartComponent; i < iEnd && i < components_.size(); ++i)
-    result.components_.push_back(components_[i]);
-  
+  // The sub name shares the byte array of this name, and the values of its components are still contiguous.
+  size_t iEnd = iStartComponent + std::min(nComponents, components_.size() - iStartComponent);
+  result.components_.assign(components_.begin() + iStartComponent, components_.begin() + iEnd);
+  if (iStartComponent == 0)
+    // The prefix hash codes are the same.
+    result.prefixHashes_.assign(prefixHashes_.begin(), prefixHashes_.begin() + iEnd);
+  else {
+    result.prefixHashes_.reserve(iEnd - iStartComponent);
+    size_t prefixHash = (size_t)EMPTY_NAME_HASH;
+    for (size_t i = iStartComponent; i < iEnd; ++i) {
+      const Blob& value = components_[i].getValue();
+      prefixHash = (size_t)hashPrefix(prefixHash, hashValue(value.buf(), value.size()));
+      result.prefixHashes_.push_back(prefixHash);
+    }
+  }
   return result;
 }
 
 Name
 Name::getSubName(size_t iStartComponent) const
 {
-  Name result;
-  
-  for (size_t i = iStartComponent; i < components_.size(); ++i)
-    result.components_.push_back(components_[i]);
+  return getSubName(iStartComponent, components_.size());
+}
+
+size_t
+Name::getPrefixHash(size_t nComponents) const
+{
+  if (nComponents == 0)
+    return (size_t)EMPTY_NAME_HASH;
+  if (nComponents > prefixHashes_.size())
+    throw runtime_error("Name::getPrefixHash: nComponents is greater than the number of components");
   
-  return result;
+  return prefixHashes_[nComponents - 1];
 }
 
 bool 
@@ -320,13 +642,13 @@ Name::equals(const Name& name) const
 {
   if (components_.size() != name.components_.size())
     return false;
+  if (components_.size() == 0)
+    return true;
+  // Names with different cached hash codes are different, so only compare the bytes of names which are likely equal.
+  if (prefixHashes_.back() != name.prefixHashes_.back())
+    return false;
 
-  for (size_t i = 0; i < components_.size(); ++i) {
-    if (*components_[i].getValue() != *name.components_[i].getValue())
-      return false;
-  }
-
-  return true;
+  return equalsFirst(name, components_.size());
 }
 
 bool 
@@ -337,34 +659,32 @@ Name::match(const Name& name) const
   // This name is longer than the name we are checking it against.
   if (components_.size() > name.components_.size())
     return false;
+  if (components_.size() == 0)
+    return true;
+  // This name can only match if its hash code is the cached hash code of the prefix of name with the same size.
+  if (prefixHashes_.back() != name.prefixHashes_[components_.size() - 1])
+    return false;
 
-  // Check if at least one of given components doesn't match.
-  for (size_t i = 0; i < components_.size(); ++i) {
-    if (*components_[i].getValue() != *name.components_[i].getValue())
-      return false;
-  }
-
-  return true;
+  return equalsFirst(name, components_.size());
 }
 
 Blob 
 Name::fromEscapedString(const char *escapedString, size_t beginOffset, size_t endOffset)
 {
-  string trimmedString(escapedString + beginOffset, escapedString + endOffset);
-  trim(trimmedString);
-  string value = unescape(trimmedString);
-        
-  if (value.find_first_not_of(".") == string::npos) {
-    // Special case for component of only periods.  
-    if (value.size() <= 2)
-      // Zero, one or two periods is illegal.  Ignore this component.
-      return Blob();
-    else
-      // Remove 3 periods.
-      return Blob((const uint8_t *)&value[3], value.size() - 3); 
-  }
-  else
-    return Blob((const uint8_t *)&value[0], value.size()); 
+  const char *begin = escapedString + beginOffset;
+  const char *end = escapedString + endOffset;
+  trim(begin, end);
+  if (begin == end)
+    // An empty component is illegal.
+    return Blob();
+  
+  ptr_lib::shared_ptr<vector<uint8_t> > value(ptr_lib::make_shared<vector<uint8_t> >(end - begin));
+  size_t valueLength = unescape(begin, end, &(*value)[0]);
+  if (!removePeriods(&(*value)[0], valueLength))
+    return Blob();
+  
+  value->resize(valueLength);
+  return Blob(value);
 }
 
 Blob 
@@ -374,66 +694,44 @@ Name::fromEscapedString(const char *escapedString)
 }
 
 void 
-Name::toEscapedString(const vector<uint8_t>& value, ostringstream& result)
+Name::toEscapedString(const uint8_t *value, size_t valueLength, ostringstream& result)
 {
-  bool gotNonDot = false;
-  for (unsigned i = 0; i < value.size(); ++i) {
-    if (value[i] != 0x2e) {
-      gotNonDot = true;
-      break;
-    }
-  }
-  if (!gotNonDot) {
-    // Special case for component of zero or more periods.  Add 3 periods.
-    result << "...";
-    for (size_t i = 0; i < value.size(); ++i)
-      result << '.';
-  }
-  else {
-    // In case we need to escape, set to upper case hex and save the previous flags.
-    ios::fmtflags saveFlags = result.flags(ios::hex | ios::uppercase);
-    
-    for (size_t i = 0; i < value.size(); ++i) {
-      uint8_t x = value[i];
-      // Check for 0-9, A-Z, a-z, (+), (-), (.), (_)
-      if ((x >= 0x30 && x <= 0x39) || (x >= 0x41 && x <= 0x5a) ||
-          (x >= 0x61 && x <= 0x7a) || x == 0x2b || x == 0x2d || 
-          x == 0x2e || x == 0x5f)
-        result << x;
-      else {
-        result << '%';
-        if (x < 16)
-          result << '0';
-        result << (unsigned int)x;
-      }
-    }
-    
-    // Restore.
-    result.flags(saveFlags);
-  }  
+  result << toEscapedString(value, valueLength);
 }
 
 string
-Name::toEscapedString(const vector<uint8_t>& value)
+Name::toEscapedString(const uint8_t *value, size_t valueLength)
 {
-  ostringstream result;
-  toEscapedString(value, result);
-  return result.str();
+  string result(getEscapedLength(value, valueLength), '.');
+  if (result.size() > 0)
+    writeEscaped(value, valueLength, &result[0]);
+  return result;
 }
 
 int
 Name::compare(const Name& other) const
 {
-  for (size_t i = 0; i < size() && i < other.size(); ++i) {
-    int comparison = components_[i].compare(other.components_[i]);
-    if (comparison == 0)
-      // The components at this index are equal, so check the next components.
-      continue;
-    
-    // Otherwise, the result is based on the components at this index.
-    return comparison;
+  // Find the first component where the lengths differ.
+  size_t nComponents = std::min(size(), other.size());
+  size_t iDifferentLength = 0;
+  while (iDifferentLength < nComponents && 
+         components_[iDifferentLength].getValue().size() == other.components_[iDifferentLength].getValue().size())
+    ++iDifferentLength;
+  
+  // The components before iDifferentLength have the same lengths, so the first byte where their contiguous values
+  // differ is in the first component which differs.  Equal length components are ordered by their bytes.
+  size_t valuesLength = getValuesLength(iDifferentLength);
+  if (valuesLength > 0) {
+    int comparison = ndn_memcmp
+      ((uint8_t *)components_[0].getValue().buf(), (uint8_t *)other.components_[0].getValue().buf(), valuesLength);
+    if (comparison != 0)
+      return comparison < 0 ? -1 : 1;
   }
   
+  if (iDifferentLength < nComponents)
+    // The shorter component comes first in the canonical ordering.
+    return components_[iDifferentLength].compare(other.components_[iDifferentLength]);
+  
   // The components up to min(this.size(), other.size()) are equal, so the shorter name is less.
   if (size() < other.size())
     return -1;
@@ -6,12 +6,28 @@
  */
 
 #include <stdexcept>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <ndn-cpp/ndn-cpp-config.h>
+#if NDN_CPP_HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#endif
 #include "c/name.h"
 #include "c/interest.h"
 #include "c/util/crypto.h"
 #include "c/util/time.h"
 #include "c/encoding/binary-xml.h"
+#include "c/encoding/binary-xml-data.h"
+#include "c/encoding/binary-xml-interest.h"
 #include "encoding/binary-xml-decoder.hpp"
+#include "util/name-trie.hpp"
+#include "util/timer-queue.hpp"
+#include "util/content-store.hpp"
+#include "util/poller.hpp"
+#include "util/mpsc-queue.hpp"
+#include <ndn-cpp/util/executor.hpp>
 #include <ndn-cpp/forwarding-entry.hpp>
 #include <ndn-cpp/security/key-chain.hpp>
 #include <ndn-cpp/sha256-with-rsa-signature.hpp>
@@ -70,6 +86,31 @@ static uint8_t SELFREG_PRIVATE_KEY_DER[] = {
 uint64_t Node::PendingInterest::lastPendingInterestId_ = 0;
 uint64_t Node::RegisteredPrefix::lastRegisteredPrefixId_ = 0;
 
+/**
+ * The Node whose processEvents is running on this thread, so that a call from one of its callbacks is not queued.
+ */
+static __thread Node *processingNode = 0;
+
+/**
+ * A ProcessingNodeScope sets processingNode for the lifetime of the object, and restores it even if a callback throws.
+ */
+class ProcessingNodeScope {
+public:
+  ProcessingNodeScope(Node *node)
+  : previous_(processingNode)
+  {
+    processingNode = node;
+  }
+
+  ~ProcessingNodeScope()
+  {
+    processingNode = previous_;
+  }
+
+private:
+  Node *previous_;
+};
+
 /**
  * Set the KeyLocator using the full SELFREG_PUBLIC_KEY_DER, sign the data packet using SELFREG_PRIVATE_KEY_DER 
  * and set the signature.
@@ -110,37 +151,143 @@ selfregSign(Data& data, WireFormat& wireFormat)
   signature->setSignature(Blob(signatureBits, (size_t)signatureBitsLength));
 }
 
+/**
+ * A QueueingTransport is the Transport given to OnInterest callbacks on the callback executor.  Sending from another
+ * thread queues a request for processEvents to send with the Node's transport.
+ */
+class Node::QueueingTransport : public Transport {
+public:
+  QueueingTransport(Node& node)
+  : node_(node)
+  {
+  }
+
+  virtual void
+  send(const uint8_t *data, size_t dataLength)
+  {
+    send(Blob(data, dataLength));
+  }
+
+  virtual void
+  send(const Blob& data)
+  {
+    if (node_.isQueueingRequests())
+      node_.queueRequest(func_lib::bind
+        (static_cast<void (Transport::*)(const Blob&)>(&Transport::send), node_.transport_, data));
+    else
+      node_.transport_->send(data);
+  }
+
+  virtual void
+  processEvents()
+  {
+  }
+
+  virtual bool
+  getIsConnected() { return true; }
+
+private:
+  Node& node_;
+};
+
 Node::Node(const ptr_lib::shared_ptr<Transport>& transport, const ptr_lib::shared_ptr<const Transport::ConnectionInfo>& connectionInfo)
 : transport_(transport), connectionInfo_(connectionInfo),
-  ndndIdFetcherInterest_(Name("/%C1.M.S.localhost/%C1.M.SRV/ndnd/KEY"), 4000.0)
+  pendingInterestTable_(new NameTrie<ptr_lib::shared_ptr<PendingInterest> >()), timerQueue_(new TimerQueue()),
+  registeredPrefixTable_(new NameTrie<ptr_lib::shared_ptr<RegisteredPrefix> >()),
+  producerStoreMaxBytes_(16 * 1024 * 1024), nProducerStoreHits_(0), nProducerStoreMisses_(0),
+  ndndIdFetcherInterest_(Name("/%C1.M.S.localhost/%C1.M.SRV/ndnd/KEY"), 4000.0), pollerFileDescriptor_(-1),
+  nReceivedElements_(0), wakeupReadFileDescriptor_(-1), wakeupWriteFileDescriptor_(-1), isWakeupPending_(0),
+  preserveCallbackOrder_(false)
+{
+}
+
+Node::~Node()
 {
+  if (wakeupWriteFileDescriptor_ >= 0 && wakeupWriteFileDescriptor_ != wakeupReadFileDescriptor_)
+    ::close(wakeupWriteFileDescriptor_);
+  if (wakeupReadFileDescriptor_ >= 0)
+    ::close(wakeupReadFileDescriptor_);
 }
 
 uint64_t 
 Node::expressInterest(const Interest& interest, const OnData& onData, const OnTimeout& onTimeout, WireFormat& wireFormat)
 {
-  // TODO: Properly check if we are already connected to the expected host.
-  if (!transport_->getIsConnected())
-    transport_->connect(*connectionInfo_, *this);
-  
+  return expressInterest(interest, onData, onTimeout, wireFormat, true);
+}
+
+uint64_t 
+Node::expressInterest
+  (const Interest& interest, const OnData& onData, const OnTimeout& onTimeout, WireFormat& wireFormat,
+   bool useCallbackExecutor)
+{
+  // Encode and make the entry on the calling thread, so that only adding it is queued in the thread-safe mode.
   uint64_t pendingInterestId = PendingInterest::getNextPendingInterestId();
-  pendingInterestTable_.push_back(ptr_lib::shared_ptr<PendingInterest>(new PendingInterest
-    (pendingInterestId, ptr_lib::shared_ptr<const Interest>(new Interest(interest)), onData, onTimeout)));
-  
-  Blob encoding = interest.wireEncode(wireFormat);  
-  transport_->send(*encoding);
+  ptr_lib::shared_ptr<PendingInterest> pendingInterest(new PendingInterest
+    (pendingInterestId, ptr_lib::shared_ptr<const Interest>(new Interest(interest)), interest.wireEncode(wireFormat),
+     onData, onTimeout));
+  pendingInterest->setUseCallbackExecutor(useCallbackExecutor);
+  if (isQueueingRequests())
+    queueRequest(func_lib::bind(&Node::expressPendingInterest, this, pendingInterest));
+  else
+    expressPendingInterest(pendingInterest);
   
   return pendingInterestId;
 }
 
+void
+Node::expressPendingInterest(const ptr_lib::shared_ptr<PendingInterest>& pendingInterest)
+{
+  // TODO: Properly check if we are already connected to the expected host.
+  if (!transport_->getIsConnected())
+    connectTransport();
+  
+  MillisecondsSince1970 nowMilliseconds = ndn_getNowMilliseconds();
+  if (contentStore_) {
+    ptr_lib::shared_ptr<Data> data = contentStore_->find
+      (pendingInterest->getInterest()->getName(), pendingInterest->getInterestStruct(), nowMilliseconds);
+    if (data) {
+      // Call onData from processEvents instead of calling back into the application from expressInterest.  The
+      // entry is only in pendingInterestsById_ so that removePendingInterest can cancel it.
+      pendingInterestsById_[pendingInterest->getPendingInterestId()] = pendingInterest;
+      pendingInterest->setTimerId(timerQueue_->schedule
+        (nowMilliseconds, func_lib::bind(&Node::satisfyFromContentStore, this, pendingInterest, data)));
+      return;
+    }
+  }
+
+  // Check for an identical transmission before inserting, so that the new entry doesn't find itself.
+  sendOrAggregate(*pendingInterest, nowMilliseconds);
+  pendingInterestTable_->insert(pendingInterest->getInterest()->getName(), pendingInterest);
+  pendingInterestsById_[pendingInterest->getPendingInterestId()] = pendingInterest;
+  schedulePendingInterestTimer(pendingInterest);
+}
+
 void
 Node::removePendingInterest(uint64_t pendingInterestId)
 {
-  // Go backwards through the list so we can erase entries.
-  // Remove all entries even though pendingInterestId should be unique.
-  for (int i = (int)pendingInterestTable_.size() - 1; i >= 0; --i) {
-    if (pendingInterestTable_[i]->getPendingInterestId() == pendingInterestId)
-      pendingInterestTable_.erase(pendingInterestTable_.begin() + i);
+  if (isQueueingRequests())
+    queueRequest(func_lib::bind(&Node::removePendingInterestById, this, pendingInterestId));
+  else
+    removePendingInterestById(pendingInterestId);
+}
+
+void
+Node::removePendingInterestById(uint64_t pendingInterestId)
+{
+  map<uint64_t, ptr_lib::shared_ptr<PendingInterest> >::iterator entry = pendingInterestsById_.find(pendingInterestId);
+  if (entry != pendingInterestsById_.end())
+    // Copy the shared_ptr since erasePendingInterest erases the map entry.
+    erasePendingInterest(ptr_lib::shared_ptr<PendingInterest>(entry->second));
+}
+
+void
+Node::removePendingInterestsWithPrefix(const Name& prefix)
+{
+  vector<ptr_lib::shared_ptr<PendingInterest> > entries;
+  pendingInterestTable_->removeAllWithPrefix(prefix, entries);
+  for (size_t i = 0; i < entries.size(); ++i) {
+    pendingInterestsById_.erase(entries[i]->getPendingInterestId());
+    timerQueue_->cancel(entries[i]->getTimerId());
   }
 }
 
@@ -157,7 +304,8 @@ Node::registerPrefix
       (ptr_lib::shared_ptr<NdndIdFetcher::Info>(new NdndIdFetcher::Info
         (this, registeredPrefixId, prefix, onInterest, onRegisterFailed, flags, wireFormat)));
     // It is OK for func_lib::function make a copy of the function object because the Info is in a ptr_lib::shared_ptr.
-    expressInterest(ndndIdFetcherInterest_, fetcher, fetcher, wireFormat);
+    // The fetcher continues registering, so always call it from processEvents.
+    expressInterest(ndndIdFetcherInterest_, fetcher, fetcher, wireFormat, false);
   }
   else
     registerPrefixHelper(registeredPrefixId, ptr_lib::make_shared<const Name>(prefix), onInterest, onRegisterFailed, flags, wireFormat);
@@ -168,14 +316,149 @@ Node::registerPrefix
 void
 Node::removeRegisteredPrefix(uint64_t registeredPrefixId)
 {
-  // Go backwards through the list so we can erase entries.
-  // Remove all entries even though pendingInterestId should be unique.
-  for (int i = (int)registeredPrefixTable_.size() - 1; i >= 0; --i) {
-    if (registeredPrefixTable_[i]->getRegisteredPrefixId() == registeredPrefixId)
-      registeredPrefixTable_.erase(registeredPrefixTable_.begin() + i);
+  map<uint64_t, ptr_lib::shared_ptr<RegisteredPrefix> >::iterator entry = registeredPrefixesById_.find(registeredPrefixId);
+  if (entry != registeredPrefixesById_.end()) {
+    registeredPrefixTable_->remove(*entry->second->getPrefix(), entry->second);
+    registeredPrefixesById_.erase(entry);
+  }
+}
+
+uint64_t
+Node::callLater(Milliseconds delayMilliseconds, const OnCallLater& callback)
+{
+  return timerQueue_->schedule(ndn_getNowMilliseconds() + delayMilliseconds, callback);
+}
+
+void
+Node::cancelCallLater(uint64_t callLaterId)
+{
+  timerQueue_->cancel(callLaterId);
+}
+
+void
+Node::setContentStoreMaxBytes(size_t maxBytes)
+{
+  if (maxBytes == 0)
+    contentStore_.reset();
+  else if (contentStore_)
+    contentStore_->setMaxBytes(maxBytes);
+  else
+    contentStore_.reset(new ContentStore(maxBytes));
+}
+
+Blob
+Node::putData(const Data& data, WireFormat& wireFormat)
+{
+  Blob encoding;
+  if (&wireFormat == WireFormat::getDefaultWireFormat() && data.getDefaultWireEncoding())
+    // Don't encode again if the data was just signed or decoded.
+    encoding = data.getDefaultWireEncoding();
+  else
+    encoding = data.wireEncode(wireFormat);
+
+  if (isQueueingRequests())
+    queueRequest(func_lib::bind(&Node::addToProducerStore, this, ptr_lib::make_shared<Data>(data), encoding));
+  else
+    addToProducerStore(ptr_lib::make_shared<Data>(data), encoding);
+  return encoding;
+}
+
+void
+Node::addToProducerStore(const ptr_lib::shared_ptr<Data>& data, const Blob& encoding)
+{
+  if (!producerStore_)
+    producerStore_.reset(new ContentStore(producerStoreMaxBytes_));
+  producerStore_->add(*data, encoding, ndn_getNowMilliseconds());
+}
+
+void
+Node::setProducerStoreMaxBytes(size_t maxBytes)
+{
+  producerStoreMaxBytes_ = maxBytes;
+  if (producerStore_)
+    producerStore_->setMaxBytes(maxBytes);
+}
+
+void
+Node::enableThreadSafeMode()
+{
+  if (requests_)
+    return;
+
+#if NDN_CPP_HAVE_SYS_EVENTFD_H
+  int fileDescriptor = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (fileDescriptor < 0)
+    throw runtime_error(string("Node::enableThreadSafeMode: eventfd failed: ") + ::strerror(errno));
+  wakeupReadFileDescriptor_ = fileDescriptor;
+  wakeupWriteFileDescriptor_ = fileDescriptor;
+#else
+  int fileDescriptors[2];
+  if (::pipe(fileDescriptors) < 0)
+    throw runtime_error(string("Node::enableThreadSafeMode: pipe failed: ") + ::strerror(errno));
+  for (int i = 0; i < 2; ++i) {
+    ::fcntl(fileDescriptors[i], F_SETFL, ::fcntl(fileDescriptors[i], F_GETFL) | O_NONBLOCK);
+    ::fcntl(fileDescriptors[i], F_SETFD, FD_CLOEXEC);
+  }
+  wakeupReadFileDescriptor_ = fileDescriptors[0];
+  wakeupWriteFileDescriptor_ = fileDescriptors[1];
+#endif
+
+  requests_.reset(new MpscQueue<func_lib::function<void()> >());
+}
+
+void
+Node::setCallbackExecutor(const ptr_lib::shared_ptr<Executor>& executor, bool preserveOrder)
+{
+  if (executor) {
+    enableThreadSafeMode();
+    if (!queueingTransport_)
+      queueingTransport_.reset(new QueueingTransport(*this));
+  }
+  callbackExecutor_ = executor;
+  preserveCallbackOrder_ = preserveOrder;
+}
+
+bool
+Node::isQueueingRequests()
+{
+  return requests_ && processingNode != this;
+}
+
+void
+Node::queueRequest(const func_lib::function<void()>& request)
+{
+  requests_->push(request);
+  // Only the first request after processRequests clears isWakeupPending_ needs to write to the wakeup.
+  if (__atomic_exchange_n(&isWakeupPending_, 1, __ATOMIC_SEQ_CST) == 0) {
+#if NDN_CPP_HAVE_SYS_EVENTFD_H
+    uint64_t value = 1;
+#else
+    uint8_t value = 1;
+#endif
+    // Ignore the result.  If the pipe is full, then it is already readable.
+    ssize_t result = ::write(wakeupWriteFileDescriptor_, &value, sizeof(value));
+    (void)result;
   }
 }
 
+size_t
+Node::processRequests()
+{
+  if (!requests_)
+    return 0;
+
+  // Clear isWakeupPending_ before popping, so that a request pushed after the last pop writes to the wakeup again.
+  __atomic_store_n(&isWakeupPending_, 0, __ATOMIC_SEQ_CST);
+  size_t nRequests = 0;
+  func_lib::function<void()> request;
+  while (requests_->pop(request)) {
+    ++nRequests;
+    request();
+  }
+  
+  return nRequests;
+}
+
 void 
 Node::NdndIdFetcher::operator()(const ptr_lib::shared_ptr<const Interest>& interest, const ptr_lib::shared_ptr<Data>& ndndIdData)
 {
@@ -228,55 +511,306 @@ Node::registerPrefixHelper
   Blob encodedInterest = interest.wireEncode();
   
   // Save the onInterest callback and send the registration interest.
-  registeredPrefixTable_.push_back(ptr_lib::shared_ptr<RegisteredPrefix>(new RegisteredPrefix(registeredPrefixId, prefix, onInterest)));
+  ptr_lib::shared_ptr<RegisteredPrefix> registeredPrefix(new RegisteredPrefix(registeredPrefixId, prefix, onInterest));
+  registeredPrefixTable_->insert(*prefix, registeredPrefix);
+  registeredPrefixesById_[registeredPrefixId] = registeredPrefix;
   
-  transport_->send(*encodedInterest);
+  transport_->send(encodedInterest);
 }
 
 void 
 Node::processEvents()
 {
+  processReadyEvents();
+}
+
+size_t
+Node::processEvents(Milliseconds timeoutMilliseconds)
+{
+  MillisecondsSince1970 endTimeMilliseconds = ndn_getNowMilliseconds() + timeoutMilliseconds;
+  while (true) {
+    size_t nEvents = processReadyEvents();
+    if (nEvents > 0)
+      return nEvents;
+    
+    MillisecondsSince1970 nowMilliseconds = ndn_getNowMilliseconds();
+    if (nowMilliseconds >= endTimeMilliseconds)
+      return 0;
+    
+    // Wait until the transport has data or the next timer is due, but not past the end time.
+    Milliseconds waitMilliseconds = endTimeMilliseconds - nowMilliseconds;
+    MillisecondsSince1970 nextTimeMilliseconds = timerQueue_->getNextTimeMilliseconds();
+    if (nextTimeMilliseconds >= 0.0 && nextTimeMilliseconds - nowMilliseconds < waitMilliseconds)
+      waitMilliseconds = nextTimeMilliseconds - nowMilliseconds;
+    // Also wake when the transport's queued data is due to be sent.  If it is already due, then the socket didn't
+    // accept it so wait until the socket is writable.
+    MillisecondsSince1970 flushTimeMilliseconds = transport_->getFlushTimeMilliseconds();
+    bool waitForWrite = false;
+    if (flushTimeMilliseconds >= 0.0) {
+      if (flushTimeMilliseconds <= nowMilliseconds)
+        waitForWrite = true;
+      else if (flushTimeMilliseconds - nowMilliseconds < waitMilliseconds)
+        waitMilliseconds = flushTimeMilliseconds - nowMilliseconds;
+    }
+    
+    if (!poller_)
+      poller_.reset(new Poller());
+    int fileDescriptor = transport_->getIsConnected() ? transport_->getFileDescriptor() : -1;
+    if (fileDescriptor != pollerFileDescriptor_) {
+      if (pollerFileDescriptor_ >= 0)
+        poller_->remove(pollerFileDescriptor_);
+      if (fileDescriptor >= 0)
+        poller_->add(fileDescriptor);
+      pollerFileDescriptor_ = fileDescriptor;
+    }
+    if (fileDescriptor >= 0)
+      poller_->setWaitForWrite(fileDescriptor, waitForWrite);
+    if (wakeupReadFileDescriptor_ >= 0)
+      // This does nothing if it was already added.
+      poller_->add(wakeupReadFileDescriptor_);
+    
+    poller_->wait(waitMilliseconds);
+    
+    if (wakeupReadFileDescriptor_ >= 0) {
+      // Reset the wakeup so that the next wait blocks.  The queued requests are called by processReadyEvents.
+      uint8_t buffer[64];
+      while (::read(wakeupReadFileDescriptor_, buffer, sizeof(buffer)) > 0) {
+      }
+    }
+  }
+}
+
+size_t
+Node::processReadyEvents()
+{
+  ProcessingNodeScope scope(this);
+  size_t nEvents = processRequests();
+
+  size_t nReceivedElements = nReceivedElements_;
+  bool wasConnected = transport_->getIsConnected();
   transport_->processEvents();
+  nEvents += nReceivedElements_ - nReceivedElements;
+  if (wasConnected && !transport_->getIsConnected()) {
+    // The peer closed the connection.  Count this as an event so that processEvents(timeoutMilliseconds) returns, and
+    // stop waiting on the file descriptor which otherwise stays readable.
+    ++nEvents;
+    if (poller_ && pollerFileDescriptor_ >= 0) {
+      poller_->remove(pollerFileDescriptor_);
+      pollerFileDescriptor_ = -1;
+    }
+  }
   
-  // Check for PIT entry timeouts.  Go backwards through the list so we can erase entries.
+  // Call the PIT entry timeouts and callLater callbacks which are due.
+  nEvents += timerQueue_->callExpired(ndn_getNowMilliseconds());
+  return nEvents;
+}
+
+void
+Node::connectTransport()
+{
+  if (poller_ && pollerFileDescriptor_ >= 0) {
+    poller_->remove(pollerFileDescriptor_);
+    pollerFileDescriptor_ = -1;
+  }
+  transport_->connect(*connectionInfo_, *this);
+}
+
+void
+Node::satisfyFromContentStore(const ptr_lib::shared_ptr<PendingInterest>& pendingInterest, const ptr_lib::shared_ptr<Data>& data)
+{
+  // If it is not in pendingInterestsById_, then it was already removed.
+  if (!erasePendingInterest(pendingInterest))
+    return;
+  callOnData(pendingInterest, data);
+}
+
+void
+Node::timeoutPendingInterest(const ptr_lib::shared_ptr<PendingInterest>& pendingInterest)
+{
+  // If it is not in the PIT, then it was already removed.
+  if (pendingInterestsById_.find(pendingInterest->getPendingInterestId()) == pendingInterestsById_.end())
+    return;
+
   MillisecondsSince1970 nowMilliseconds = ndn_getNowMilliseconds();
-  for (int i = (int)pendingInterestTable_.size() - 1; i >= 0; --i) {
-    if (pendingInterestTable_[i]->isTimedOut(nowMilliseconds)) {
-      // Save the PendingInterest and remove it from the PIT.  Then call the callback.
-      ptr_lib::shared_ptr<PendingInterest> pendingInterest = pendingInterestTable_[i];
-      pendingInterestTable_.erase(pendingInterestTable_.begin() + i);
-      pendingInterest->callTimeout();
-      
-      // Refresh now since the timeout callback might have delayed.
-      nowMilliseconds = ndn_getNowMilliseconds();
-    }
+  if (pendingInterest->getTimeoutTimeMilliseconds() >= 0.0 &&
+      nowMilliseconds < pendingInterest->getTimeoutTimeMilliseconds()) {
+    // Only the transmission expired, which happens when this entry was aggregated with an earlier one.
+    sendOrAggregate(*pendingInterest, nowMilliseconds);
+    schedulePendingInterestTimer(pendingInterest);
+    return;
   }
+
+  // Remove the PendingInterest from the PIT, then call the callback.
+  erasePendingInterest(pendingInterest);
+  callTimeout(pendingInterest);
+}
+
+void
+Node::callOnData(const ptr_lib::shared_ptr<PendingInterest>& pendingInterest, const ptr_lib::shared_ptr<Data>& data)
+{
+  if (callbackExecutor_ && pendingInterest->getUseCallbackExecutor())
+    callbackExecutor_->execute
+      (func_lib::bind(pendingInterest->getOnData(), pendingInterest->getInterest(), data),
+       preserveCallbackOrder_ ? pendingInterest->getPendingInterestId() : 0);
+  else
+    pendingInterest->getOnData()(pendingInterest->getInterest(), data);
+}
+
+void
+Node::callTimeout(const ptr_lib::shared_ptr<PendingInterest>& pendingInterest)
+{
+  if (callbackExecutor_ && pendingInterest->getUseCallbackExecutor())
+    callbackExecutor_->execute
+      (func_lib::bind(&PendingInterest::callTimeout, pendingInterest),
+       preserveCallbackOrder_ ? pendingInterest->getPendingInterestId() : 0);
+  else
+    pendingInterest->callTimeout();
+}
+
+Node::PendingInterest*
+Node::getEntryWithLiveTransmission(PendingInterest& pendingInterest, MillisecondsSince1970 nowMilliseconds)
+{
+  // Identical interests have the same name, so only check the entries with exactly that name.
+  const vector<ptr_lib::shared_ptr<PendingInterest> > *candidates =
+    pendingInterestTable_->findAllWithKey(pendingInterest.getInterest()->getName());
+  if (!candidates)
+    return 0;
+
+  for (size_t i = 0; i < candidates->size(); ++i) {
+    PendingInterest *candidate = (*candidates)[i].get();
+    if (candidate == &pendingInterest)
+      continue;
+    MillisecondsSince1970 expireTime = candidate->getTransmissionExpireTimeMilliseconds();
+    if ((expireTime < 0.0 || expireTime > nowMilliseconds) && candidate->hasSameEncoding(pendingInterest))
+      return candidate;
+  }
+
+  return 0;
+}
+
+void
+Node::sendOrAggregate(PendingInterest& pendingInterest, MillisecondsSince1970 nowMilliseconds)
+{
+  PendingInterest *sender = getEntryWithLiveTransmission(pendingInterest, nowMilliseconds);
+  if (sender) {
+    // The forwarder still has the interest, so the data which satisfies the sender will also satisfy this entry.
+    pendingInterest.setTransmissionExpireTimeMilliseconds(sender->getTransmissionExpireTimeMilliseconds());
+    return;
+  }
+
+  transport_->send(pendingInterest.getEncoding());
+  if (pendingInterest.getInterest()->getInterestLifetimeMilliseconds() >= 0.0)
+    pendingInterest.setTransmissionExpireTimeMilliseconds
+      (nowMilliseconds + pendingInterest.getInterest()->getInterestLifetimeMilliseconds());
+  else
+    pendingInterest.setTransmissionExpireTimeMilliseconds(-1.0);
+}
+
+void
+Node::schedulePendingInterestTimer(const ptr_lib::shared_ptr<PendingInterest>& pendingInterest)
+{
+  MillisecondsSince1970 timerTime = pendingInterest->getTimeoutTimeMilliseconds();
+  MillisecondsSince1970 expireTime = pendingInterest->getTransmissionExpireTimeMilliseconds();
+  if (expireTime >= 0.0 && (timerTime < 0.0 || expireTime < timerTime))
+    timerTime = expireTime;
+
+  if (timerTime >= 0.0)
+    pendingInterest->setTimerId(timerQueue_->schedule
+      (timerTime, func_lib::bind(&Node::timeoutPendingInterest, this, pendingInterest)));
+  else
+    pendingInterest->setTimerId(0);
+}
+
+bool
+Node::erasePendingInterest(const ptr_lib::shared_ptr<PendingInterest>& pendingInterest)
+{
+  if (pendingInterestsById_.erase(pendingInterest->getPendingInterestId()) == 0)
+    return false;
+
+  pendingInterestTable_->remove(pendingInterest->getInterest()->getName(), pendingInterest);
+  timerQueue_->cancel(pendingInterest->getTimerId());
+  return true;
 }
 
 void 
 Node::onReceivedElement(const uint8_t *element, size_t elementLength)
 {
+  ++nReceivedElements_;
+  // First decode only the name in place to look up the registered prefix or pending interest.  Only copy and fully
+  // decode the element if there is a callback to receive it, so that an unmatched element is dropped without copying
+  // or decoding the rest of it.
+  struct ndn_NameComponent nameComponents[100];
+  struct ndn_Name nameStruct;
+  ndn_Name_initialize(&nameStruct, nameComponents, sizeof(nameComponents) / sizeof(nameComponents[0]));
   BinaryXmlDecoder decoder(element, elementLength);
-  
+  ndn_Error error;
   if (decoder.peekDTag(ndn_BinaryXml_DTag_Interest)) {
-    ptr_lib::shared_ptr<Interest> interest(new Interest());
-    interest->wireDecode(element, elementLength);
-    
-    RegisteredPrefix *entry = getEntryForRegisteredPrefix(interest->getName());
-    if (entry)
-      entry->getOnInterest()(entry->getPrefix(), interest, *transport_, entry->getRegisteredPrefixId());
+    if ((error = ndn_decodeBinaryXmlInterestName(&nameStruct, &decoder)))
+      throw runtime_error(ndn_getErrorString(error));
+    Name name;
+    name.set(nameStruct);
+    if (producerStore_) {
+      // Checking the interest selectors needs the whole interest.  The name components are already copied into name,
+      // so the decoder can reuse nameComponents.
+      struct ndn_ExcludeEntry excludeEntries[100];
+      struct ndn_Interest interestStruct;
+      ndn_Interest_initialize
+        (&interestStruct, nameComponents, sizeof(nameComponents) / sizeof(nameComponents[0]),
+         excludeEntries, sizeof(excludeEntries) / sizeof(excludeEntries[0]));
+      BinaryXmlDecoder interestDecoder(element, elementLength);
+      if ((error = ndn_decodeBinaryXmlInterest(&interestStruct, &interestDecoder)))
+        throw runtime_error(ndn_getErrorString(error));
+      Blob encoding = producerStore_->findEncoding(name, interestStruct, ndn_getNowMilliseconds());
+      if (encoding) {
+        ++nProducerStoreHits_;
+        transport_->send(encoding);
+        return;
+      }
+      ++nProducerStoreMisses_;
+    }
+
+    RegisteredPrefix *entry = getEntryForRegisteredPrefix(name);
+    if (entry) {
+      ptr_lib::shared_ptr<Interest> interest(new Interest());
+      // This copies the element once, and the decoded fields are slices of the copy.
+      interest->wireDecode(element, elementLength);
+      if (callbackExecutor_)
+        callbackExecutor_->execute
+          (func_lib::bind(entry->getOnInterest(), entry->getPrefix(), interest, func_lib::ref(*queueingTransport_),
+                          entry->getRegisteredPrefixId()),
+           preserveCallbackOrder_ ? entry->getRegisteredPrefixId() : 0);
+      else
+        entry->getOnInterest()(entry->getPrefix(), interest, *transport_, entry->getRegisteredPrefixId());
+    }
   }
   else if (decoder.peekDTag(ndn_BinaryXml_DTag_ContentObject)) {
-    ptr_lib::shared_ptr<Data> data(new Data());
-    data->wireDecode(element, elementLength);
-    
-    int iPitEntry = getEntryIndexForExpressedInterest(data->getName());
-    if (iPitEntry >= 0) {
-      // Copy pointers to the needed objects and remove the PIT entry before the calling the callback.
-      const OnData onData = pendingInterestTable_[iPitEntry]->getOnData();
-      const ptr_lib::shared_ptr<const Interest> interest = pendingInterestTable_[iPitEntry]->getInterest();
-      pendingInterestTable_.erase(pendingInterestTable_.begin() + iPitEntry);
-      onData(interest, data);
+    if ((error = ndn_decodeBinaryXmlDataName(&nameStruct, &decoder)))
+      throw runtime_error(ndn_getErrorString(error));
+    Name name;
+    name.set(nameStruct);
+    vector<ptr_lib::shared_ptr<PendingInterest> > pendingInterests;
+    getEntriesForExpressedInterest(name, nameStruct, pendingInterests);
+    if (pendingInterests.size() > 0) {
+      // Copy the element once so that the fields decoded from it are slices of the copy.
+      Blob elementBlob(element, elementLength);
+      ptr_lib::shared_ptr<Data> data(new Data());
+      data->wireDecode(elementBlob);
+      if (contentStore_)
+        // The store keeps elementBlob, not data, which the application may change.
+        contentStore_->add(*data, elementBlob, ndn_getNowMilliseconds());
+      // Remove all the entries before calling any callback, so that an interest which a callback expresses again
+      // is not satisfied by this data.
+      for (size_t i = 0; i < pendingInterests.size(); ++i)
+        erasePendingInterest(pendingInterests[i]);
+      for (size_t i = 0; i < pendingInterests.size(); ++i) {
+        if (i > 0) {
+          // Give each callback its own Data since a callback (maybe on another thread) may change it.  The fields
+          // are slices of elementBlob, so decoding again doesn't copy the content.
+          data.reset(new Data());
+          data->wireDecode(elementBlob);
+        }
+        callOnData(pendingInterests[i], data);
+      }
     }
   }
 }
@@ -287,55 +821,38 @@ Node::shutdown()
   transport_->close();
 }
 
-int 
-Node::getEntryIndexForExpressedInterest(const Name& name)
+void
+Node::getEntriesForExpressedInterest
+  (const Name& name, const struct ndn_Name& nameStruct, vector<ptr_lib::shared_ptr<PendingInterest> >& entries)
 {
-  // TODO: Doesn't this belong in the Name class?
-  vector<struct ndn_NameComponent> nameComponents;
-  nameComponents.reserve(name.size());
-  struct ndn_Name nameStruct;
-  ndn_Name_initialize(&nameStruct, &nameComponents[0], nameComponents.capacity());
-  name.get(nameStruct);
+  // Only the entries whose interest name is a prefix of name can match, so check the selectors of just those.
+  vector<ptr_lib::shared_ptr<PendingInterest> > candidates;
+  pendingInterestTable_->findAllPrefixesOf(name, candidates);
   
-  int iResult = -1;
-    
-  for (size_t i = 0; i < pendingInterestTable_.size(); ++i) {
-    if (ndn_Interest_matchesName((struct ndn_Interest *)&pendingInterestTable_[i]->getInterestStruct(), &nameStruct)) {
-      if (iResult < 0 || 
-          pendingInterestTable_[i]->getInterestStruct().name.nComponents > 
-          pendingInterestTable_[iResult]->getInterestStruct().name.nComponents)
-        // Update to the longer match.
-        iResult = i;
-    }
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    if (ndn_Interest_matchesName((struct ndn_Interest *)&candidates[i]->getInterestStruct(), (struct ndn_Name *)&nameStruct))
+      entries.push_back(candidates[i]);
   }
-    
-  return iResult;
 }
   
 Node::RegisteredPrefix*
 Node::getEntryForRegisteredPrefix(const Name& name)
 {
-  int iResult = -1;
-    
-  for (size_t i = 0; i < registeredPrefixTable_.size(); ++i) {
-    if (registeredPrefixTable_[i]->getPrefix()->match(name)) {
-      if (iResult < 0 || 
-          registeredPrefixTable_[i]->getPrefix()->size() > registeredPrefixTable_[iResult]->getPrefix()->size())
-        // Update to the longer match.
-        iResult = i;
-    }
-  }
-    
-  if (iResult >= 0)
-    return registeredPrefixTable_[iResult].get();
-  else
+  // The entries whose prefix matches name are exactly the ones stored under a prefix of name.  If more than one
+  // entry has the longest prefix, use the one registered first.
+  vector<ptr_lib::shared_ptr<RegisteredPrefix> > candidates;
+  if (!registeredPrefixTable_->findLongestPrefixOf(name, candidates))
     return 0;
+    
+  return candidates[0].get();
 }
 
 Node::PendingInterest::PendingInterest
-  (uint64_t pendingInterestId, const ptr_lib::shared_ptr<const Interest>& interest, const OnData& onData, const OnTimeout& onTimeout)
-: pendingInterestId_(pendingInterestId), interest_(interest), onData_(onData), onTimeout_(onTimeout),
-  interestStruct_(new struct ndn_Interest)
+  (uint64_t pendingInterestId, const ptr_lib::shared_ptr<const Interest>& interest, const Blob& encoding,
+   const OnData& onData, const OnTimeout& onTimeout)
+: pendingInterestId_(pendingInterestId), interest_(interest), encoding_(encoding), onData_(onData),
+  onTimeout_(onTimeout), interestStruct_(new struct ndn_Interest), transmissionExpireTimeMilliseconds_(-1.0), timerId_(0),
+  useCallbackExecutor_(true)
 {
   // Set up timeoutTime_.
   if (interest_->getInterestLifetimeMilliseconds() >= 0.0)
@@ -353,6 +870,13 @@ Node::PendingInterest::PendingInterest
   interest_->get(*interestStruct_);  
 }
 
+bool
+Node::PendingInterest::hasSameEncoding(PendingInterest& other)
+{
+  return encoding_.size() == other.encoding_.size() &&
+         (encoding_.buf() == other.encoding_.buf() || ::memcmp(encoding_.buf(), other.encoding_.buf(), encoding_.size()) == 0);
+}
+
 void 
 Node::PendingInterest::callTimeout()
 {
@@ -19,9 +19,10 @@ PublisherPublicKeyDigest::get(struct ndn_PublisherPublicKeyDigest& publisherPubl
 }
 
 void 
-PublisherPublicKeyDigest::set(const struct ndn_PublisherPublicKeyDigest& publisherPublicKeyDigestStruct) 
+PublisherPublicKeyDigest::set
+  (const struct ndn_PublisherPublicKeyDigest& publisherPublicKeyDigestStruct, const Blob& buffer) 
 {
-  publisherPublicKeyDigest_ = Blob(publisherPublicKeyDigestStruct.publisherPublicKeyDigest);
+  publisherPublicKeyDigest_ = Blob(publisherPublicKeyDigestStruct.publisherPublicKeyDigest, buffer);
 }
 
 }
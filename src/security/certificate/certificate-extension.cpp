@@ -21,7 +21,8 @@ CertificateExtension::toDer() const
     
   ptr_lib::shared_ptr<der::DerOid> extensionId(new der::DerOid(extensionId_));
   ptr_lib::shared_ptr<der::DerBool> isCritical(new der::DerBool(isCritical_));
-  ptr_lib::shared_ptr<der::DerOctetString> extensionValue(new der::DerOctetString(*extensionValue_));
+  ptr_lib::shared_ptr<der::DerOctetString> extensionValue(new der::DerOctetString
+    (vector<uint8_t>(extensionValue_.buf(), extensionValue_.buf() + extensionValue_.size())));
 
   root->addChild(extensionId);
   root->addChild(isCritical);
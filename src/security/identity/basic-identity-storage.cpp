@@ -411,7 +411,7 @@ BasicIdentityStorage::addCertificate(const IdentityCertificate& certificate)
  
   Blob keyBlob = getKey(keyName);
   
-  if (!keyBlob || (*keyBlob) != *(certificate.getPublicKeyInfo().getKeyDer()))
+  if (!keyBlob || !keyBlob.equals(certificate.getPublicKeyInfo().getKeyDer()))
     throw SecurityException("Certificate does not match the public key!");
 
   // Insert the certificate
@@ -49,7 +49,7 @@ MemoryIdentityStorage::revokeIdentity()
 bool 
 MemoryIdentityStorage::doesKeyExist(const Name& keyName)
 {
-  return keyStore_.find(keyName.toUri()) != keyStore_.end();
+  return keyStore_.find(keyName) != keyStore_.end();
 }
 
 void 
@@ -63,13 +63,13 @@ MemoryIdentityStorage::addKey(const Name& keyName, KeyType keyType, const Blob&
   if (doesKeyExist(keyName))
     throw SecurityException("a key with the same name already exists!");
   
-  keyStore_[keyName.toUri()] = ptr_lib::make_shared<KeyRecord>(keyType, publicKeyDer);
+  keyStore_[keyName] = ptr_lib::make_shared<KeyRecord>(keyType, publicKeyDer);
 }
 
 Blob
 MemoryIdentityStorage::getKey(const Name& keyName)
 {
-  map<string, ptr_lib::shared_ptr<KeyRecord> >::iterator record = keyStore_.find(keyName.toUri());
+  map<Name, ptr_lib::shared_ptr<KeyRecord> >::iterator record = keyStore_.find(keyName);
   if (record == keyStore_.end())
     // Not found.  Silently return null.
     return Blob();
@@ -96,7 +96,7 @@ MemoryIdentityStorage::deactivateKey(const Name& keyName)
 bool
 MemoryIdentityStorage::doesCertificateExist(const Name& certificateName)
 {
-  return certificateStore_.find(certificateName.toUri()) != certificateStore_.end();
+  return certificateStore_.find(certificateName) != certificateStore_.end();
 }
 
 void 
@@ -114,25 +114,25 @@ MemoryIdentityStorage::addCertificate(const IdentityCertificate& certificate)
 
   // Check if the public key of certificate is the same as the key record. 
   Blob keyBlob = getKey(keyName);
-  if (!keyBlob || (*keyBlob) != *(certificate.getPublicKeyInfo().getKeyDer()))
+  if (!keyBlob || !keyBlob.equals(certificate.getPublicKeyInfo().getKeyDer()))
     throw SecurityException("Certificate does not match the public key!");
   
   // Insert the certificate.
   if (!certificate.getDefaultWireEncoding())
     certificate.wireEncode();
-  certificateStore_[certificateName.toUri()] = certificate.getDefaultWireEncoding();
+  certificateStore_[certificateName] = certificate.getDefaultWireEncoding();
 }
 
 ptr_lib::shared_ptr<Data> 
 MemoryIdentityStorage::getCertificate(const Name& certificateName, bool allowAny)
 {
-  map<string, Blob>::iterator record = certificateStore_.find(certificateName.toUri());
+  map<Name, Blob>::iterator record = certificateStore_.find(certificateName);
   if (record == certificateStore_.end())
     // Not found.  Silently return null.
     return ptr_lib::shared_ptr<Data>();
   
   ptr_lib::shared_ptr<Data> data(new Data());
-  data->wireDecode(*record->second);
+  data->wireDecode(record->second);
   return data;
 }
 
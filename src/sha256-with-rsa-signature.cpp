@@ -31,11 +31,17 @@ Sha256WithRsaSignature::get(struct ndn_Signature& signatureStruct) const
 void 
 Sha256WithRsaSignature::set(const struct ndn_Signature& signatureStruct)
 {
-  digestAlgorithm_ = Blob(signatureStruct.digestAlgorithm);
-  witness_ = Blob(signatureStruct.witness);
-  signature_ = Blob(signatureStruct.signature);
-  publisherPublicKeyDigest_.set(signatureStruct.publisherPublicKeyDigest);
-  keyLocator_.set(signatureStruct.keyLocator);
+  set(signatureStruct, Blob());
+}
+
+void 
+Sha256WithRsaSignature::set(const struct ndn_Signature& signatureStruct, const Blob& buffer)
+{
+  digestAlgorithm_ = Blob(signatureStruct.digestAlgorithm, buffer);
+  witness_ = Blob(signatureStruct.witness, buffer);
+  signature_ = Blob(signatureStruct.signature, buffer);
+  publisherPublicKeyDigest_.set(signatureStruct.publisherPublicKeyDigest, buffer);
+  keyLocator_.set(signatureStruct.keyLocator, buffer);
 }
 
 }
@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <stdexcept>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <ndn-cpp/ndn-cpp-config.h>
+#if NDN_CPP_HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#endif
+#include <ndn-cpp/encoding/element-listener.hpp>
+#include <ndn-cpp/transport/mini-forwarder.hpp>
+#include <ndn-cpp/transport/loopback-transport.hpp>
+
+using namespace std;
+
+namespace ndn {
+
+LoopbackTransport::ConnectionInfo::~ConnectionInfo()
+{
+}
+
+LoopbackTransport::LoopbackTransport()
+  : faceId_(0), elementListener_(0), wakeupReadFileDescriptor_(-1), wakeupWriteFileDescriptor_(-1)
+{
+  // Keep the same file descriptor when reconnecting, so that a poller which waits on it doesn't need to change.
+#if NDN_CPP_HAVE_SYS_EVENTFD_H
+  int fileDescriptor = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (fileDescriptor < 0)
+    throw runtime_error(string("LoopbackTransport: eventfd failed: ") + ::strerror(errno));
+  wakeupReadFileDescriptor_ = fileDescriptor;
+  wakeupWriteFileDescriptor_ = fileDescriptor;
+#else
+  int fileDescriptors[2];
+  if (::pipe(fileDescriptors) < 0)
+    throw runtime_error(string("LoopbackTransport: pipe failed: ") + ::strerror(errno));
+  for (int i = 0; i < 2; ++i) {
+    ::fcntl(fileDescriptors[i], F_SETFL, ::fcntl(fileDescriptors[i], F_GETFL) | O_NONBLOCK);
+    ::fcntl(fileDescriptors[i], F_SETFD, FD_CLOEXEC);
+  }
+  wakeupReadFileDescriptor_ = fileDescriptors[0];
+  wakeupWriteFileDescriptor_ = fileDescriptors[1];
+#endif
+}
+
+void
+LoopbackTransport::connect(const Transport::ConnectionInfo& connectionInfo, ElementListener& elementListener)
+{
+  const LoopbackTransport::ConnectionInfo& loopbackConnectionInfo =
+    dynamic_cast<const LoopbackTransport::ConnectionInfo&>(connectionInfo);
+
+  close();
+  forwarder_ = loopbackConnectionInfo.getForwarder();
+  faceId_ = forwarder_->addFace(this);
+  elementListener_ = &elementListener;
+}
+
+void
+LoopbackTransport::send(const uint8_t *data, size_t dataLength)
+{
+  send(Blob(data, dataLength));
+}
+
+void
+LoopbackTransport::send(const Blob& data)
+{
+  if (!forwarder_)
+    throw runtime_error("LoopbackTransport is not connected");
+
+  forwarder_->onReceivedElement(faceId_, data);
+}
+
+void
+LoopbackTransport::processEvents()
+{
+  if (receiveQueue_.size() == 0)
+    return;
+
+  // Swap so that a callback which sends to this face adds to an empty receiveQueue_, which makes the file descriptor
+  // readable again.  Reuse the vectors' memory.
+  clearWakeup();
+  processingQueue_.clear();
+  processingQueue_.swap(receiveQueue_);
+  for (size_t i = 0; i < processingQueue_.size(); ++i) {
+    if (!elementListener_)
+      // A callback closed the transport.
+      break;
+    elementListener_->onReceivedElement(processingQueue_[i].buf(), processingQueue_[i].size());
+  }
+  processingQueue_.clear();
+}
+
+bool
+LoopbackTransport::getIsConnected()
+{
+  return forwarder_ ? true : false;
+}
+
+int
+LoopbackTransport::getFileDescriptor()
+{
+  return forwarder_ ? wakeupReadFileDescriptor_ : -1;
+}
+
+void
+LoopbackTransport::receive(const Blob& element)
+{
+  receiveQueue_.push_back(element);
+  if (receiveQueue_.size() == 1) {
+    // Only the first element since the last processEvents needs to write to the wakeup.
+#if NDN_CPP_HAVE_SYS_EVENTFD_H
+    uint64_t value = 1;
+#else
+    uint8_t value = 1;
+#endif
+    // Ignore the result.  If the pipe is full, then it is already readable.
+    ssize_t result = ::write(wakeupWriteFileDescriptor_, &value, sizeof(value));
+    (void)result;
+  }
+}
+
+void
+LoopbackTransport::clearWakeup()
+{
+  uint8_t buffer[64];
+  while (::read(wakeupReadFileDescriptor_, buffer, sizeof(buffer)) > 0) {
+  }
+}
+
+void
+LoopbackTransport::close()
+{
+  if (forwarder_) {
+    forwarder_->removeFace(faceId_);
+    forwarder_.reset();
+  }
+  elementListener_ = 0;
+  receiveQueue_.clear();
+  clearWakeup();
+}
+
+LoopbackTransport::~LoopbackTransport()
+{
+  if (forwarder_)
+    forwarder_->removeFace(faceId_);
+  if (wakeupWriteFileDescriptor_ != wakeupReadFileDescriptor_)
+    ::close(wakeupWriteFileDescriptor_);
+  ::close(wakeupReadFileDescriptor_);
+}
+
+}
@@ -0,0 +1,330 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string.h>
+#include "../c/name.h"
+#include "../c/interest.h"
+#include "../c/util/crypto.h"
+#include "../c/util/time.h"
+#include "../encoding/binary-xml-decoder.hpp"
+#include "../util/name-trie.hpp"
+#include "../util/timer-queue.hpp"
+#include <ndn-cpp/data.hpp>
+#include <ndn-cpp/interest.hpp>
+#include <ndn-cpp/forwarding-entry.hpp>
+#include <ndn-cpp/sha256-with-rsa-signature.hpp>
+#include <ndn-cpp/transport/loopback-transport.hpp>
+#include <ndn-cpp/transport/mini-forwarder.hpp>
+
+using namespace std;
+
+namespace ndn {
+
+/**
+ * A PitEntry holds an interest which was forwarded and the faces which are waiting for the data.
+ */
+class MiniForwarder::PitEntry {
+public:
+  PitEntry(const ptr_lib::shared_ptr<const Interest>& interest, uint64_t faceId)
+  : timerId_(0), expireTimeMilliseconds_(0), interest_(interest), interestStruct_(new struct ndn_Interest)
+  {
+    faceIds_.push_back(faceId);
+
+    // Set up interestStruct_ for ndn_Interest_matchesName.  An empty vector has no element 0, so pass 0.
+    nameComponents_.resize(interest_->getName().size());
+    excludeEntries_.resize(interest_->getExclude().size());
+    ndn_Interest_initialize
+      (interestStruct_.get(), nameComponents_.empty() ? 0 : &nameComponents_[0], nameComponents_.size(),
+       excludeEntries_.empty() ? 0 : &excludeEntries_[0], excludeEntries_.size());
+    interest_->get(*interestStruct_);
+  }
+
+  const Interest&
+  getInterest() const { return *interest_; }
+
+  struct ndn_Interest&
+  getInterestStruct() { return *interestStruct_; }
+
+  std::vector<uint64_t> faceIds_; /**< The faces which sent the interest. */
+  uint64_t timerId_;
+  MillisecondsSince1970 expireTimeMilliseconds_;
+
+private:
+  ptr_lib::shared_ptr<const Interest> interest_;
+  std::vector<struct ndn_NameComponent> nameComponents_;
+  std::vector<struct ndn_ExcludeEntry> excludeEntries_;
+  ptr_lib::shared_ptr<struct ndn_Interest> interestStruct_;
+};
+
+/**
+ * Return true if the blobs have the same bytes.
+ */
+static bool
+blobsEqual(const Blob& blob1, const Blob& blob2)
+{
+  return blob1.size() == blob2.size() && (blob1.size() == 0 || memcmp(blob1.buf(), blob2.buf(), blob1.size()) == 0);
+}
+
+/**
+ * Return true if the interests have the same selectors, ignoring the nonce and the interest lifetime.
+ */
+static bool
+hasSameSelectors(const Interest& interest1, const Interest& interest2)
+{
+  return interest1.getMinSuffixComponents() == interest2.getMinSuffixComponents() &&
+         interest1.getMaxSuffixComponents() == interest2.getMaxSuffixComponents() &&
+         interest1.getChildSelector() == interest2.getChildSelector() &&
+         interest1.getAnswerOriginKind() == interest2.getAnswerOriginKind() &&
+         interest1.getScope() == interest2.getScope() &&
+         blobsEqual(interest1.getPublisherPublicKeyDigest().getPublisherPublicKeyDigest(),
+                    interest2.getPublisherPublicKeyDigest().getPublisherPublicKeyDigest()) &&
+         interest1.getExclude().size() == interest2.getExclude().size() &&
+         (interest1.getExclude().size() == 0 || interest1.getExclude().toUri() == interest2.getExclude().toUri());
+}
+
+MiniForwarder::MiniForwarder()
+: ndndIdName_("/%C1.M.S.localhost/%C1.M.SRV/ndnd/KEY"), lastFaceId_(0),
+  fib_(new NameTrie<ptr_lib::shared_ptr<FibEntry> >()), pit_(new NameTrie<ptr_lib::shared_ptr<PitEntry> >()),
+  timerQueue_(new TimerQueue())
+{
+  // Make an ndndId which is different for each forwarder.
+  ostringstream seed;
+  seed << "MiniForwarder " << (void *)this << " " << ndn_getNowMilliseconds();
+  uint8_t ndndId[SHA256_DIGEST_LENGTH];
+  ndn_digestSha256((const uint8_t *)seed.str().c_str(), seed.str().size(), ndndId);
+  ndndId_ = Blob(ndndId, sizeof(ndndId));
+
+  // Node only checks the publisher public key digest of the answer to the ndndId request, so there is no key to sign.
+  Data ndndIdData(ndndIdName_);
+  Sha256WithRsaSignature signature;
+  signature.getPublisherPublicKeyDigest().setPublisherPublicKeyDigest(ndndId_);
+  ndndIdData.setSignature(signature);
+  ndndIdDataEncoding_ = ndndIdData.wireEncode();
+
+  const uint8_t ndnx[] = "ndnx";
+  const uint8_t selfreg[] = "selfreg";
+  selfregPrefix_.append(ndnx, sizeof(ndnx) - 1);
+  selfregPrefix_.append(ndndId_);
+  selfregPrefix_.append(selfreg, sizeof(selfreg) - 1);
+}
+
+size_t
+MiniForwarder::getPitSize() const
+{
+  return pit_->size();
+}
+
+size_t
+MiniForwarder::getFibSize() const
+{
+  return fib_->size();
+}
+
+uint64_t
+MiniForwarder::addFace(LoopbackTransport *transport)
+{
+  uint64_t faceId = ++lastFaceId_;
+  faces_[faceId] = transport;
+  return faceId;
+}
+
+void
+MiniForwarder::removeFace(uint64_t faceId)
+{
+  faces_.erase(faceId);
+
+  vector<ptr_lib::shared_ptr<FibEntry> > fibEntries;
+  fib_->getAll(fibEntries);
+  for (size_t i = 0; i < fibEntries.size(); ++i) {
+    if (fibEntries[i]->faceId_ == faceId)
+      fib_->remove(fibEntries[i]->prefix_, fibEntries[i]);
+  }
+  // A PIT entry may still have the face, but sendToFace ignores a removed face.
+}
+
+void
+MiniForwarder::onReceivedElement(uint64_t faceId, const Blob& element)
+{
+  timerQueue_->callExpired(ndn_getNowMilliseconds());
+
+  try {
+    BinaryXmlDecoder decoder(element.buf(), element.size());
+    if (decoder.peekDTag(ndn_BinaryXml_DTag_Interest))
+      onReceivedInterest(faceId, element);
+    else if (decoder.peekDTag(ndn_BinaryXml_DTag_ContentObject))
+      onReceivedData(faceId, element);
+  }
+  catch (std::exception& e) {
+    // Drop a malformed element like a forwarder would, instead of throwing it back to the sender.
+  }
+}
+
+void
+MiniForwarder::onReceivedInterest(uint64_t faceId, const Blob& element)
+{
+  ptr_lib::shared_ptr<Interest> interest(new Interest());
+  interest->wireDecode(element);
+  const Name& name = interest->getName();
+
+  if (name.size() == ndndIdName_.size() && ndndIdName_.match(name)) {
+    sendToFace(faceId, ndndIdDataEncoding_);
+    return;
+  }
+  if (name.size() == selfregPrefix_.size() + 1 && selfregPrefix_.match(name)) {
+    registerPrefix(faceId, *interest);
+    return;
+  }
+
+  MillisecondsSince1970 expireTimeMilliseconds = ndn_getNowMilliseconds() +
+    (interest->getInterestLifetimeMilliseconds() >= 0.0 ? interest->getInterestLifetimeMilliseconds() : 4000.0);
+
+  // Look for a PIT entry with the same interest.  Entries with the same name as the interest are last.
+  vector<ptr_lib::shared_ptr<PitEntry> > pitEntries;
+  pit_->findAllPrefixesOf(name, pitEntries);
+  ptr_lib::shared_ptr<PitEntry> pitEntry;
+  for (int i = (int)pitEntries.size() - 1; i >= 0; --i) {
+    if (pitEntries[i]->getInterest().getName().size() != name.size())
+      break;
+    if (hasSameSelectors(*interest, pitEntries[i]->getInterest())) {
+      pitEntry = pitEntries[i];
+      break;
+    }
+  }
+
+  if (pitEntry) {
+    if (expireTimeMilliseconds > pitEntry->expireTimeMilliseconds_) {
+      timerQueue_->cancel(pitEntry->timerId_);
+      pitEntry->expireTimeMilliseconds_ = expireTimeMilliseconds;
+      pitEntry->timerId_ = timerQueue_->schedule
+        (expireTimeMilliseconds, func_lib::bind(&MiniForwarder::expirePitEntry, this, pitEntry));
+    }
+
+    bool isNewFace = true;
+    for (size_t i = 0; i < pitEntry->faceIds_.size(); ++i) {
+      if (pitEntry->faceIds_[i] == faceId) {
+        isNewFace = false;
+        break;
+      }
+    }
+    if (isNewFace) {
+      // Aggregate the interest into the entry which was already forwarded.
+      pitEntry->faceIds_.push_back(faceId);
+      return;
+    }
+    // Otherwise, the face sent the interest again, so forward it again.
+  }
+
+  // Find the other faces with the longest registered prefix of the name.  Entries with longer prefixes are last.
+  vector<ptr_lib::shared_ptr<FibEntry> > fibEntries;
+  fib_->findAllPrefixesOf(name, fibEntries);
+  vector<uint64_t> outFaceIds;
+  size_t prefixSize = 0;
+  for (int i = (int)fibEntries.size() - 1; i >= 0; --i) {
+    if (fibEntries[i]->faceId_ == faceId)
+      continue;
+    if (outFaceIds.size() > 0 && fibEntries[i]->prefix_.size() < prefixSize)
+      break;
+
+    prefixSize = fibEntries[i]->prefix_.size();
+    if (find(outFaceIds.begin(), outFaceIds.end(), fibEntries[i]->faceId_) == outFaceIds.end())
+      outFaceIds.push_back(fibEntries[i]->faceId_);
+  }
+  if (outFaceIds.size() == 0)
+    // There is no route, so drop the interest and let it time out at the sender.
+    return;
+
+  if (!pitEntry) {
+    pitEntry.reset(new PitEntry(interest, faceId));
+    pitEntry->expireTimeMilliseconds_ = expireTimeMilliseconds;
+    pitEntry->timerId_ = timerQueue_->schedule
+      (expireTimeMilliseconds, func_lib::bind(&MiniForwarder::expirePitEntry, this, pitEntry));
+    pit_->insert(name, pitEntry);
+  }
+
+  for (size_t i = 0; i < outFaceIds.size(); ++i)
+    sendToFace(outFaceIds[i], element);
+}
+
+void
+MiniForwarder::onReceivedData(uint64_t faceId, const Blob& element)
+{
+  Data data;
+  data.wireDecode(element);
+  const Name& name = data.getName();
+
+  vector<struct ndn_NameComponent> nameComponents(name.size());
+  struct ndn_Name nameStruct;
+  ndn_Name_initialize(&nameStruct, nameComponents.empty() ? 0 : &nameComponents[0], nameComponents.size());
+  name.get(nameStruct);
+
+  // Only the entries whose interest name is a prefix of name can match, so check the selectors of just those.
+  vector<ptr_lib::shared_ptr<PitEntry> > pitEntries;
+  pit_->findAllPrefixesOf(name, pitEntries);
+  vector<uint64_t> outFaceIds;
+  for (size_t i = 0; i < pitEntries.size(); ++i) {
+    if (!ndn_Interest_matchesName(&pitEntries[i]->getInterestStruct(), &nameStruct))
+      continue;
+
+    for (size_t j = 0; j < pitEntries[i]->faceIds_.size(); ++j) {
+      uint64_t outFaceId = pitEntries[i]->faceIds_[j];
+      if (outFaceId != faceId && find(outFaceIds.begin(), outFaceIds.end(), outFaceId) == outFaceIds.end())
+        outFaceIds.push_back(outFaceId);
+    }
+    timerQueue_->cancel(pitEntries[i]->timerId_);
+    pit_->remove(pitEntries[i]->getInterest().getName(), pitEntries[i]);
+  }
+
+  for (size_t i = 0; i < outFaceIds.size(); ++i)
+    sendToFace(outFaceIds[i], element);
+}
+
+void
+MiniForwarder::registerPrefix(uint64_t faceId, const Interest& interest)
+{
+  // The last component is the encoded Data packet whose content is the ForwardingEntry.
+  const Blob& encodedData = interest.getName().get(selfregPrefix_.size()).getValue();
+  Data data;
+  data.wireDecode(encodedData);
+  ForwardingEntry forwardingEntry;
+  forwardingEntry.wireDecode(data.getContent().buf(), data.getContent().size());
+  if (forwardingEntry.getAction() != "selfreg")
+    return;
+  const Name& prefix = forwardingEntry.getPrefix();
+
+  // Don't add the same prefix twice for the face.
+  vector<ptr_lib::shared_ptr<FibEntry> > fibEntries;
+  fib_->findAllPrefixesOf(prefix, fibEntries);
+  for (size_t i = 0; i < fibEntries.size(); ++i) {
+    if (fibEntries[i]->faceId_ == faceId && fibEntries[i]->prefix_.size() == prefix.size())
+      return;
+  }
+
+  fib_->insert(prefix, ptr_lib::make_shared<FibEntry>(prefix, faceId));
+}
+
+void
+MiniForwarder::sendToFace(uint64_t faceId, const Blob& element)
+{
+  map<uint64_t, LoopbackTransport*>::iterator face = faces_.find(faceId);
+  if (face != faces_.end())
+    face->second->receive(element);
+}
+
+void
+MiniForwarder::expirePitEntry(const ptr_lib::shared_ptr<PitEntry>& pitEntry)
+{
+  pit_->remove(pitEntry->getInterest().getName(), pitEntry);
+}
+
+MiniForwarder::~MiniForwarder()
+{
+}
+
+}
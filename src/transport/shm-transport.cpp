@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <stdexcept>
+#include <stdlib.h>
+#include <ndn-cpp/node.hpp>
+#include "../c/transport/shm-transport.h"
+#include "../c/encoding/binary-xml-element-reader.h"
+#include "../c/util/ndn_realloc.h"
+#include <ndn-cpp/transport/shm-transport.hpp>
+
+using namespace std;
+
+namespace ndn {
+
+ShmTransport::ConnectionInfo::~ConnectionInfo()
+{
+}
+
+ShmTransport::ShmTransport()
+  : transport_(new struct ndn_ShmTransport), isConnected_(false), elementReader_(new struct ndn_BinaryXmlElementReader)
+{
+  ndn_ShmTransport_initialize(transport_.get());
+  elementReader_->partialData.array = 0;
+}
+
+void
+ShmTransport::connect(const Transport::ConnectionInfo& connectionInfo, ElementListener& elementListener)
+{
+  const ShmTransport::ConnectionInfo& shmConnectionInfo = dynamic_cast<const ShmTransport::ConnectionInfo&>(connectionInfo);
+
+  sendQueue_.clear();
+  ndn_Error error;
+  if (shmConnectionInfo.getIsListener())
+    error = ndn_ShmTransport_listen
+      (transport_.get(), (char *)shmConnectionInfo.getFilePath().c_str(), shmConnectionInfo.getRingCapacity());
+  else
+    error = ndn_ShmTransport_connect(transport_.get(), (char *)shmConnectionInfo.getFilePath().c_str());
+  if (error)
+    throw runtime_error(ndn_getErrorString(error));
+
+  if (!elementReader_->partialData.array) {
+    const size_t initialLength = 1000;
+    // Automatically cast elementReader_ to (struct ndn_ElementListener *)
+    ndn_BinaryXmlElementReader_initialize
+      (elementReader_.get(), &elementListener, (uint8_t *)malloc(initialLength), initialLength, ndn_realloc);
+  }
+  else
+    // Reuse partialData from the previous connection.
+    ndn_BinaryXmlElementReader_initialize
+      (elementReader_.get(), &elementListener, elementReader_->partialData.array, elementReader_->partialData.length,
+       ndn_realloc);
+
+  isConnected_ = true;
+}
+
+void
+ShmTransport::send(const uint8_t *data, size_t dataLength)
+{
+  if (sendQueue_.size() == 0) {
+    ndn_Error error;
+    int isSent;
+    if ((error = ndn_ShmTransport_send(transport_.get(), (uint8_t *)data, dataLength, &isSent)))
+      throw runtime_error(ndn_getErrorString(error));
+    if (isSent)
+      return;
+  }
+
+  sendQueue_.push_back(Blob(data, dataLength));
+}
+
+void
+ShmTransport::send(const Blob& data)
+{
+  if (sendQueue_.size() == 0) {
+    ndn_Error error;
+    int isSent;
+    if ((error = ndn_ShmTransport_send(transport_.get(), (uint8_t *)data.buf(), data.size(), &isSent)))
+      throw runtime_error(ndn_getErrorString(error));
+    if (isSent)
+      return;
+  }
+
+  sendQueue_.push_back(data);
+}
+
+void
+ShmTransport::flushSendQueue()
+{
+  while (sendQueue_.size() > 0) {
+    ndn_Error error;
+    int isSent;
+    if ((error = ndn_ShmTransport_send
+         (transport_.get(), (uint8_t *)sendQueue_.front().buf(), sendQueue_.front().size(), &isSent))) {
+      sendQueue_.clear();
+      throw runtime_error(ndn_getErrorString(error));
+    }
+    if (!isSent)
+      // The ring is full.  The other process will signal when it frees space.
+      return;
+
+    sendQueue_.pop_front();
+  }
+}
+
+void
+ShmTransport::processEvents()
+{
+  if (!isConnected_)
+    return;
+
+  // Clear the event first so that a signal while we are reading makes the eventfd readable again.
+  ndn_ShmTransport_clearEvent(transport_.get());
+  flushSendQueue();
+
+  bool isReceived = true;
+  while (isReceived) {
+    isReceived = false;
+    while (true) {
+      uint8_t *record;
+      size_t recordLength;
+      ndn_Error error;
+      if ((error = ndn_ShmTransport_receive(transport_.get(), &record, &recordLength))) {
+        // The peer corrupted the ring, so don't read any more of it.
+        close();
+        throw runtime_error(ndn_getErrorString(error));
+      }
+      if (!record)
+        break;
+
+      isReceived = true;
+      ndn_BinaryXmlElementReader_onReceivedData(elementReader_.get(), record, recordLength);
+    }
+
+    // Give the space back to the other process, then check again since it doesn't signal for records that it sends
+    // before we release.
+    ndn_ShmTransport_releaseReceived(transport_.get());
+  }
+}
+
+bool
+ShmTransport::getIsConnected()
+{
+  return isConnected_;
+}
+
+int
+ShmTransport::getFileDescriptor()
+{
+  return transport_->eventFd;
+}
+
+void
+ShmTransport::close()
+{
+  sendQueue_.clear();
+  isConnected_ = false;
+  ndn_Error error;
+  if ((error = ndn_ShmTransport_close(transport_.get())))
+    throw runtime_error(ndn_getErrorString(error));
+}
+
+ShmTransport::~ShmTransport()
+{
+  ndn_ShmTransport_close(transport_.get());
+  if (elementReader_->partialData.array)
+    // Free the memory allocated in connect.
+    free(elementReader_->partialData.array);
+}
+
+}
@@ -0,0 +1,211 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <stdexcept>
+#include <stdlib.h>
+#include <algorithm>
+#include <ndn-cpp/node.hpp>
+#include "../c/transport/socket-transport.h"
+#include "../c/encoding/binary-xml-element-reader.h"
+#include "../c/util/ndn_realloc.h"
+#include "../c/util/time.h"
+#include <ndn-cpp/transport/stream-socket-transport.hpp>
+
+using namespace std;
+
+namespace ndn {
+
+StreamSocketTransport::StreamSocketTransport() 
+  : socketTransport_(new struct ndn_SocketTransport), isConnected_(false),
+    elementReader_(new struct ndn_BinaryXmlElementReader), sendQueueOffset_(0), sendQueueLength_(0),
+    sendQueueTimeMilliseconds_(0.0), sendCoalescingMilliseconds_(0.0)
+{
+  ndn_SocketTransport_initialize(socketTransport_.get());
+  elementReader_->partialData.array = 0;
+}
+
+void
+StreamSocketTransport::onConnected(ElementListener& elementListener)
+{
+  // TODO: This belongs in the socket listener.
+  if (elementReader_->partialData.array)
+    // Free the memory allocated by a previous connect.
+    free(elementReader_->partialData.array);
+  const size_t initialLength = 1000;
+  // Automatically cast elementReader_ to (struct ndn_ElementListener *)
+  ndn_BinaryXmlElementReader_initialize
+    (elementReader_.get(), &elementListener, (uint8_t *)malloc(initialLength), initialLength, ndn_realloc);
+  
+  // Size the receive buffer so that one recv can drain everything the kernel has buffered for the socket.
+  ndn_Error error;
+  size_t receiveBufferSize;
+  if ((error = ndn_SocketTransport_getReceiveBufferSize(socketTransport_.get(), &receiveBufferSize)))
+    throw runtime_error(ndn_getErrorString(error)); 
+  receiveBuffer_.resize(max(receiveBufferSize, (size_t)8000));
+  
+  isConnected_ = true;
+}
+
+void 
+StreamSocketTransport::send(const uint8_t *data, size_t dataLength)
+{
+  if (sendQueue_.size() == 0 && sendCoalescingMilliseconds_ <= 0.0) {
+    // Send directly from data and only copy what the socket doesn't accept.
+    struct ndn_Blob buffer;
+    ndn_Blob_initialize(&buffer, (uint8_t *)data, dataLength);
+    ndn_Error error;
+    size_t nBytesSent;
+    if ((error = ndn_SocketTransport_sendBuffersNonBlocking(socketTransport_.get(), &buffer, 1, &nBytesSent)))
+      throw runtime_error(ndn_getErrorString(error));
+    if (nBytesSent >= dataLength)
+      return;
+    
+    data += nBytesSent;
+    dataLength -= nBytesSent;
+  }
+  
+  send(Blob(data, dataLength));
+}
+
+void
+StreamSocketTransport::send(const Blob& data)
+{
+  if (data.size() == 0)
+    return;
+  
+  if (sendQueue_.size() == 0)
+    sendQueueTimeMilliseconds_ = ndn_getNowMilliseconds();
+  sendQueue_.push_back(data);
+  sendQueueLength_ += data.size();
+  
+  if (sendCoalescingMilliseconds_ <= 0.0 || sendQueueLength_ >= 65536)
+    flushSendQueue();
+}
+
+void
+StreamSocketTransport::flushSendQueue()
+{
+  while (sendQueue_.size() > 0) {
+    // Gather the queued data so that one sendmsg sends as much as possible.
+    struct ndn_Blob buffers[ndn_SocketTransport_MAX_SEND_BUFFERS];
+    size_t nBuffers = 0;
+    for (deque<Blob>::iterator entry = sendQueue_.begin(); 
+         entry != sendQueue_.end() && nBuffers < ndn_SocketTransport_MAX_SEND_BUFFERS; ++entry) {
+      ndn_Blob_initialize(&buffers[nBuffers], (uint8_t *)entry->buf(), entry->size());
+      ++nBuffers;
+    }
+    buffers[0].value += sendQueueOffset_;
+    buffers[0].length -= sendQueueOffset_;
+    
+    ndn_Error error;
+    size_t nBytesSent;
+    if ((error = ndn_SocketTransport_sendBuffersNonBlocking(socketTransport_.get(), buffers, nBuffers, &nBytesSent))) {
+      clearSendQueue();
+      throw runtime_error(ndn_getErrorString(error));
+    }
+    if (nBytesSent == 0)
+      // The socket send buffer is full.  processEvents will try again.
+      return;
+    
+    // Remove the data which was sent.
+    sendQueueLength_ -= nBytesSent;
+    while (sendQueue_.size() > 0 && nBytesSent >= sendQueue_.front().size() - sendQueueOffset_) {
+      nBytesSent -= sendQueue_.front().size() - sendQueueOffset_;
+      sendQueue_.pop_front();
+      sendQueueOffset_ = 0;
+    }
+    sendQueueOffset_ += nBytesSent;
+  }
+}
+
+void
+StreamSocketTransport::clearSendQueue()
+{
+  sendQueue_.clear();
+  sendQueueOffset_ = 0;
+  sendQueueLength_ = 0;
+}
+
+void 
+StreamSocketTransport::processEvents()
+{
+  if (sendQueue_.size() > 0 && ndn_getNowMilliseconds() >= getFlushTimeMilliseconds())
+    flushSendQueue();
+  
+  if (receiveBuffer_.size() == 0)
+    // Not connected yet.
+    return;
+  
+  // Read until no more data is ready so that the socket receive buffer doesn't fill up between calls.  Each element
+  // is framed in place in receiveBuffer_ and only an element split across two reads is copied by the element reader.
+  while (true) {
+    ndn_Error error;
+    size_t nBytes;
+    if ((error = ndn_SocketTransport_receiveNonBlocking(socketTransport_.get(), &receiveBuffer_[0], receiveBuffer_.size(), &nBytes))) {
+      // Stop reading and close the socket, which would otherwise stay readable so that a caller waiting on
+      // getFileDescriptor would wake immediately forever.
+      clearSendQueue();
+      ndn_SocketTransport_close(socketTransport_.get());
+      isConnected_ = false;
+      if (error == NDN_ERROR_SocketTransport_connection_closed_by_the_peer)
+        return;
+      throw runtime_error(ndn_getErrorString(error));  
+    }
+    if (nBytes == 0)
+      return;
+
+    ndn_BinaryXmlElementReader_onReceivedData(elementReader_.get(), &receiveBuffer_[0], nBytes);
+    
+    if (nBytes == receiveBuffer_.size()) {
+      // We filled the buffer, so grow it if the application has since enlarged SO_RCVBUF.
+      size_t receiveBufferSize;
+      if (ndn_SocketTransport_getReceiveBufferSize(socketTransport_.get(), &receiveBufferSize) == NDN_ERROR_success &&
+          receiveBufferSize > receiveBuffer_.size())
+        receiveBuffer_.resize(receiveBufferSize);
+    }
+  }
+}
+
+bool 
+StreamSocketTransport::getIsConnected()
+{
+  return isConnected_;
+}
+
+int
+StreamSocketTransport::getFileDescriptor()
+{
+  return socketTransport_->socketDescriptor;
+}
+
+MillisecondsSince1970
+StreamSocketTransport::getFlushTimeMilliseconds()
+{
+  if (sendQueue_.size() == 0)
+    return -1.0;
+  
+  return sendQueueTimeMilliseconds_ + sendCoalescingMilliseconds_;
+}
+
+void 
+StreamSocketTransport::close()
+{
+  clearSendQueue();
+  isConnected_ = false;
+  ndn_Error error;
+  if ((error = ndn_SocketTransport_close(socketTransport_.get())))
+    throw runtime_error(ndn_getErrorString(error));  
+}
+
+StreamSocketTransport::~StreamSocketTransport()
+{
+  if (elementReader_->partialData.array)
+    // Free the memory allocated in connect.
+    free(elementReader_->partialData.array);
+}
+
+}
@@ -28,6 +28,12 @@ Transport::send(const uint8_t *data, size_t dataLength)
   throw logic_error("unimplemented");
 }
 
+void
+Transport::send(const Blob& data)
+{
+  send(data.buf(), data.size());
+}
+
 void 
 Transport::processEvents()
 {
@@ -40,6 +46,18 @@ Transport::getIsConnected()
   throw logic_error("unimplemented");
 }
 
+int
+Transport::getFileDescriptor()
+{
+  return -1;
+}
+
+MillisecondsSince1970
+Transport::getFlushTimeMilliseconds()
+{
+  return -1.0;
+}
+
 void 
 Transport::close()
 {
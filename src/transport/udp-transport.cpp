@@ -11,18 +11,25 @@
 #include "../c/transport/udp-transport.h"
 #include "../c/encoding/binary-xml-element-reader.h"
 #include "../c/util/ndn_realloc.h"
+#include "../c/util/time.h"
 #include <ndn-cpp/transport/udp-transport.hpp>
 
 using namespace std;
 
 namespace ndn {
 
+// The largest datagram which processEvents receives, which is the largest NDN packet that ndnd sends over UDP.
+static const size_t MAX_DATAGRAM_LENGTH = 8800;
+// The number of buffers in the receive pool, which is the most datagrams received in one system call.
+static const size_t N_RECEIVE_BUFFERS = 32;
+
 UdpTransport::ConnectionInfo::~ConnectionInfo()
 {  
 }
 
 UdpTransport::UdpTransport() 
-  : isConnected_(false), transport_(new struct ndn_UdpTransport), elementReader_(new struct ndn_BinaryXmlElementReader)
+  : isConnected_(false), transport_(new struct ndn_UdpTransport), elementReader_(new struct ndn_BinaryXmlElementReader),
+    sendQueueTimeMilliseconds_(0.0), isProcessingEvents_(false)
 {
   ndn_UdpTransport_initialize(transport_.get());
   elementReader_->partialData.array = 0;
@@ -33,6 +40,7 @@ UdpTransport::connect(const Transport::ConnectionInfo& connectionInfo, ElementLi
 {
   const UdpTransport::ConnectionInfo& udpConnectionInfo = dynamic_cast<const UdpTransport::ConnectionInfo&>(connectionInfo);
   
+  sendQueue_.clear();
   ndn_Error error;
   if ((error = ndn_UdpTransport_connect(transport_.get(), (char *)udpConnectionInfo.getHost().c_str(), udpConnectionInfo.getPort())))
     throw runtime_error(ndn_getErrorString(error)); 
@@ -43,33 +51,124 @@ UdpTransport::connect(const Transport::ConnectionInfo& connectionInfo, ElementLi
   ndn_BinaryXmlElementReader_initialize
     (elementReader_.get(), &elementListener, (uint8_t *)malloc(initialLength), initialLength, ndn_realloc);
   
+  receiveBuffer_.resize(N_RECEIVE_BUFFERS * MAX_DATAGRAM_LENGTH);
+  
   isConnected_ = true;
 }
 
 void 
 UdpTransport::send(const uint8_t *data, size_t dataLength)
 {
+  if (!trySendNow(data, dataLength))
+    queueDatagram(Blob(data, dataLength));
+}
+
+void
+UdpTransport::send(const Blob& data)
+{
+  if (!trySendNow(data.buf(), data.size()))
+    queueDatagram(data);
+}
+
+bool
+UdpTransport::trySendNow(const uint8_t *data, size_t dataLength)
+{
+  if (sendQueue_.size() > 0 || isProcessingEvents_)
+    // Keep the order of the queued datagrams, or batch the datagrams from callbacks.
+    return false;
+  
+  struct ndn_Blob datagram;
+  ndn_Blob_initialize(&datagram, (uint8_t *)data, dataLength);
   ndn_Error error;
-  if ((error = ndn_UdpTransport_send(transport_.get(), (uint8_t *)data, dataLength)))
+  size_t nDatagramsSent;
+  if ((error = ndn_UdpTransport_sendDatagramsNonBlocking(transport_.get(), &datagram, 1, &nDatagramsSent)))
     throw runtime_error(ndn_getErrorString(error));  
+  return nDatagramsSent == 1;
+}
+
+void
+UdpTransport::queueDatagram(const Blob& data)
+{
+  if (sendQueue_.size() == 0)
+    sendQueueTimeMilliseconds_ = ndn_getNowMilliseconds();
+  sendQueue_.push_back(data);
+}
+
+void
+UdpTransport::flushSendQueue()
+{
+  while (sendQueue_.size() > 0) {
+    struct ndn_Blob datagrams[ndn_SocketTransport_MAX_SEND_BUFFERS];
+    size_t nDatagrams = 0;
+    for (deque<Blob>::iterator entry = sendQueue_.begin(); 
+         entry != sendQueue_.end() && nDatagrams < ndn_SocketTransport_MAX_SEND_BUFFERS; ++entry) {
+      ndn_Blob_initialize(&datagrams[nDatagrams], (uint8_t *)entry->buf(), entry->size());
+      ++nDatagrams;
+    }
+    
+    ndn_Error error;
+    size_t nDatagramsSent;
+    if ((error = ndn_UdpTransport_sendDatagramsNonBlocking(transport_.get(), datagrams, nDatagrams, &nDatagramsSent))) {
+      sendQueue_.clear();
+      throw runtime_error(ndn_getErrorString(error));
+    }
+    if (nDatagramsSent == 0)
+      // The socket send buffer is full.  processEvents will try again.
+      return;
+    
+    sendQueue_.erase(sendQueue_.begin(), sendQueue_.begin() + nDatagramsSent);
+  }
 }
 
 void 
 UdpTransport::processEvents()
 {
-  int receiveIsReady;
-  ndn_Error error;
-  if ((error = ndn_UdpTransport_receiveIsReady(transport_.get(), &receiveIsReady)))
-    throw runtime_error(ndn_getErrorString(error));  
-  if (!receiveIsReady)
+  if (receiveBuffer_.size() == 0)
+    // Not connected yet.
     return;
+  
+  // Send the datagrams which the socket didn't accept before.
+  flushSendQueue();
+  
+  // Queue the datagrams which the callbacks send so that we send them together at the end.
+  isProcessingEvents_ = true;
+  try {
+    receiveDatagrams();
+  } catch (...) {
+    isProcessingEvents_ = false;
+    throw;
+  }
+  isProcessingEvents_ = false;
+  
+  flushSendQueue();
+}
 
-  uint8_t buffer[8000];
-  size_t nBytes;
-  if ((error = ndn_UdpTransport_receive(transport_.get(), buffer, sizeof(buffer), &nBytes)))
-    throw runtime_error(ndn_getErrorString(error));  
+void
+UdpTransport::receiveDatagrams()
+{
+  uint8_t *buffers[N_RECEIVE_BUFFERS];
+  for (size_t i = 0; i < N_RECEIVE_BUFFERS; ++i)
+    buffers[i] = &receiveBuffer_[i * MAX_DATAGRAM_LENGTH];
+  size_t datagramLengths[N_RECEIVE_BUFFERS];
+  
+  // Read datagrams until no more are ready so that the socket receive buffer doesn't fill up between calls.
+  while (true) {
+    ndn_Error error;
+    size_t nDatagrams;
+    if ((error = ndn_UdpTransport_receiveDatagramsNonBlocking
+         (transport_.get(), buffers, MAX_DATAGRAM_LENGTH, N_RECEIVE_BUFFERS, datagramLengths, &nDatagrams)))
+      throw runtime_error(ndn_getErrorString(error));  
 
-  ndn_BinaryXmlElementReader_onReceivedData(elementReader_.get(), buffer, nBytes);
+    for (size_t i = 0; i < nDatagrams; ++i) {
+      // A length of 0 is an empty or truncated datagram.
+      if (datagramLengths[i] > 0)
+        ndn_BinaryXmlElementReader_onReceivedData(elementReader_.get(), buffers[i], datagramLengths[i]);
+    }
+    
+    if (nDatagrams < N_RECEIVE_BUFFERS)
+      // There are no more datagrams ready.
+      return;
+  }
 }
 
 bool 
@@ -78,9 +177,25 @@ UdpTransport::getIsConnected()
   return isConnected_;
 }
 
+int
+UdpTransport::getFileDescriptor()
+{
+  return transport_->base.socketDescriptor;
+}
+
+MillisecondsSince1970
+UdpTransport::getFlushTimeMilliseconds()
+{
+  if (sendQueue_.size() == 0)
+    return -1.0;
+  
+  return sendQueueTimeMilliseconds_;
+}
+
 void 
 UdpTransport::close()
 {
+  sendQueue_.clear();
   ndn_Error error;
   if ((error = ndn_UdpTransport_close(transport_.get())))
     throw runtime_error(ndn_getErrorString(error));  
@@ -0,0 +1,38 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <stdexcept>
+#include "../c/transport/socket-transport.h"
+#include <ndn-cpp/transport/unix-transport.hpp>
+
+using namespace std;
+
+namespace ndn {
+
+UnixTransport::ConnectionInfo::~ConnectionInfo()
+{  
+}
+
+UnixTransport::UnixTransport() 
+{
+}
+
+void 
+UnixTransport::connect(const Transport::ConnectionInfo& connectionInfo, ElementListener& elementListener)
+{
+  const UnixTransport::ConnectionInfo& unixConnectionInfo = dynamic_cast<const UnixTransport::ConnectionInfo&>(connectionInfo);
+  
+  clearSendQueue();
+  ndn_Error error;
+  if ((error = ndn_SocketTransport_connect
+                (socketTransport_.get(), SOCKET_UNIX, (char *)unixConnectionInfo.getFilePath().c_str(), 0)))
+    throw runtime_error(ndn_getErrorString(error)); 
+
+  onConnected(elementListener);
+}
+
+}
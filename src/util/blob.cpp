@@ -5,6 +5,8 @@
  * See COPYING for copyright and distribution information.
  */
 
+#include <stdexcept>
+#include <string.h>
 #include "../c/util/blob.h"
 #include <ndn-cpp/util/blob.hpp>
 
@@ -13,10 +15,49 @@ using namespace std;
 namespace ndn {
 
 Blob::Blob(const struct ndn_Blob& blobStruct)
-  : ptr_lib::shared_ptr<const vector<uint8_t> >(new vector<uint8_t>(blobStruct.value, blobStruct.value + blobStruct.length))
+  : ptr_lib::shared_ptr<const vector<uint8_t> >(new vector<uint8_t>(blobStruct.value, blobStruct.value + blobStruct.length)),
+    sliceBuf_(0), sliceSize_(0)
 {
 }
 
+Blob::Blob(const struct ndn_Blob& blobStruct, const Blob& buffer)
+  : sliceBuf_(0), sliceSize_(0)
+{
+  const uint8_t *bufferBegin = buffer.buf();
+  if (bufferBegin && buffer.size() > 0 && blobStruct.value >= bufferBegin && 
+      blobStruct.value + blobStruct.length <= bufferBegin + buffer.size()) {
+    // Share the buffer.
+    *this = Blob(buffer, (size_t)(blobStruct.value - bufferBegin), blobStruct.length);
+  }
+  else if (blobStruct.length == 0 && bufferBegin && buffer.size() > 0)
+    // The decoder returns a null value for an empty blob.  Use an empty slice instead of allocating.
+    *this = Blob(buffer, 0, 0);
+  else
+    *this = Blob(blobStruct);
+}
+
+Blob::Blob(const Blob& buffer, size_t offset, size_t length)
+  : ptr_lib::shared_ptr<const vector<uint8_t> >(buffer), sliceBuf_(0), sliceSize_(0)
+{
+  if (offset + length > buffer.size())
+    throw runtime_error("Blob: The slice is outside of the buffer");
+  
+  if (buffer.size() > 0) {
+    sliceBuf_ = buffer.buf() + offset;
+    sliceSize_ = length;
+  }
+}
+
+bool
+Blob::equals(const Blob& other) const
+{
+  if (size() != other.size())
+    return false;
+  if (size() == 0 || buf() == other.buf())
+    return true;
+  return memcmp(buf(), other.buf(), size()) == 0;
+}
+
 void 
 Blob::get(struct ndn_Blob& blobStruct) const 
 {
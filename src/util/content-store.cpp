@@ -0,0 +1,192 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include "../c/interest.h"
+#include "content-store.hpp"
+
+using namespace std;
+
+namespace ndn {
+
+/**
+ * Get the name which immediately follows every name which has prefix as a prefix in the canonical order: the prefix
+ * with the last component replaced by the next component of the same length, or if all its bytes are 0xff, by the
+ * zero component one byte longer.
+ * @param prefix The prefix, which must not be empty.
+ * @return The successor name.
+ */
+static Name
+getPrefixSuccessor(const Name& prefix)
+{
+  const Blob& lastValue = prefix.get(prefix.size() - 1).getValue();
+  vector<uint8_t> value(lastValue.buf(), lastValue.buf() + lastValue.size());
+  size_t i = value.size();
+  for (; i > 0; --i) {
+    if (value[i - 1] != 0xff) {
+      ++value[i - 1];
+      break;
+    }
+    value[i - 1] = 0;
+  }
+  if (i == 0)
+    // All the bytes were 0xff, so use a longer component.
+    value.push_back(0);
+
+  return prefix.getPrefix(-1).append(value);
+}
+
+ContentStore::Entry::Entry(const Name& name, const Blob& encoding, MillisecondsSince1970 staleTimeMilliseconds)
+: name_(name), encoding_(encoding), staleTimeMilliseconds_(staleTimeMilliseconds),
+  moreRecent_(0), lessRecent_(0)
+{
+  // An empty vector has no element 0, so pass 0.
+  nameComponents_.resize(name_.size());
+  ndn_Name_initialize(&nameStruct_, nameComponents_.empty() ? 0 : &nameComponents_[0], nameComponents_.size());
+  name_.get(nameStruct_);
+}
+
+ContentStore::~ContentStore()
+{
+  for (map<Name, Entry*>::iterator entry = entries_.begin(); entry != entries_.end(); ++entry)
+    delete entry->second;
+}
+
+void
+ContentStore::add(const Data& data, const Blob& encoding, MillisecondsSince1970 nowMilliseconds)
+{
+  if (encoding.size() > maxBytes_)
+    return;
+
+  MillisecondsSince1970 staleTimeMilliseconds = -1.0;
+  if (data.getMetaInfo().getFreshnessSeconds() >= 0)
+    staleTimeMilliseconds = nowMilliseconds + 1000.0 * data.getMetaInfo().getFreshnessSeconds();
+
+  map<Name, Entry*>::iterator existing = entries_.find(data.getName());
+  if (existing != entries_.end())
+    erase(existing);
+
+  Entry *entry = new Entry(data.getName(), encoding, staleTimeMilliseconds);
+  entries_[entry->name_] = entry;
+  pushMostRecent(entry);
+  nBytes_ += encoding.size();
+  evict();
+}
+
+ptr_lib::shared_ptr<Data>
+ContentStore::find(const Name& interestName, const struct ndn_Interest& interestStruct, MillisecondsSince1970 nowMilliseconds)
+{
+  Entry *entry = findEntry(interestName, interestStruct, nowMilliseconds);
+  if (!entry)
+    return ptr_lib::shared_ptr<Data>();
+
+  ptr_lib::shared_ptr<Data> data(new Data());
+  data->wireDecode(entry->encoding_);
+  return data;
+}
+
+Blob
+ContentStore::findEncoding(const Name& interestName, const struct ndn_Interest& interestStruct, MillisecondsSince1970 nowMilliseconds)
+{
+  Entry *entry = findEntry(interestName, interestStruct, nowMilliseconds);
+  return entry ? entry->encoding_ : Blob();
+}
+
+ContentStore::Entry*
+ContentStore::findEntry(const Name& interestName, const struct ndn_Interest& interestStruct, MillisecondsSince1970 nowMilliseconds)
+{
+  int answerOriginKind = interestStruct.answerOriginKind >= 0 ?
+    interestStruct.answerOriginKind : ndn_Interest_DEFAULT_ANSWER_ORIGIN_KIND;
+  if (!(answerOriginKind & ndn_Interest_ANSWER_CONTENT_STORE))
+    return 0;
+  bool allowStale = (answerOriginKind & ndn_Interest_ANSWER_STALE) != 0;
+
+  // The names which have interestName as a prefix are the range from interestName up to its successor.
+  map<Name, Entry*>::iterator begin = entries_.lower_bound(interestName);
+  if (interestStruct.childSelector == ndn_Interest_CHILD_SELECTOR_RIGHT) {
+    map<Name, Entry*>::iterator end =
+      interestName.size() == 0 ? entries_.end() : entries_.lower_bound(getPrefixSuccessor(interestName));
+    for (map<Name, Entry*>::iterator entry = end; entry != begin; ) {
+      --entry;
+      if (matches(entry->second, interestStruct, allowStale, nowMilliseconds))
+        return entry->second;
+    }
+  }
+  else {
+    // Stop at the first name which doesn't have the prefix instead of finding the successor.
+    for (map<Name, Entry*>::iterator entry = begin; entry != entries_.end() && interestName.match(entry->first); ++entry) {
+      if (matches(entry->second, interestStruct, allowStale, nowMilliseconds))
+        return entry->second;
+    }
+  }
+
+  return 0;
+}
+
+void
+ContentStore::setMaxBytes(size_t maxBytes)
+{
+  maxBytes_ = maxBytes;
+  evict();
+}
+
+bool
+ContentStore::matches
+  (Entry *entry, const struct ndn_Interest& interestStruct, bool allowStale, MillisecondsSince1970 nowMilliseconds)
+{
+  if (!allowStale && entry->staleTimeMilliseconds_ >= 0.0 && nowMilliseconds >= entry->staleTimeMilliseconds_)
+    return false;
+  if (!ndn_Interest_matchesName((struct ndn_Interest *)&interestStruct, &entry->nameStruct_))
+    return false;
+
+  unlink(entry);
+  pushMostRecent(entry);
+  return true;
+}
+
+void
+ContentStore::erase(map<Name, Entry*>::iterator entry)
+{
+  Entry *value = entry->second;
+  entries_.erase(entry);
+  unlink(value);
+  nBytes_ -= value->encoding_.size();
+  delete value;
+}
+
+void
+ContentStore::pushMostRecent(Entry *entry)
+{
+  entry->moreRecent_ = 0;
+  entry->lessRecent_ = mostRecent_;
+  if (mostRecent_)
+    mostRecent_->moreRecent_ = entry;
+  else
+    leastRecent_ = entry;
+  mostRecent_ = entry;
+}
+
+void
+ContentStore::unlink(Entry *entry)
+{
+  if (entry->moreRecent_)
+    entry->moreRecent_->lessRecent_ = entry->lessRecent_;
+  else
+    mostRecent_ = entry->lessRecent_;
+  if (entry->lessRecent_)
+    entry->lessRecent_->moreRecent_ = entry->moreRecent_;
+  else
+    leastRecent_ = entry->moreRecent_;
+}
+
+void
+ContentStore::evict()
+{
+  while (nBytes_ > maxBytes_ && leastRecent_)
+    erase(entries_.find(leastRecent_->name_));
+}
+
+}
@@ -0,0 +1,167 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_CONTENT_STORE_HPP
+#define NDN_CONTENT_STORE_HPP
+
+#include <map>
+#include <vector>
+#include <ndn-cpp/data.hpp>
+#include "../c/name.h"
+
+struct ndn_Interest;
+
+namespace ndn {
+
+/**
+ * A ContentStore holds the wire encodings of Data packets with their names, up to a budget of encoding bytes, so that
+ * an interest which an earlier data packet satisfies can be answered without sending it.  The entries are in a map
+ * ordered by name, so the entries under an interest name are one range of the map, and in a doubly linked list from
+ * the most to the least recently used, which is evicted first when the store is over budget.
+ */
+class ContentStore {
+public:
+  /**
+   * Create a new ContentStore.
+   * @param maxBytes The maximum total number of bytes in the wire encodings of the stored data packets.
+   */
+  ContentStore(size_t maxBytes)
+  : maxBytes_(maxBytes), nBytes_(0), mostRecent_(0), leastRecent_(0)
+  {
+  }
+
+  /**
+   * Add the data packet, replacing a stored data packet with the same name.  Evict the least recently used entries
+   * if the store is over budget.  If the encoding alone is larger than the budget, do nothing.
+   * @param data The decoded data packet, for its name and freshness seconds.  This doesn't keep a reference to it.
+   * @param encoding The wire encoding of the data packet.  Its size is charged to the budget.
+   * @param nowMilliseconds The current time according to ndn_getNowMilliseconds, from which the freshness seconds of
+   * the data packet are counted.
+   */
+  void
+  add(const Data& data, const Blob& encoding, MillisecondsSince1970 nowMilliseconds);
+
+  /**
+   * Find a stored data packet whose name matches the interest name and conforms to the selectors checked by
+   * ndn_Interest_matchesName.  If the interest has the childSelector for the rightmost child, return the last
+   * matching data packet in the canonical order of names (which is under the rightmost child), otherwise the first.
+   * Don't return a stale data packet unless the answerOriginKind allows it.  If the answerOriginKind doesn't allow
+   * answers from the content store, return a null shared_ptr.  The returned entry becomes the most recently used.
+   * Each call decodes a new Data from the stored encoding with the default wire format, so the caller can change it.
+   * The fields are slices of the stored encoding, so this doesn't copy the content.
+   * @param interestName The name of the interest.
+   * @param interestStruct The same interest as an ndn_Interest struct, used to check the selectors.
+   * @param nowMilliseconds The current time according to ndn_getNowMilliseconds.
+   * @return A new Data decoded from the stored data packet, or a null shared_ptr if not found.
+   */
+  ptr_lib::shared_ptr<Data>
+  find(const Name& interestName, const struct ndn_Interest& interestStruct, MillisecondsSince1970 nowMilliseconds);
+
+  /**
+   * Find a stored data packet like find, but return its wire encoding, for example to answer an interest without
+   * encoding the data packet again.
+   * @param interestName The name of the interest.
+   * @param interestStruct The same interest as an ndn_Interest struct, used to check the selectors.
+   * @param nowMilliseconds The current time according to ndn_getNowMilliseconds.
+   * @return The wire encoding of the stored data packet, or a null Blob if not found.
+   */
+  Blob
+  findEncoding(const Name& interestName, const struct ndn_Interest& interestStruct, MillisecondsSince1970 nowMilliseconds);
+
+  /**
+   * Set the budget, evicting the least recently used entries if the store is over the new budget.
+   * @param maxBytes The maximum total number of bytes in the wire encodings of the stored data packets.
+   */
+  void
+  setMaxBytes(size_t maxBytes);
+
+  size_t
+  getMaxBytes() const { return maxBytes_; }
+
+  /**
+   * Get the total number of bytes in the wire encodings of the stored data packets.
+   */
+  size_t
+  getNBytes() const { return nBytes_; }
+
+  /**
+   * Get the number of stored data packets.
+   */
+  size_t
+  size() const { return entries_.size(); }
+
+  ~ContentStore();
+
+private:
+  class Entry {
+  public:
+    /**
+     * Create a new Entry and set nameStruct_ to point into name_.
+     */
+    Entry(const Name& name, const Blob& encoding, MillisecondsSince1970 staleTimeMilliseconds);
+
+    Name name_;         /**< A copy of the data name, which nameStruct_ points into. */
+    std::vector<struct ndn_NameComponent> nameComponents_;
+    struct ndn_Name nameStruct_;
+    Blob encoding_;
+    MillisecondsSince1970 staleTimeMilliseconds_; /**< When the data becomes stale, or -1 if it doesn't. */
+    Entry *moreRecent_; /**< The next more recently used entry, or 0 for the most recent. */
+    Entry *lessRecent_; /**< The next less recently used entry, or 0 for the least recent. */
+  };
+
+  // Don't allow copying since the store owns the entries.
+  ContentStore(const ContentStore& other);
+  ContentStore& operator = (const ContentStore& other);
+
+  /**
+   * Do the work of find and findEncoding.
+   * @return The entry, or 0 if not found.
+   */
+  Entry*
+  findEntry(const Name& interestName, const struct ndn_Interest& interestStruct, MillisecondsSince1970 nowMilliseconds);
+
+  /**
+   * Check entry against the interest selectors and freshness, and if it matches, make it the most recently used.
+   * @return true if the entry matches.
+   */
+  bool
+  matches(Entry *entry, const struct ndn_Interest& interestStruct, bool allowStale, MillisecondsSince1970 nowMilliseconds);
+
+  /**
+   * Remove the entry from the map and the recently used list, and delete it.
+   */
+  void
+  erase(std::map<Name, Entry*>::iterator entry);
+
+  /**
+   * Insert entry at the front of the recently used list.
+   */
+  void
+  pushMostRecent(Entry *entry);
+
+  /**
+   * Remove entry from the recently used list.
+   */
+  void
+  unlink(Entry *entry);
+
+  /**
+   * Erase the least recently used entries until nBytes_ is at most maxBytes_.
+   */
+  void
+  evict();
+
+  size_t maxBytes_;
+  size_t nBytes_;
+  std::map<Name, Entry*> entries_;
+  Entry *mostRecent_;
+  Entry *leastRecent_;
+};
+
+}
+
+#endif
@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_MPSC_QUEUE_HPP
+#define NDN_MPSC_QUEUE_HPP
+
+namespace ndn {
+
+/**
+ * An MpscQueue is a lock-free queue where any number of threads can push and one thread pops.  This is the intrusive
+ * queue of Dmitry Vyukov: a producer links its node with one atomic exchange of the head, so producers never wait for
+ * each other or for the consumer.  Values pushed by the same thread are popped in the order they were pushed.
+ * @tparam T The value type, which must be copyable.
+ */
+template<class T> class MpscQueue {
+public:
+  MpscQueue()
+  : head_(&stub_), tail_(&stub_)
+  {
+    stub_.next_ = 0;
+  }
+
+  /**
+   * Add a copy of value to the queue.  Any thread can call this.
+   * @param value The value to add.
+   */
+  void
+  push(const T& value)
+  {
+    pushNode(new Node(value));
+  }
+
+  /**
+   * Remove the oldest value from the queue.  Only one thread at a time can call this.  This may return false while
+   * a push by another thread is in progress, in which case the value is popped by a later call.
+   * @param value Set this to the removed value.
+   * @return true if a value was removed, or false if the queue is empty.
+   */
+  bool
+  pop(T& value)
+  {
+    Node *tail = tail_;
+    Node *next = __atomic_load_n(&tail->next_, __ATOMIC_ACQUIRE);
+    if (tail == &stub_) {
+      if (!next)
+        return false;
+      // Skip the stub.
+      tail_ = next;
+      tail = next;
+      next = __atomic_load_n(&tail->next_, __ATOMIC_ACQUIRE);
+    }
+
+    if (!next) {
+      if (tail != __atomic_load_n(&head_, __ATOMIC_ACQUIRE))
+        // A producer has exchanged the head but not yet linked its node.
+        return false;
+      // tail is the last node, so push the stub behind it so that tail can be removed.
+      pushNode(&stub_);
+      next = __atomic_load_n(&tail->next_, __ATOMIC_ACQUIRE);
+      if (!next)
+        return false;
+    }
+
+    tail_ = next;
+    value = tail->value_;
+    delete tail;
+    return true;
+  }
+
+  ~MpscQueue()
+  {
+    T value;
+    while (pop(value)) {
+    }
+  }
+
+private:
+  class Node {
+  public:
+    Node()
+    : next_(0)
+    {
+    }
+
+    Node(const T& value)
+    : next_(0), value_(value)
+    {
+    }
+
+    Node *next_;
+    T value_;
+  };
+
+  // Don't allow copying since the queue owns the nodes.
+  MpscQueue(const MpscQueue& other);
+  MpscQueue& operator = (const MpscQueue& other);
+
+  void
+  pushNode(Node *node)
+  {
+    node->next_ = 0;
+    Node *previous = __atomic_exchange_n(&head_, node, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&previous->next_, node, __ATOMIC_RELEASE);
+  }
+
+  Node *head_; /**< The most recently pushed node, which producers exchange. */
+  Node *tail_; /**< The oldest node, which only the consumer reads. */
+  Node stub_;  /**< A node without a value which keeps the list from becoming empty. */
+};
+
+}
+
+#endif
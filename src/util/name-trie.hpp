@@ -0,0 +1,364 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_NAME_TRIE_HPP
+#define NDN_NAME_TRIE_HPP
+
+#include <vector>
+#include <ndn-cpp/name.hpp>
+
+namespace ndn {
+
+/**
+ * A NameTrie holds values keyed by Name in a tree of name components.  Each node of the tree is also in a hash table
+ * keyed by Name::getPrefixHash of its prefix, so finding the node for any prefix of a name is one probe which uses the
+ * hash codes cached in the name, without walking the components.  Since every prefix of a key has a node, the deepest
+ * node for a prefix of a name is found with a binary search over the prefix lengths, in a handful of probes.
+ * More than one value can be stored under the same key.
+ * @tparam T The value type.  This must be copyable and support ==, for example a ptr_lib::shared_ptr.
+ */
+template<class T> class NameTrie {
+public:
+  NameTrie()
+  : root_(Name(), 0), size_(0), nEntries_(0)
+  {
+  }
+
+  /**
+   * Add the value under the key name.  This does not check if the value is already stored.
+   * @param name The key for the value.
+   * @param value The value to add.
+   */
+  void
+  insert(const Name& name, const T& value)
+  {
+    Entry *entry = findDeepestPrefixOf(name);
+    for (size_t depth = entry->prefix_.size() + 1; depth <= name.size(); ++depth)
+      entry = addChild(entry, name.getPrefix(depth));
+
+    entry->values_.push_back(value);
+    ++size_;
+  }
+
+  /**
+   * Remove the first value under the key name which equals value.  Remove trie nodes which become empty.
+   * @param name The key given to insert.
+   * @param value The value to remove.
+   * @return true if the value was found and removed, otherwise false.
+   */
+  bool
+  remove(const Name& name, const T& value)
+  {
+    Entry *entry = find(name, name.size());
+    if (!entry)
+      return false;
+
+    bool found = false;
+    for (size_t i = 0; i < entry->values_.size(); ++i) {
+      if (entry->values_[i] == value) {
+        entry->values_.erase(entry->values_.begin() + i);
+        found = true;
+        break;
+      }
+    }
+    if (!found)
+      return false;
+    --size_;
+
+    prune(entry);
+    return true;
+  }
+
+  /**
+   * Get the values whose key is exactly name, in the order they were inserted, without copying them.
+   * @param name The key to find.
+   * @return A pointer to the values, or 0 if there is no entry for the key.  The pointer is invalid after the next
+   * change to the trie.
+   */
+  const std::vector<T>*
+  findAllWithKey(const Name& name) const
+  {
+    const Entry *entry = find(name, name.size());
+    return entry ? &entry->values_ : 0;
+  }
+
+  /**
+   * Append to result every value whose key is a prefix of name, including name itself.  Values with shorter keys
+   * come first, and values with the same key are in the order they were inserted.
+   * @param name The name to match.
+   * @param result The vector to append the values to.
+   */
+  void
+  findAllPrefixesOf(const Name& name, std::vector<T>& result) const
+  {
+    appendPathValues(findDeepestPrefixOf(name), result);
+  }
+
+  /**
+   * Append to result the values under the longest key which is a prefix of name, including name itself, in the order
+   * they were inserted.  Do nothing if no key is a prefix of name.
+   * @param name The name to match.
+   * @param result The vector to append the values to.
+   * @return true if a key was found, otherwise false.
+   */
+  bool
+  findLongestPrefixOf(const Name& name, std::vector<T>& result) const
+  {
+    for (const Entry *entry = findDeepestPrefixOf(name); entry; entry = entry->parent_) {
+      if (entry->values_.size() > 0) {
+        result.insert(result.end(), entry->values_.begin(), entry->values_.end());
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /**
+   * Remove every value whose key has prefix as a prefix, including prefix itself, and append the removed values to
+   * result.  This removes the whole subtree at once instead of removing each value.
+   * @param prefix The prefix to match.
+   * @param result The vector to append the removed values to.
+   */
+  void
+  removeAllWithPrefix(const Name& prefix, std::vector<T>& result)
+  {
+    Entry *subtree = find(prefix, prefix.size());
+    if (!subtree)
+      return;
+
+    size_t oldResultSize = result.size();
+    getAll(subtree, result);
+    size_ -= result.size() - oldResultSize;
+
+    while (subtree->firstChild_)
+      removeSubtree(subtree->firstChild_);
+    subtree->values_.clear();
+    prune(subtree);
+  }
+
+  /**
+   * Append to result every value in the trie.
+   * @param result The vector to append the values to.
+   */
+  void
+  getAll(std::vector<T>& result) const
+  {
+    result.reserve(result.size() + size_);
+    getAll(&root_, result);
+  }
+
+  /**
+   * Get the number of values in the trie.
+   * @return The number of values.
+   */
+  size_t
+  size() const { return size_; }
+
+  ~NameTrie()
+  {
+    while (root_.firstChild_)
+      removeSubtree(root_.firstChild_);
+  }
+
+private:
+  /**
+   * An Entry is the node of the tree for a prefix of the keys.  The children of an entry are in a doubly linked list
+   * so that removing a child doesn't search the others.
+   */
+  class Entry {
+  public:
+    Entry(const Name& prefix, Entry *parent)
+    : prefix_(prefix), hash_(prefix.hash()), parent_(parent), firstChild_(0), nextSibling_(0), previousSibling_(0),
+      nextInBucket_(0)
+    {
+    }
+
+    bool
+    isEmpty() const { return values_.size() == 0 && !firstChild_; }
+
+    Name prefix_;
+    size_t hash_;         /**< prefix_.hash() */
+    Entry *parent_;       /**< The entry for prefix_ without the last component, or 0 for the root. */
+    Entry *firstChild_;
+    Entry *nextSibling_;
+    Entry *previousSibling_;
+    Entry *nextInBucket_; /**< The next entry in the same bucket of the hash table. */
+    std::vector<T> values_;
+  };
+
+  // Don't allow copying since the trie owns the entries.
+  NameTrie(const NameTrie& other);
+  NameTrie& operator = (const NameTrie& other);
+
+  /**
+   * Find the entry for the first nComponents components of name.
+   * @param name The name with the key.
+   * @param nComponents The number of components in the key.
+   * @return The entry, or 0 if not found.
+   */
+  Entry*
+  find(const Name& name, size_t nComponents) const
+  {
+    if (nComponents == 0)
+      return const_cast<Entry*>(&root_);
+    if (buckets_.size() == 0)
+      return 0;
+
+    size_t hash = name.getPrefixHash(nComponents);
+    for (Entry *entry = buckets_[hash & (buckets_.size() - 1)]; entry; entry = entry->nextInBucket_) {
+      if (entry->hash_ == hash && entry->prefix_.size() == nComponents && entry->prefix_.match(name))
+        return entry;
+    }
+    return 0;
+  }
+
+  /**
+   * Find the entry for the longest prefix of name, including name itself.  Every prefix of the prefix of an entry also
+   * has an entry, so do a binary search over the number of components.
+   * @param name The name to match.
+   * @return The entry, which is the root if no other entry is a prefix of name.
+   */
+  Entry*
+  findDeepestPrefixOf(const Name& name) const
+  {
+    Entry *result = const_cast<Entry*>(&root_);
+    // The entry for the first low components exists and the entry for more than high components does not.
+    size_t low = 0;
+    size_t high = name.size();
+    while (low < high) {
+      size_t middle = low + (high - low + 1) / 2;
+      Entry *entry = find(name, middle);
+      if (entry) {
+        result = entry;
+        low = middle;
+      }
+      else
+        high = middle - 1;
+    }
+
+    return result;
+  }
+
+  /**
+   * Add a new child entry to parent and to the hash table.
+   * @param parent The parent entry.
+   * @param prefix The prefix of the new entry, which is the prefix of parent plus one component.
+   * @return The new entry.
+   */
+  Entry*
+  addChild(Entry *parent, const Name& prefix)
+  {
+    if (nEntries_ >= buckets_.size())
+      rehash(buckets_.size() == 0 ? 16 : 2 * buckets_.size());
+
+    Entry *entry = new Entry(prefix, parent);
+    entry->nextSibling_ = parent->firstChild_;
+    if (parent->firstChild_)
+      parent->firstChild_->previousSibling_ = entry;
+    parent->firstChild_ = entry;
+
+    Entry *&bucket = buckets_[entry->hash_ & (buckets_.size() - 1)];
+    entry->nextInBucket_ = bucket;
+    bucket = entry;
+    ++nEntries_;
+    return entry;
+  }
+
+  /**
+   * Move the entries to a new hash table with nBuckets buckets.
+   * @param nBuckets The number of buckets, which must be a power of 2.
+   */
+  void
+  rehash(size_t nBuckets)
+  {
+    std::vector<Entry*> oldBuckets(nBuckets, (Entry*)0);
+    oldBuckets.swap(buckets_);
+    for (size_t i = 0; i < oldBuckets.size(); ++i) {
+      Entry *entry = oldBuckets[i];
+      while (entry) {
+        Entry *next = entry->nextInBucket_;
+        Entry *&bucket = buckets_[entry->hash_ & (nBuckets - 1)];
+        entry->nextInBucket_ = bucket;
+        bucket = entry;
+        entry = next;
+      }
+    }
+  }
+
+  /**
+   * Remove the entry and all its children from the tree and the hash table, and delete them.  This does not change
+   * size_.
+   * @param entry The entry to remove, which is not the root.
+   */
+  void
+  removeSubtree(Entry *entry)
+  {
+    while (entry->firstChild_)
+      removeSubtree(entry->firstChild_);
+
+    if (entry->previousSibling_)
+      entry->previousSibling_->nextSibling_ = entry->nextSibling_;
+    else
+      entry->parent_->firstChild_ = entry->nextSibling_;
+    if (entry->nextSibling_)
+      entry->nextSibling_->previousSibling_ = entry->previousSibling_;
+
+    Entry **link = &buckets_[entry->hash_ & (buckets_.size() - 1)];
+    while (*link != entry)
+      link = &(*link)->nextInBucket_;
+    *link = entry->nextInBucket_;
+
+    delete entry;
+    --nEntries_;
+  }
+
+  /**
+   * Remove the entry if it is empty, then its parent if that becomes empty, and so on up to the root.
+   * @param entry The entry to check.
+   */
+  void
+  prune(Entry *entry)
+  {
+    while (entry->parent_ && entry->isEmpty()) {
+      Entry *parent = entry->parent_;
+      removeSubtree(entry);
+      entry = parent;
+    }
+  }
+
+  /**
+   * Append the values of the parents of entry, from the root down, and then the values of entry.
+   */
+  static void
+  appendPathValues(const Entry *entry, std::vector<T>& result)
+  {
+    if (entry->parent_)
+      appendPathValues(entry->parent_, result);
+    result.insert(result.end(), entry->values_.begin(), entry->values_.end());
+  }
+
+  /**
+   * Append the values of entry and all its children.
+   */
+  static void
+  getAll(const Entry *entry, std::vector<T>& result)
+  {
+    result.insert(result.end(), entry->values_.begin(), entry->values_.end());
+    for (const Entry *child = entry->firstChild_; child; child = child->nextSibling_)
+      getAll(child, result);
+  }
+
+  Entry root_;
+  std::vector<Entry*> buckets_; /**< The hash table of entries other than the root.  The size is a power of 2. */
+  size_t size_;
+  size_t nEntries_;             /**< The number of entries in buckets_. */
+};
+
+}
+
+#endif
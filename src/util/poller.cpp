@@ -0,0 +1,118 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <stdexcept>
+#include <algorithm>
+#include <math.h>
+#include <errno.h>
+#include <unistd.h>
+#include "poller.hpp"
+#if NDN_CPP_HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+
+using namespace std;
+
+namespace ndn {
+
+Poller::Poller()
+: epollDescriptor_(-1)
+{
+#if NDN_CPP_HAVE_SYS_EPOLL_H
+  if ((epollDescriptor_ = epoll_create(1)) < 0)
+    throw runtime_error("Poller: Error in epoll_create");
+#endif
+}
+
+Poller::~Poller()
+{
+  if (epollDescriptor_ >= 0)
+    ::close(epollDescriptor_);
+}
+
+void
+Poller::add(int fileDescriptor)
+{
+  if (find(fileDescriptors_.begin(), fileDescriptors_.end(), fileDescriptor) != fileDescriptors_.end())
+    return;
+
+#if NDN_CPP_HAVE_SYS_EPOLL_H
+  struct epoll_event event;
+  event.events = EPOLLIN;
+  event.data.fd = fileDescriptor;
+  if (epoll_ctl(epollDescriptor_, EPOLL_CTL_ADD, fileDescriptor, &event) != 0 && errno != EEXIST)
+    throw runtime_error("Poller: Error in epoll_ctl");
+#endif
+  fileDescriptors_.push_back(fileDescriptor);
+  waitForWrite_.push_back(false);
+}
+
+void
+Poller::remove(int fileDescriptor)
+{
+  vector<int>::iterator entry = find(fileDescriptors_.begin(), fileDescriptors_.end(), fileDescriptor);
+  if (entry == fileDescriptors_.end())
+    return;
+
+#if NDN_CPP_HAVE_SYS_EPOLL_H
+  // Ignore errors since the file descriptor may already be closed, which removes it from the epoll set.
+  struct epoll_event event;
+  epoll_ctl(epollDescriptor_, EPOLL_CTL_DEL, fileDescriptor, &event);
+#endif
+  waitForWrite_.erase(waitForWrite_.begin() + (entry - fileDescriptors_.begin()));
+  fileDescriptors_.erase(entry);
+}
+
+void
+Poller::setWaitForWrite(int fileDescriptor, bool waitForWrite)
+{
+  vector<int>::iterator entry = find(fileDescriptors_.begin(), fileDescriptors_.end(), fileDescriptor);
+  if (entry == fileDescriptors_.end())
+    return;
+  size_t i = entry - fileDescriptors_.begin();
+  if (waitForWrite_[i] == waitForWrite)
+    return;
+
+#if NDN_CPP_HAVE_SYS_EPOLL_H
+  struct epoll_event event;
+  event.events = waitForWrite ? EPOLLIN | EPOLLOUT : EPOLLIN;
+  event.data.fd = fileDescriptor;
+  if (epoll_ctl(epollDescriptor_, EPOLL_CTL_MOD, fileDescriptor, &event) != 0)
+    throw runtime_error("Poller: Error in epoll_ctl");
+#endif
+  waitForWrite_[i] = waitForWrite;
+}
+
+int
+Poller::wait(Milliseconds timeoutMilliseconds)
+{
+  // Round up so that we don't wake up just before the timeout and have to wait again.
+  int timeout = timeoutMilliseconds > 0 ? (int)ceil(timeoutMilliseconds) : 0;
+
+#if NDN_CPP_HAVE_SYS_EPOLL_H
+  struct epoll_event events[16];
+  int nReady = epoll_wait(epollDescriptor_, events, sizeof(events) / sizeof(events[0]), timeout);
+#else
+  vector<struct pollfd> pollInfo(fileDescriptors_.size());
+  for (size_t i = 0; i < fileDescriptors_.size(); ++i) {
+    pollInfo[i].fd = fileDescriptors_[i];
+    pollInfo[i].events = waitForWrite_[i] ? POLLIN | POLLOUT : POLLIN;
+  }
+  int nReady = poll(pollInfo.size() > 0 ? &pollInfo[0] : 0, pollInfo.size(), timeout);
+#endif
+
+  if (nReady < 0) {
+    if (errno == EINTR)
+      return 0;
+    throw runtime_error("Poller: Error waiting for file descriptors");
+  }
+  return nReady;
+}
+
+}
@@ -0,0 +1,79 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_POLLER_HPP
+#define NDN_POLLER_HPP
+
+#include <vector>
+#include <ndn-cpp/common.hpp>
+
+namespace ndn {
+
+/**
+ * A Poller waits until one of a set of file descriptors has data to read (or is writable if requested by
+ * setWaitForWrite), or a timeout passes.  This uses epoll if
+ * available, otherwise poll.
+ */
+class Poller {
+public:
+  /**
+   * Create a Poller with an empty set of file descriptors.
+   * @throw std::runtime_error if the epoll instance cannot be created.
+   */
+  Poller();
+
+  ~Poller();
+
+  /**
+   * Add the file descriptor to the set to wait on.  If it is already in the set, do nothing.
+   * @param fileDescriptor The file descriptor.
+   * @throw std::runtime_error if the file descriptor cannot be added.
+   */
+  void
+  add(int fileDescriptor);
+
+  /**
+   * Remove the file descriptor from the set to wait on.  If it is not in the set, do nothing.
+   * @param fileDescriptor The file descriptor.
+   */
+  void
+  remove(int fileDescriptor);
+
+  /**
+   * Set whether wait should also return when the file descriptor becomes writable.  When a file descriptor is added,
+   * this is initially false.  If the file descriptor is not in the set, do nothing.
+   * @param fileDescriptor The file descriptor.
+   * @param waitForWrite true to also wait until the file descriptor is writable.
+   * @throw std::runtime_error if the file descriptor cannot be modified.
+   */
+  void
+  setWaitForWrite(int fileDescriptor, bool waitForWrite);
+
+  /**
+   * Wait until one of the file descriptors has data to read (or is writable if requested) or timeoutMilliseconds passes.  If the set is empty,
+   * just wait for timeoutMilliseconds.  If a signal interrupts the wait, return early.
+   * @param timeoutMilliseconds The maximum time to wait in milliseconds.  This is rounded up to a whole
+   * millisecond.  If this is 0, don't block.
+   * @return The number of file descriptors which are ready, or 0 if the timeout passed.
+   * @throw std::runtime_error for an error while waiting.
+   */
+  int
+  wait(Milliseconds timeoutMilliseconds);
+
+private:
+  // Don't allow copying since we own the epoll file descriptor.
+  Poller(const Poller& other);
+  Poller& operator=(const Poller& other);
+
+  std::vector<int> fileDescriptors_;
+  std::vector<bool> waitForWrite_; /**< The setWaitForWrite value for each entry in fileDescriptors_. */
+  int epollDescriptor_; /**< The epoll instance, or -1 if not using epoll. */
+};
+
+}
+
+#endif
@@ -0,0 +1,375 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <string.h>
+#include <stdexcept>
+#include <new>
+#include <ndn-cpp/util/segment-fetcher.hpp>
+
+using namespace std;
+using namespace ndn::func_lib;
+#if NDN_CPP_HAVE_STD_FUNCTION
+// In the std library, the placeholders are in a different namespace than boost.
+using namespace ndn::func_lib::placeholders;
+#endif
+
+namespace ndn {
+
+SegmentFetcher::SegmentFetcher
+  (Face& face, const Interest& baseInterest, const OnComplete& onComplete, const OnError& onError)
+: face_(face), baseInterest_(baseInterest), onComplete_(onComplete), onError_(onError), windowSize_(1.0),
+  maxWindowSize_(256.0), slowStartThreshold_(-1.0), maxRetries_(3), maxContentSize_(1000000000),
+  isFinished_(false), nextSegment_(0), finalSegment_(-1), recoverySegment_(0), nReceived_(0), nReceivedBytes_(0),
+  nRetransmissions_(0), hasSegmentSize_(false),
+  segmentSize_(0), finalSegmentSize_(0), isOneBuffer_(true)
+{
+  if (baseInterest_.getInterestLifetimeMilliseconds() < 0.0)
+    baseInterest_.setInterestLifetimeMilliseconds(4000.0);
+}
+
+SegmentFetcher::~SegmentFetcher()
+{
+  if (!isFinished_) {
+    for (map<uint64_t, PendingSegment>::iterator i = pendingSegments_.begin(); i != pendingSegments_.end(); ++i) {
+      if (i->second.pendingInterestId_ != 0)
+        face_.removePendingInterest(i->second.pendingInterestId_);
+    }
+  }
+}
+
+void
+SegmentFetcher::start()
+{
+  if (windowSize_ < 1.0)
+    windowSize_ = 1.0;
+  fillWindow();
+}
+
+void
+SegmentFetcher::fillWindow()
+{
+  // pendingSegments_ includes the timed out segments waiting in retransmitSegments_, which are not pending.
+  while (!isFinished_ && pendingSegments_.size() - retransmitSegments_.size() < (size_t)windowSize_) {
+    if (!retransmitSegments_.empty()) {
+      uint64_t segment = retransmitSegments_.front();
+      retransmitSegments_.pop_front();
+      ++nRetransmissions_;
+      expressSegment(segment);
+    }
+    else if (finalSegment_ < 0 || nextSegment_ <= (uint64_t)finalSegment_)
+      expressSegment(nextSegment_++);
+    else
+      break;
+  }
+}
+
+void
+SegmentFetcher::expressSegment(uint64_t segment)
+{
+  Interest interest(baseInterest_);
+  interest.setName(Name(baseInterest_.getName()).appendSegment(segment));
+  pendingSegments_[segment].pendingInterestId_ = face_.expressInterest
+    (interest, bind(&SegmentFetcher::onData, this, _1, _2), bind(&SegmentFetcher::onTimeout, this, _1));
+}
+
+void
+SegmentFetcher::onData(const ptr_lib::shared_ptr<const Interest>& interest, const ptr_lib::shared_ptr<Data>& data)
+{
+  if (isFinished_)
+    return;
+
+  uint64_t segment;
+  if (!getSegment(data->getName(), segment)) {
+    fail(DATA_HAS_NO_SEGMENT, "The data name has no segment number: " + data->getName().toUri());
+    return;
+  }
+  map<uint64_t, PendingSegment>::iterator pendingSegment = pendingSegments_.find(segment);
+  if (pendingSegment == pendingSegments_.end())
+    // We already received it or removed the interest.
+    return;
+  pendingSegments_.erase(pendingSegment);
+
+  const Blob& content = data->getContent();
+  bool isNewFinalSegment = false;
+  if (finalSegment_ < 0 && data->getMetaInfo().getFinalBlockID().getValue().size() > 0) {
+    uint64_t finalSegment;
+    bool isSegment = true;
+    try {
+      finalSegment = data->getMetaInfo().getFinalBlockID().toSegment();
+    } catch (runtime_error&) {
+      // The finalBlockID is not a segment number, so keep fetching until it is found.
+      isSegment = false;
+    }
+    if (isSegment) {
+      if ((int64_t)finalSegment < 0) {
+        // finalSegment_ uses -1 for not known, so it can't hold this.
+        fail(CONTENT_TOO_LARGE, "The finalBlockID is too large in " + data->getName().toUri());
+        return;
+      }
+      finalSegment_ = (int64_t)finalSegment;
+      isNewFinalSegment = true;
+      removeSegmentsAfterFinal();
+    }
+  }
+
+  bool isNewSegmentSize = false;
+  if (!hasSegmentSize_ && (finalSegment_ < 0 || segment != (uint64_t)finalSegment_)) {
+    // The final segment may be shorter, so take the size from any other segment.
+    hasSegmentSize_ = true;
+    segmentSize_ = content.size();
+    isNewSegmentSize = true;
+  }
+
+  // Check the size before allocating, since the producer chooses the finalBlockID.
+  if (isContentTooLarge(content.size())) {
+    fail(CONTENT_TOO_LARGE, "The content exceeds the maximum content size for " + data->getName().toUri());
+    return;
+  }
+
+  if (finalSegment_ < 0 || segment <= (uint64_t)finalSegment_) {
+    try {
+      if (isNewFinalSegment || isNewSegmentSize)
+        placeStoredSegments();
+      storeSegment(segment, content);
+    } catch (std::bad_alloc&) {
+      fail(CONTENT_TOO_LARGE, "Cannot allocate the content buffer for " + data->getName().toUri());
+      return;
+    }
+    if (segment >= isReceived_.size())
+      isReceived_.resize(segment + 1);
+    isReceived_[segment] = true;
+    ++nReceived_;
+    nReceivedBytes_ += content.size();
+  }
+
+  // Additive increase: one segment per data packet in slow start, then one segment per window.
+  double slowStartThreshold = slowStartThreshold_ < 0.0 ? maxWindowSize_ : slowStartThreshold_;
+  if (windowSize_ < slowStartThreshold)
+    windowSize_ += 1.0;
+  else
+    windowSize_ += 1.0 / windowSize_;
+  if (windowSize_ > maxWindowSize_)
+    windowSize_ = maxWindowSize_;
+
+  if (finalSegment_ >= 0 && nReceived_ == (uint64_t)finalSegment_ + 1)
+    complete();
+  else
+    fillWindow();
+}
+
+void
+SegmentFetcher::onTimeout(const ptr_lib::shared_ptr<const Interest>& interest)
+{
+  if (isFinished_)
+    return;
+
+  uint64_t segment;
+  if (!getSegment(interest->getName(), segment))
+    return;
+  map<uint64_t, PendingSegment>::iterator pendingSegment = pendingSegments_.find(segment);
+  if (pendingSegment == pendingSegments_.end())
+    return;
+
+  if (++pendingSegment->second.nRetries_ > maxRetries_) {
+    fail(INTEREST_TIMEOUT, "The interest timed out for segment " + interest->getName().toUri());
+    return;
+  }
+  pendingSegment->second.pendingInterestId_ = 0;
+
+  // Multiplicative decrease, once for the segments which were pending when the window last decreased.
+  if (segment >= recoverySegment_) {
+    slowStartThreshold_ = windowSize_ / 2.0;
+    if (slowStartThreshold_ < 1.0)
+      slowStartThreshold_ = 1.0;
+    windowSize_ = slowStartThreshold_;
+    recoverySegment_ = nextSegment_;
+  }
+
+  retransmitSegments_.push_back(segment);
+  fillWindow();
+}
+
+bool
+SegmentFetcher::isContentTooLarge(size_t newSize)
+{
+  if (newSize > maxContentSize_ || nReceivedBytes_ > maxContentSize_ - newSize)
+    return true;
+
+  // The buffer has finalSegment_ + 1 segments.  Divide to avoid overflowing.
+  return finalSegment_ >= 0 && hasSegmentSize_ && segmentSize_ > 0 &&
+         (uint64_t)finalSegment_ >= maxContentSize_ / segmentSize_;
+}
+
+void
+SegmentFetcher::storeSegment(uint64_t segment, const Blob& content)
+{
+  if (!placeSegment(segment, content))
+    // The content is a slice of the data packet, so keeping it doesn't copy.
+    segments_[segment] = content;
+}
+
+bool
+SegmentFetcher::placeSegment(uint64_t segment, const Blob& content)
+{
+  if (!isOneBuffer_ || !hasSegmentSize_)
+    return false;
+
+  if (finalSegment_ >= 0 && segment == (uint64_t)finalSegment_) {
+    if (content.size() > segmentSize_) {
+      moveContentToSegments();
+      return false;
+    }
+    finalSegmentSize_ = content.size();
+  }
+  else if (content.size() != segmentSize_) {
+    if (finalSegment_ < 0 && content.size() < segmentSize_)
+      // This may be the final segment, so wait until the final segment is known.
+      return false;
+    moveContentToSegments();
+    return false;
+  }
+
+  reserveContent(segment);
+  if (content.size() > 0)
+    memcpy(&(*content_)[segment * segmentSize_], content.buf(), content.size());
+  return true;
+}
+
+void
+SegmentFetcher::placeStoredSegments()
+{
+  map<uint64_t, Blob>::iterator i = segments_.begin();
+  while (i != segments_.end() && isOneBuffer_) {
+    if (placeSegment(i->first, i->second))
+      segments_.erase(i++);
+    else
+      ++i;
+  }
+}
+
+void
+SegmentFetcher::reserveContent(uint64_t segment)
+{
+  if (!content_)
+    content_.reset(new vector<uint8_t>());
+
+  size_t size;
+  if (finalSegment_ >= 0)
+    // Allocate the final size at once.
+    size = ((size_t)finalSegment_ + 1) * segmentSize_;
+  else {
+    size = ((size_t)segment + 1) * segmentSize_;
+    if (size > content_->size() && size < 2 * content_->size())
+      size = 2 * content_->size();
+  }
+  if (size > content_->size())
+    content_->resize(size);
+}
+
+void
+SegmentFetcher::moveContentToSegments()
+{
+  isOneBuffer_ = false;
+  if (!content_)
+    return;
+
+  Blob buffer(content_);
+  for (size_t segment = 0; segment < isReceived_.size(); ++segment) {
+    if (!isReceived_[segment] || segments_.find(segment) != segments_.end())
+      continue;
+    size_t size = (finalSegment_ >= 0 && segment == (size_t)finalSegment_) ? finalSegmentSize_ : segmentSize_;
+    segments_[segment] = Blob(buffer, segment * segmentSize_, size);
+  }
+}
+
+void
+SegmentFetcher::removeSegmentsAfterFinal()
+{
+  map<uint64_t, PendingSegment>::iterator first = pendingSegments_.upper_bound((uint64_t)finalSegment_);
+  for (map<uint64_t, PendingSegment>::iterator i = first; i != pendingSegments_.end(); ++i) {
+    if (i->second.pendingInterestId_ != 0)
+      face_.removePendingInterest(i->second.pendingInterestId_);
+  }
+  pendingSegments_.erase(first, pendingSegments_.end());
+
+  deque<uint64_t> retransmitSegments;
+  for (size_t i = 0; i < retransmitSegments_.size(); ++i) {
+    if (retransmitSegments_[i] <= (uint64_t)finalSegment_)
+      retransmitSegments.push_back(retransmitSegments_[i]);
+  }
+  retransmitSegments_.swap(retransmitSegments);
+
+  if (nextSegment_ > (uint64_t)finalSegment_ + 1)
+    nextSegment_ = (uint64_t)finalSegment_ + 1;
+}
+
+void
+SegmentFetcher::complete()
+{
+  isFinished_ = true;
+
+  Blob content;
+  if (isOneBuffer_ && segments_.empty() && content_)
+    // Trim the final segment without copying.
+    content = Blob(Blob(content_), 0, (size_t)finalSegment_ * segmentSize_ + finalSegmentSize_);
+  else {
+    if (isOneBuffer_)
+      moveContentToSegments();
+
+    if (segments_.size() == 1)
+      content = segments_.begin()->second;
+    else {
+      size_t size = 0;
+      for (map<uint64_t, Blob>::iterator i = segments_.begin(); i != segments_.end(); ++i)
+        size += i->second.size();
+      ptr_lib::shared_ptr<vector<uint8_t> > value(new vector<uint8_t>());
+      value->reserve(size);
+      for (map<uint64_t, Blob>::iterator i = segments_.begin(); i != segments_.end(); ++i)
+        value->insert(value->end(), i->second.buf(), i->second.buf() + i->second.size());
+      content = Blob(value);
+    }
+  }
+  content_.reset();
+  segments_.clear();
+
+  // Call onComplete_ last, since it may delete this object.
+  onComplete_(content);
+}
+
+void
+SegmentFetcher::fail(ErrorCode errorCode, const string& message)
+{
+  isFinished_ = true;
+  for (map<uint64_t, PendingSegment>::iterator i = pendingSegments_.begin(); i != pendingSegments_.end(); ++i) {
+    if (i->second.pendingInterestId_ != 0)
+      face_.removePendingInterest(i->second.pendingInterestId_);
+  }
+  pendingSegments_.clear();
+  retransmitSegments_.clear();
+  content_.reset();
+  segments_.clear();
+
+  // Call onError_ last, since it may delete this object.
+  onError_(errorCode, message);
+}
+
+bool
+SegmentFetcher::getSegment(const Name& name, uint64_t& segment)
+{
+  size_t prefixSize = baseInterest_.getName().size();
+  if (name.size() <= prefixSize)
+    return false;
+
+  try {
+    segment = name.get(prefixSize).toSegment();
+  } catch (runtime_error&) {
+    return false;
+  }
+  return true;
+}
+
+}
@@ -0,0 +1,199 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <deque>
+#include <stdexcept>
+#include <ndn-cpp/util/thread-pool-executor.hpp>
+
+using namespace std;
+
+namespace ndn {
+
+/**
+ * A Worker has the thread and the queues of one worker.  The mutex guards both queues.
+ */
+class ThreadPoolExecutor::Worker {
+public:
+  Worker(ThreadPoolExecutor& executor)
+  : executor_(executor)
+  {
+    pthread_mutex_init(&mutex_, 0);
+  }
+
+  ~Worker()
+  {
+    pthread_mutex_destroy(&mutex_);
+  }
+
+  ThreadPoolExecutor& executor_;
+  pthread_t thread_;
+  pthread_mutex_t mutex_;
+  deque<Task> tasks_;       /**< The tasks without an orderKey, which other workers can steal. */
+  deque<Task> pinnedTasks_; /**< The tasks with an orderKey, which only this worker calls. */
+};
+
+ThreadPoolExecutor::ThreadPoolExecutor(size_t nThreads)
+: nextWorker_(0), queueDepth_(0), maxQueueDepth_(0), nSleepingWorkers_(0), isStopping_(false)
+{
+  pthread_mutex_init(&idleMutex_, 0);
+  pthread_cond_init(&idleCondition_, 0);
+
+  if (nThreads == 0)
+    nThreads = 1;
+  // Make all the workers before starting a thread, since a worker can steal from any of them.
+  for (size_t i = 0; i < nThreads; ++i)
+    workers_.push_back(new Worker(*this));
+  for (size_t i = 0; i < nThreads; ++i) {
+    if (pthread_create(&workers_[i]->thread_, 0, &ThreadPoolExecutor::run, workers_[i]) != 0) {
+      // Only join the threads which were started.
+      stop(i);
+      throw runtime_error("ThreadPoolExecutor: Error in pthread_create");
+    }
+  }
+}
+
+ThreadPoolExecutor::~ThreadPoolExecutor()
+{
+  stop(workers_.size());
+}
+
+void
+ThreadPoolExecutor::stop(size_t nStartedThreads)
+{
+  pthread_mutex_lock(&idleMutex_);
+  isStopping_ = true;
+  pthread_cond_broadcast(&idleCondition_);
+  pthread_mutex_unlock(&idleMutex_);
+
+  for (size_t i = 0; i < nStartedThreads; ++i)
+    pthread_join(workers_[i]->thread_, 0);
+  // Delete the workers after all threads are joined, since a thread can steal from any worker.
+  for (size_t i = 0; i < workers_.size(); ++i)
+    delete workers_[i];
+  workers_.clear();
+
+  pthread_cond_destroy(&idleCondition_);
+  pthread_mutex_destroy(&idleMutex_);
+}
+
+void
+ThreadPoolExecutor::execute(const Task& task, uint64_t orderKey)
+{
+  Worker *worker;
+  if (orderKey != 0)
+    worker = workers_[orderKey % workers_.size()];
+  else
+    worker = workers_[__atomic_fetch_add(&nextWorker_, 1, __ATOMIC_RELAXED) % workers_.size()];
+
+  // Count the task before a worker can pop it, so that the depth doesn't go below 0.
+  size_t queueDepth = __atomic_add_fetch(&queueDepth_, 1, __ATOMIC_RELAXED);
+  size_t maxQueueDepth = __atomic_load_n(&maxQueueDepth_, __ATOMIC_RELAXED);
+  while (queueDepth > maxQueueDepth &&
+         !__atomic_compare_exchange_n
+           (&maxQueueDepth_, &maxQueueDepth, queueDepth, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+
+  pthread_mutex_lock(&worker->mutex_);
+  if (orderKey != 0)
+    worker->pinnedTasks_.push_back(task);
+  else
+    worker->tasks_.push_back(task);
+  pthread_mutex_unlock(&worker->mutex_);
+
+  // A worker increments nSleepingWorkers_ before it checks the queues under their mutex, so if it missed this task
+  // then this sees the increment.
+  if (__atomic_load_n(&nSleepingWorkers_, __ATOMIC_SEQ_CST) > 0) {
+    pthread_mutex_lock(&idleMutex_);
+    // Only the chosen worker can call a pinned task, so wake all of them.
+    if (orderKey != 0)
+      pthread_cond_broadcast(&idleCondition_);
+    else
+      pthread_cond_signal(&idleCondition_);
+    pthread_mutex_unlock(&idleMutex_);
+  }
+}
+
+size_t
+ThreadPoolExecutor::getQueueDepth()
+{
+  return __atomic_load_n(&queueDepth_, __ATOMIC_RELAXED);
+}
+
+size_t
+ThreadPoolExecutor::getMaxQueueDepth()
+{
+  return __atomic_load_n(&maxQueueDepth_, __ATOMIC_RELAXED);
+}
+
+bool
+ThreadPoolExecutor::popTask(Worker& worker, Task& task)
+{
+  bool found = false;
+  pthread_mutex_lock(&worker.mutex_);
+  if (worker.pinnedTasks_.size() > 0) {
+    task = worker.pinnedTasks_.front();
+    worker.pinnedTasks_.pop_front();
+    found = true;
+  }
+  else if (worker.tasks_.size() > 0) {
+    task = worker.tasks_.front();
+    worker.tasks_.pop_front();
+    found = true;
+  }
+  pthread_mutex_unlock(&worker.mutex_);
+
+  // Steal the newest task of another worker, since its owner takes the oldest.
+  for (size_t i = 0; !found && i < workers_.size(); ++i) {
+    Worker& victim = *workers_[i];
+    if (&victim == &worker)
+      continue;
+    pthread_mutex_lock(&victim.mutex_);
+    if (victim.tasks_.size() > 0) {
+      task = victim.tasks_.back();
+      victim.tasks_.pop_back();
+      found = true;
+    }
+    pthread_mutex_unlock(&victim.mutex_);
+  }
+
+  if (found)
+    __atomic_sub_fetch(&queueDepth_, 1, __ATOMIC_RELAXED);
+  return found;
+}
+
+void*
+ThreadPoolExecutor::run(void *workerPointer)
+{
+  Worker& worker = *(Worker*)workerPointer;
+  ThreadPoolExecutor& executor = worker.executor_;
+  Task task;
+  while (true) {
+    if (!executor.popTask(worker, task)) {
+      pthread_mutex_lock(&executor.idleMutex_);
+      __atomic_add_fetch(&executor.nSleepingWorkers_, 1, __ATOMIC_SEQ_CST);
+      // Check again after announcing that this is sleeping, so that a task added since the last check is not missed.
+      // When stopping, return once the queues are empty so that the remaining tasks are called first.
+      bool found;
+      while (!(found = executor.popTask(worker, task)) && !executor.isStopping_)
+        pthread_cond_wait(&executor.idleCondition_, &executor.idleMutex_);
+      __atomic_sub_fetch(&executor.nSleepingWorkers_, 1, __ATOMIC_SEQ_CST);
+      pthread_mutex_unlock(&executor.idleMutex_);
+      if (!found)
+        return 0;
+    }
+
+    // Ignore all exceptions.
+    try {
+      task();
+    }
+    catch (...) { }
+    // Release what the task holds before waiting for the next one.
+    task = Task();
+  }
+}
+
+}
@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <algorithm>
+#include <functional>
+#include "timer-queue.hpp"
+
+using namespace std;
+
+namespace ndn {
+
+uint64_t
+TimerQueue::schedule(MillisecondsSince1970 timeMilliseconds, const Callback& callback)
+{
+  uint64_t timerId = ++lastTimerId_;
+  callbacks_[timerId] = callback;
+  heap_.push_back(Timer(timeMilliseconds, timerId));
+  push_heap(heap_.begin(), heap_.end(), greater<Timer>());
+
+  return timerId;
+}
+
+bool
+TimerQueue::cancel(uint64_t timerId)
+{
+  if (callbacks_.erase(timerId) == 0)
+    return false;
+
+  // Leave the Timer in the heap, but rebuild the heap once most of it is cancelled timers so that it doesn't grow
+  // without bound when timers are usually cancelled before they expire (such as interest timeouts).
+  if (heap_.size() > 64 && heap_.size() > 2 * callbacks_.size()) {
+    vector<Timer> heap;
+    heap.reserve(callbacks_.size());
+    for (size_t i = 0; i < heap_.size(); ++i) {
+      if (callbacks_.find(heap_[i].timerId_) != callbacks_.end())
+        heap.push_back(heap_[i]);
+    }
+    make_heap(heap.begin(), heap.end(), greater<Timer>());
+    heap_.swap(heap);
+  }
+
+  return true;
+}
+
+size_t
+TimerQueue::callExpired(MillisecondsSince1970 nowMilliseconds)
+{
+  // First pop all the expired timers so that a callback which schedules another timer with no delay doesn't make
+  // this loop forever.
+  vector<uint64_t> expired;
+  while (heap_.size() > 0 && heap_.front().timeMilliseconds_ <= nowMilliseconds) {
+    expired.push_back(heap_.front().timerId_);
+    pop_heap(heap_.begin(), heap_.end(), greater<Timer>());
+    heap_.pop_back();
+  }
+
+  size_t nCalled = 0;
+  for (size_t i = 0; i < expired.size(); ++i) {
+    // An earlier callback may have cancelled this timer.
+    map<uint64_t, Callback>::iterator entry = callbacks_.find(expired[i]);
+    if (entry == callbacks_.end())
+      continue;
+
+    Callback callback = entry->second;
+    callbacks_.erase(entry);
+    ++nCalled;
+    try {
+      callback();
+    }
+    catch (...) {
+      // Put back the timers which were not called so that they are called next time.
+      for (size_t j = i + 1; j < expired.size(); ++j) {
+        if (callbacks_.find(expired[j]) != callbacks_.end()) {
+          heap_.push_back(Timer(nowMilliseconds, expired[j]));
+          push_heap(heap_.begin(), heap_.end(), greater<Timer>());
+        }
+      }
+      throw;
+    }
+  }
+
+  return nCalled;
+}
+
+MillisecondsSince1970
+TimerQueue::getNextTimeMilliseconds()
+{
+  popCancelled();
+  if (heap_.size() == 0)
+    return -1.0;
+  return heap_.front().timeMilliseconds_;
+}
+
+void
+TimerQueue::popCancelled()
+{
+  while (heap_.size() > 0 && callbacks_.find(heap_.front().timerId_) == callbacks_.end()) {
+    pop_heap(heap_.begin(), heap_.end(), greater<Timer>());
+    heap_.pop_back();
+  }
+}
+
+}
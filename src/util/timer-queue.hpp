@@ -0,0 +1,110 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_TIMER_QUEUE_HPP
+#define NDN_TIMER_QUEUE_HPP
+
+#include <map>
+#include <vector>
+#include <ndn-cpp/common.hpp>
+
+namespace ndn {
+
+/**
+ * A TimerQueue holds callbacks to call at a given time.  The timers are kept in a min-heap on the time, so that
+ * checking for expired timers only touches the timers which expired.  A cancelled timer is left in the heap and
+ * skipped when it reaches the top, and the heap is compacted when it holds too many cancelled timers.
+ */
+class TimerQueue {
+public:
+  typedef func_lib::function<void()> Callback;
+
+  TimerQueue()
+  : lastTimerId_(0)
+  {
+  }
+
+  /**
+   * Add a timer to call callback at the given time.
+   * @param timeMilliseconds The time to call callback in milliseconds according to ndn_getNowMilliseconds.
+   * @param callback The function object to call.  This copies the function object.
+   * @return The timer ID which can be used with cancel.
+   */
+  uint64_t
+  schedule(MillisecondsSince1970 timeMilliseconds, const Callback& callback);
+
+  /**
+   * Cancel the timer with the timerId so that its callback is not called.  If there is no timer with the timerId
+   * (or it was already called), do nothing.
+   * @param timerId The ID returned from schedule.
+   * @return true if the timer was found and cancelled, otherwise false.
+   */
+  bool
+  cancel(uint64_t timerId);
+
+  /**
+   * Call the callback of each timer whose time is not later than nowMilliseconds, in order of the time.  A timer
+   * scheduled by one of the callbacks is not called until the next call to callExpired.
+   * @param nowMilliseconds The current time in milliseconds according to ndn_getNowMilliseconds.
+   * @return The number of callbacks called.
+   * @throw This passes through an exception from a callback.  The timers which were not yet called stay in the queue.
+   */
+  size_t
+  callExpired(MillisecondsSince1970 nowMilliseconds);
+
+  /**
+   * Get the time of the earliest timer which is not cancelled.
+   * @return The time in milliseconds according to ndn_getNowMilliseconds, or -1 if there are no timers.
+   */
+  MillisecondsSince1970
+  getNextTimeMilliseconds();
+
+  /**
+   * Get the number of timers which are not cancelled or called.
+   * @return The number of timers.
+   */
+  size_t
+  size() const { return callbacks_.size(); }
+
+private:
+  class Timer {
+  public:
+    Timer(MillisecondsSince1970 timeMilliseconds, uint64_t timerId)
+    : timeMilliseconds_(timeMilliseconds), timerId_(timerId)
+    {
+    }
+
+    /**
+     * Return true if this timer is later than other, so that the heap keeps the earliest timer on top.  Timers
+     * with the same time are ordered by timerId, which is the order they were scheduled.
+     */
+    bool
+    operator>(const Timer& other) const
+    {
+      if (timeMilliseconds_ != other.timeMilliseconds_)
+        return timeMilliseconds_ > other.timeMilliseconds_;
+      return timerId_ > other.timerId_;
+    }
+
+    MillisecondsSince1970 timeMilliseconds_;
+    uint64_t timerId_;
+  };
+
+  /**
+   * Pop cancelled timers off the top of the heap.
+   */
+  void
+  popCancelled();
+
+  std::vector<Timer> heap_;                  /**< A min-heap of all timers, including cancelled ones. */
+  std::map<uint64_t, Callback> callbacks_;   /**< The callback of each timer which is not cancelled, keyed by timerId. */
+  uint64_t lastTimerId_;
+};
+
+}
+
+#endif
@@ -11,6 +11,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <ndn-cpp/data.hpp>
+#include <ndn-cpp/interest.hpp>
 #include <ndn-cpp/sha256-with-rsa-signature.hpp>
 #include <ndn-cpp/key-locator.hpp>
 #include <ndn-cpp/security/key-chain.hpp>
@@ -22,6 +23,8 @@
 #include "../src/c/data.h"
 #include "../src/c/encoding/binary-xml-data.h"
 #include "../src/c/util/crypto.h"
+#include "../src/c/encoding/binary-xml-element-reader.h"
+#include "../src/c/util/ndn_realloc.h"
 
 using namespace std;
 using namespace ndn;
@@ -226,7 +229,7 @@ benchmarkDecodeDataSecondsCpp(int nIterations, bool useCrypto, const Blob& encod
   double start = getNowSeconds();
   for (int i = 0; i < nIterations; ++i) {
     ptr_lib::shared_ptr<Data> data(new Data());
-    data->wireDecode(*encoding);
+    data->wireDecode(encoding);
     
     if (useCrypto)
       keyChain.verifyData(data, onVerified, onVerifyFailed);
@@ -467,6 +470,162 @@ benchmarkEncodeDecodeDataC(bool useComplex, bool useCrypto)
   }
 }
 
+/**
+ * Loop to encode an interest nIterations times using C++.
+ * @param nIterations The number of iterations.
+ * @param useComplex If true, use a large name and all selectors.  If false, use a small name and no selectors.
+ * @param encoding Set this to the wire encoding.
+ * @return The number of seconds for all iterations.
+ */
+static double
+benchmarkEncodeInterestSecondsCpp(int nIterations, bool useComplex, Blob& encoding)
+{
+  Interest interest;
+  if (useComplex) {
+    interest.setName(Name("/ndn/ucla.edu/apps/lwndn-test/numbers.txt/%FD%05%05%E8%0C%CE%1D"));
+    interest.setMinSuffixComponents(2);
+    interest.setMaxSuffixComponents(4);
+    interest.setChildSelector(1);
+    interest.setAnswerOriginKind(3);
+    interest.setScope(2);
+    interest.setInterestLifetimeMilliseconds(30000);
+    interest.setNonce(Blob((uint8_t*)"\x61\x62\x61\x62", 4));
+    uint8_t publisherPublicKeyDigest[32];
+    memset(publisherPublicKeyDigest, 0x22, sizeof(publisherPublicKeyDigest));
+    interest.getPublisherPublicKeyDigest().setPublisherPublicKeyDigest
+      (Blob(publisherPublicKeyDigest, sizeof(publisherPublicKeyDigest)));
+    interest.getExclude().appendComponent((uint8_t*)"abc", 3);
+    interest.getExclude().appendAny();
+  }
+  else
+    interest.setName(Name("/test"));
+
+  double start = getNowSeconds();
+  for (int i = 0; i < nIterations; ++i)
+    encoding = interest.wireEncode();
+  double finish = getNowSeconds();
+
+  return finish - start;
+}
+
+/**
+ * Loop to decode an interest nIterations times using C++.
+ * @param nIterations The number of iterations.
+ * @param encoding The wire encoding to decode.
+ * @return The number of seconds for all iterations.
+ */
+static double
+benchmarkDecodeInterestSecondsCpp(int nIterations, const Blob& encoding)
+{
+  double start = getNowSeconds();
+  for (int i = 0; i < nIterations; ++i) {
+    Interest interest;
+    interest.wireDecode(encoding);
+  }
+  double finish = getNowSeconds();
+
+  return finish - start;
+}
+
+/**
+ * Call benchmarkEncodeInterestSecondsCpp and benchmarkDecodeInterestSecondsCpp.  Print the results to cout.
+ * @param useComplex See benchmarkEncodeInterestSecondsCpp.
+ */
+static void
+benchmarkEncodeDecodeInterestCpp(bool useComplex)
+{
+  Blob encoding;
+  int nIterations = 2000000;
+  {
+    double duration = benchmarkEncodeInterestSecondsCpp(nIterations, useComplex, encoding);
+    cout << "Encode " << (useComplex ? "complex" : "simple ") << " interest C++: Duration sec, Hz: " << duration << ", "
+         << (nIterations / duration) << endl;
+  }
+  {
+    double duration = benchmarkDecodeInterestSecondsCpp(nIterations, encoding);
+    cout << "Decode " << (useComplex ? "complex" : "simple ") << " interest C++: Duration sec, Hz: " << duration << ", "
+         << (nIterations / duration) << endl;
+  }
+}
+
+/**
+ * An ElementCounter extends ndn_ElementListener to count the received elements and their total length.
+ */
+struct ElementCounter {
+  struct ndn_ElementListener base;
+  size_t nElements;
+  size_t totalLength;
+};
+
+static void
+onReceivedElementCount(struct ndn_ElementListener *self, uint8_t *element, size_t elementLength)
+{
+  ++((struct ElementCounter *)self)->nElements;
+  ((struct ElementCounter *)self)->totalLength += elementLength;
+}
+
+/**
+ * Loop to give the encoding to a new ndn_BinaryXmlElementReader in chunks of chunkSize bytes, as if received by a
+ * transport, and return the number of seconds.
+ * @param nIterations The number of times to read the whole encoding.
+ * @param encoding The encoding of one element.
+ * @param chunkSize The number of bytes to give to each call to ndn_BinaryXmlElementReader_onReceivedData.
+ * @return The number of seconds for all iterations.
+ */
+static double
+benchmarkElementReaderSeconds(size_t nIterations, const Blob& encoding, size_t chunkSize)
+{
+  struct ElementCounter counter;
+  ndn_ElementListener_initialize(&counter.base, onReceivedElementCount);
+  counter.nElements = 0;
+  counter.totalLength = 0;
+  // Copy the encoding since onReceivedData takes a non-const pointer.
+  vector<uint8_t> data(encoding.buf(), encoding.buf() + encoding.size());
+  
+  double start = getNowSeconds();
+  for (size_t i = 0; i < nIterations; ++i) {
+    // Start with the same initial buffer length as TcpTransport.
+    const size_t initialLength = 1000;
+    struct ndn_BinaryXmlElementReader elementReader;
+    ndn_BinaryXmlElementReader_initialize
+      (&elementReader, &counter.base, (uint8_t *)malloc(initialLength), initialLength, ndn_realloc);
+    
+    for (size_t offset = 0; offset < data.size(); offset += chunkSize) {
+      ndn_Error error;
+      if ((error = ndn_BinaryXmlElementReader_onReceivedData
+           (&elementReader, &data[offset], min(chunkSize, data.size() - offset))))
+        throw runtime_error(ndn_getErrorString(error));
+    }
+    
+    free(elementReader.partialData.array);
+  }
+  double finish = getNowSeconds();
+  
+  if (counter.nElements != nIterations || counter.totalLength != nIterations * data.size())
+    throw runtime_error("benchmarkElementReaderSeconds: The element reader did not return the whole element");
+  
+  return finish - start;
+}
+
+/**
+ * Call benchmarkElementReaderSeconds for a 1 MB data packet with chunk sizes from 1 byte to 64 KB.  Print the results 
+ * to cout.
+ */
+static void
+benchmarkElementReader()
+{
+  Data data(Name("/ndn/ucla.edu/apps/element-reader-test"));
+  data.setContent(vector<uint8_t>(1000000, 'x'));
+  Blob encoding = data.wireEncode();
+  
+  for (size_t chunkSize = 1; chunkSize <= 65536; chunkSize *= 16) {
+    size_t nIterations = chunkSize == 1 ? 10 : 200;
+    double duration = benchmarkElementReaderSeconds(nIterations, encoding, chunkSize);
+    cout << "Element reader: 1 MB data in " << chunkSize << " byte chunks, Duration sec, MB/s: " << duration << ", " 
+         << (nIterations * encoding.size() / 1000000.0 / duration) << endl;  
+  }
+}
+
 int 
 main(int argc, char** argv)
 {
@@ -480,6 +639,11 @@ main(int argc, char** argv)
     benchmarkEncodeDecodeDataC(true, false);
     benchmarkEncodeDecodeDataC(false, true);
     benchmarkEncodeDecodeDataC(true, true);
+    
+    benchmarkEncodeDecodeInterestCpp(false);
+    benchmarkEncodeDecodeInterestCpp(true);
+    
+    benchmarkElementReader();
   } catch (std::exception& e) {
     cout << "exception: " << e.what() << endl;
   }
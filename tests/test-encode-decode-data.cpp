@@ -122,9 +122,9 @@ static void dumpData(const Data& data)
   if (data.getContent().size() > 0) {
     cout << "content (raw): ";
     for (size_t i = 0; i < data.getContent().size(); ++i)
-      cout << (*data.getContent())[i];
+      cout << data.getContent().buf()[i];
     cout<< endl;
-    cout << "content (hex): " << toHex(*data.getContent()) << endl;
+    cout << "content (hex): " << data.getContent().toHex() << endl;
   }
   else
     cout << "content: <empty>" << endl;
@@ -156,25 +156,25 @@ static void dumpData(const Data& data)
     cout << "<none>" << endl;
   cout << "metaInfo.finalBlockID: "
        << (data.getMetaInfo().getFinalBlockID().getValue().size() > 0 ? 
-           toHex(*data.getMetaInfo().getFinalBlockID().getValue()).c_str() : "<none>") << endl;
+           data.getMetaInfo().getFinalBlockID().getValue().toHex().c_str() : "<none>") << endl;
     
   const Sha256WithRsaSignature *signature = dynamic_cast<const Sha256WithRsaSignature*>(data.getSignature());
   if (signature) {
     cout << "signature.digestAlgorithm: "
-         << (signature->getDigestAlgorithm().size() > 0 ? toHex(*signature->getDigestAlgorithm()).c_str() : "default (sha-256)") << endl;
+         << (signature->getDigestAlgorithm().size() > 0 ? signature->getDigestAlgorithm().toHex().c_str() : "default (sha-256)") << endl;
     cout << "signature.witness: "
-         << (signature->getWitness().size() > 0 ? toHex(*signature->getWitness()).c_str() : "<none>") << endl;
+         << (signature->getWitness().size() > 0 ? signature->getWitness().toHex().c_str() : "<none>") << endl;
     cout << "signature.signature: "
-         << (signature->getSignature().size() > 0 ? toHex(*signature->getSignature()).c_str() : "<none>") << endl;
+         << (signature->getSignature().size() > 0 ? signature->getSignature().toHex().c_str() : "<none>") << endl;
     cout << "signature.publisherPublicKeyDigest: "
          << (signature->getPublisherPublicKeyDigest().getPublisherPublicKeyDigest().size() > 0 ? 
-           toHex(*signature->getPublisherPublicKeyDigest().getPublisherPublicKeyDigest()).c_str() : "<none>") << endl;
+           signature->getPublisherPublicKeyDigest().getPublisherPublicKeyDigest().toHex().c_str() : "<none>") << endl;
     cout << "signature.keyLocator: ";
     if ((int)signature->getKeyLocator().getType() >= 0) {
       if (signature->getKeyLocator().getType() == ndn_KeyLocatorType_KEY)
-        cout << "Key: " << toHex(*signature->getKeyLocator().getKeyData()) << endl;
+        cout << "Key: " << signature->getKeyLocator().getKeyData().toHex() << endl;
       else if (signature->getKeyLocator().getType() == ndn_KeyLocatorType_CERTIFICATE)
-        cout << "Certificate: " << toHex(*signature->getKeyLocator().getKeyData()) << endl;
+        cout << "Certificate: " << signature->getKeyLocator().getKeyData().toHex() << endl;
       else if (signature->getKeyLocator().getType() == ndn_KeyLocatorType_KEYNAME) {
         cout << "KeyName: " << signature->getKeyLocator().getKeyName().to_uri() << endl;
         cout << "signature.keyLocator: ";
@@ -194,7 +194,7 @@ static void dumpData(const Data& data)
           }
           if (showKeyNameData)
             cout << (signature->getKeyLocator().getKeyData().size() > 0 ?
-                     toHex(*signature->getKeyLocator().getKeyData()).c_str() : "<none>") << endl;
+                     signature->getKeyLocator().getKeyData().toHex().c_str() : "<none>") << endl;
         }
         else
           cout << "<no key digest>" << endl;
@@ -228,7 +228,7 @@ int main(int argc, char** argv)
     Blob encoding = data->wireEncode();
     
     ptr_lib::shared_ptr<Data> reDecodedData(new Data());
-    reDecodedData->wireDecode(*encoding);
+    reDecodedData->wireDecode(encoding);
     cout << endl << "Re-decoded Data:" << endl;
     dumpData(*reDecodedData);
   
@@ -58,12 +58,12 @@ uint8_t Interest1[] = {
 1
 };
 
-static inline string toString(const vector<uint8_t>& v)
+static inline string toString(const Blob& v)
 {
-  if (!&v)
+  if (!v)
     return "";
   
-  return string(&v[0], &v[0] + v.size());
+  return string(v.buf(), v.buf() + v.size());
 }
 
 static void dumpForwardingEntry(const ForwardingEntry& forwardingEntry) 
@@ -71,7 +71,7 @@ static void dumpForwardingEntry(const ForwardingEntry& forwardingEntry)
   cout << "action: " << forwardingEntry.getAction() << endl;
   cout << "prefix: " << forwardingEntry.getPrefix().to_uri() << endl;
   cout << "publisherPublicKeyDigest: " 
-       << (forwardingEntry.getPublisherPublicKeyDigest().getPublisherPublicKeyDigest().size() > 0 ? toHex(*forwardingEntry.getPublisherPublicKeyDigest().getPublisherPublicKeyDigest()) : "<none>") << endl;
+       << (forwardingEntry.getPublisherPublicKeyDigest().getPublisherPublicKeyDigest().size() > 0 ? forwardingEntry.getPublisherPublicKeyDigest().getPublisherPublicKeyDigest().toHex() : "<none>") << endl;
   cout << "faceId: ";
   if (forwardingEntry.getFaceId() >= 0)
     cout << forwardingEntry.getFaceId() << endl;
@@ -120,16 +120,16 @@ static void dumpInterestWithForwardingEntry(const Interest& interest)
     cout << interest.getScope() << endl;
   else
     cout << "<none>" << endl;
-  cout << "name[0]: " << toString(*interest.getName().getComponent(0).getValue()) << endl;
-  cout << "name[1]: " << toHex(*interest.getName().getComponent(1).getValue()) << endl;
-  cout << "name[2]: " << toString(*interest.getName().getComponent(2).getValue()) << endl;
+  cout << "name[0]: " << toString(interest.getName().getComponent(0).getValue()) << endl;
+  cout << "name[1]: " << interest.getName().getComponent(1).getValue().toHex() << endl;
+  cout << "name[2]: " << toString(interest.getName().getComponent(2).getValue()) << endl;
   cout << "name[3] decoded as Data, showing content as ForwardingEntry: " << endl;
   
   Data data;
-  data.wireDecode(*interest.getName().getComponent(3).getValue());
+  data.wireDecode(interest.getName().getComponent(3).getValue());
   
   ForwardingEntry forwardingEntry;
-  forwardingEntry.wireDecode(*data.getContent());
+  forwardingEntry.wireDecode(data.getContent().buf(), data.getContent().size());
   dumpForwardingEntry(forwardingEntry);
 }
 
@@ -142,10 +142,10 @@ int main(int argc, char** argv)
     dumpInterestWithForwardingEntry(interest);
     
     Blob encoding = interest.wireEncode();
-    cout << endl << "Re-encoded interest " << toHex(*encoding) << endl;
+    cout << endl << "Re-encoded interest " << encoding.toHex() << endl;
 
     Interest reDecodedInterest;
-    reDecodedInterest.wireDecode(*encoding);
+    reDecodedInterest.wireDecode(encoding);
     cout << "Re-decoded Interest:" << endl;
     dumpInterestWithForwardingEntry(reDecodedInterest);
   } catch (exception& e) {
@@ -45,7 +45,7 @@ static void dumpInterest(const Interest& interest)
   else
     cout << "<none>" << endl;
   cout << "publisherPublicKeyDigest: " 
-       << (interest.getPublisherPublicKeyDigest().getPublisherPublicKeyDigest().size() > 0 ? toHex(*interest.getPublisherPublicKeyDigest().getPublisherPublicKeyDigest()) : "<none>") << endl;
+       << (interest.getPublisherPublicKeyDigest().getPublisherPublicKeyDigest().size() > 0 ? interest.getPublisherPublicKeyDigest().getPublisherPublicKeyDigest().toHex() : "<none>") << endl;
   cout << "exclude: " 
        << (interest.getExclude().getEntryCount() > 0 ? interest.getExclude().toUri() : "<none>") << endl;
   cout << "lifetimeMilliseconds: ";
@@ -69,7 +69,7 @@ static void dumpInterest(const Interest& interest)
   else
     cout << "<none>" << endl;
   cout << "nonce: " 
-       << (interest.getNonce().size() > 0 ? toHex(*interest.getNonce()) : "<none>") << endl;
+       << (interest.getNonce().size() > 0 ? interest.getNonce().toHex() : "<none>") << endl;
 }
 
 int main(int argc, char** argv)
@@ -81,10 +81,10 @@ int main(int argc, char** argv)
     dumpInterest(interest);
     
     Blob encoding = interest.wireEncode();
-    cout << endl << "Re-encoded interest " << toHex(*encoding) << endl;
+    cout << endl << "Re-encoded interest " << encoding.toHex() << endl;
 
     Interest reDecodedInterest;
-    reDecodedInterest.wireDecode(*encoding);
+    reDecodedInterest.wireDecode(encoding);
     cout << "Re-decoded Interest:" << endl;
     dumpInterest(reDecodedInterest);
   } catch (exception& e) {
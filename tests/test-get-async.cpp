@@ -7,7 +7,6 @@
 #include <cstdlib>
 #include <sstream>
 #include <iostream>
-#include <unistd.h>
 #include <ndn-cpp/face.hpp>
 
 using namespace std;
@@ -30,7 +29,7 @@ public:
     ++callbackCount_;
     cout << "Got data packet with name " << data->getName().to_uri() << endl;
     for (size_t i = 0; i < data->getContent().size(); ++i)
-      cout << (*data->getContent())[i];
+      cout << data->getContent().buf()[i];
     cout << endl;  
   }
 
@@ -66,11 +65,9 @@ int main(int argc, char** argv)
     face.expressInterest(name3, bind(&Counter::onData, &counter, _1, _2), bind(&Counter::onTimeout, &counter, _1));
 
     // The main event loop.
-    while (counter.callbackCount_ < 3) {
-      face.processEvents();
-      // We need to sleep for a few milliseconds so we don't use 100% of the CPU.
-      usleep(10000);
-    }
+    while (counter.callbackCount_ < 3)
+      // Block until there is an event so we don't use 100% of the CPU.
+      face.processEvents(1000.0);
   } catch (std::exception& e) {
     cout << "exception: " << e.what() << endl;
   }
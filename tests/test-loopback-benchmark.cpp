@@ -0,0 +1,514 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <stdexcept>
+#include <string.h>
+#include <time.h>
+#include <poll.h>
+#include <sys/time.h>
+#include <ndn-cpp/face.hpp>
+#include <ndn-cpp/transport/loopback-transport.hpp>
+#include <ndn-cpp/transport/mini-forwarder.hpp>
+#include <ndn-cpp/util/segment-fetcher.hpp>
+
+using namespace std;
+using namespace ndn;
+using namespace ndn::func_lib;
+#if NDN_CPP_HAVE_STD_FUNCTION
+// In the std library, the placeholders are in a different namespace than boost.
+using namespace func_lib::placeholders;
+#endif
+
+static double
+getNowSeconds()
+{
+  struct timeval t;
+  gettimeofday(&t, 0);
+  return t.tv_sec + t.tv_usec / 1000000.0;
+}
+
+/**
+ * Make the name of data packet number i.
+ * @param i The data packet number.
+ * @return The name /ndn/ucla.edu/apps/loopback-test/<i> .
+ */
+static Name
+makeName(int i)
+{
+  ostringstream number;
+  number << i;
+  return Name("/ndn/ucla.edu/apps/loopback-test").append((const uint8_t *)number.str().c_str(), number.str().size());
+}
+
+/**
+ * A Producer answers each interest with a data packet of the same name.
+ */
+class Producer {
+public:
+  Producer(size_t contentLength)
+  : content_(contentLength, 'x'), interestCount_(0)
+  {
+  }
+
+  void
+  onInterest
+    (const ptr_lib::shared_ptr<const Name>& prefix, const ptr_lib::shared_ptr<const Interest>& interest,
+     Transport& transport, uint64_t registeredPrefixId)
+  {
+    ++interestCount_;
+    Data data(interest->getName());
+    data.setContent(content_);
+    transport.send(data.wireEncode());
+  }
+
+  void
+  onRegisterFailed(const ptr_lib::shared_ptr<const Name>& prefix)
+  {
+    throw runtime_error("Register failed for prefix " + prefix->toUri());
+  }
+
+  vector<uint8_t> content_;
+  int interestCount_;
+};
+
+/**
+ * A Consumer keeps up to window interests pending, expressing the next one each time data arrives.
+ */
+class Consumer {
+public:
+  Consumer(Face& face, int nInterests, int window)
+  : face_(face), nInterests_(nInterests), window_(window), nExpressed_(0), dataCount_(0), nBytes_(0)
+  {
+  }
+
+  void
+  expressInterests()
+  {
+    while (nExpressed_ < nInterests_ && nExpressed_ - dataCount_ < window_) {
+      face_.expressInterest
+        (makeName(nExpressed_), bind(&Consumer::onData, this, _1, _2), bind(&Consumer::onTimeout, this, _1));
+      ++nExpressed_;
+    }
+  }
+
+  void
+  onData(const ptr_lib::shared_ptr<const Interest>& interest, const ptr_lib::shared_ptr<Data>& data)
+  {
+    ++dataCount_;
+    nBytes_ += data->getContent().size();
+    expressInterests();
+  }
+
+  void
+  onTimeout(const ptr_lib::shared_ptr<const Interest>& interest)
+  {
+    throw runtime_error("Timeout for interest " + interest->getName().toUri());
+  }
+
+  bool
+  isDone() const { return dataCount_ >= nInterests_; }
+
+  Face& face_;
+  int nInterests_;
+  int window_;
+  int nExpressed_;
+  int dataCount_;
+  size_t nBytes_;
+};
+
+/**
+ * Connect a producer Face and nConsumers consumer Faces to one MiniForwarder.  Each consumer fetches the same
+ * nInterests data packets, keeping up to window interests pending, so the forwarder aggregates the interests from
+ * different consumers which are pending at the same time.
+ * @param nConsumers The number of consumer Faces.
+ * @param nInterests The number of data packets which each consumer fetches.
+ * @param window The number of pending interests of each consumer.
+ * @param contentLength The number of bytes in the content of each data packet.
+ * @param nProducerInterests Set this to the number of interests which reached the producer.
+ * @return The number of seconds for all consumers to receive all the data.
+ */
+static double
+benchmarkLoopbackSeconds(int nConsumers, int nInterests, int window, size_t contentLength, int& nProducerInterests)
+{
+  ptr_lib::shared_ptr<MiniForwarder> forwarder(new MiniForwarder());
+  ptr_lib::shared_ptr<LoopbackTransport::ConnectionInfo> connectionInfo
+    (new LoopbackTransport::ConnectionInfo(forwarder));
+
+  Face producerFace(ptr_lib::make_shared<LoopbackTransport>(), connectionInfo);
+  Producer producer(contentLength);
+  producerFace.registerPrefix
+    (Name("/ndn/ucla.edu/apps/loopback-test"), bind(&Producer::onInterest, &producer, _1, _2, _3, _4),
+     bind(&Producer::onRegisterFailed, &producer, _1));
+  // Process the ndndId request and the selfreg interest.
+  while (forwarder->getFibSize() == 0)
+    producerFace.processEvents();
+
+  vector<ptr_lib::shared_ptr<Face> > consumerFaces;
+  vector<ptr_lib::shared_ptr<Consumer> > consumers;
+  for (int i = 0; i < nConsumers; ++i) {
+    consumerFaces.push_back(ptr_lib::make_shared<Face>(ptr_lib::make_shared<LoopbackTransport>(), connectionInfo));
+    consumers.push_back(ptr_lib::shared_ptr<Consumer>(new Consumer(*consumerFaces[i], nInterests, window)));
+  }
+
+  double start = getNowSeconds();
+  for (int i = 0; i < nConsumers; ++i)
+    consumers[i]->expressInterests();
+  while (true) {
+    bool isDone = true;
+    for (int i = 0; i < nConsumers; ++i) {
+      consumerFaces[i]->processEvents();
+      if (!consumers[i]->isDone())
+        isDone = false;
+    }
+    if (isDone)
+      break;
+    producerFace.processEvents();
+  }
+  double duration = getNowSeconds() - start;
+
+  for (int i = 0; i < nConsumers; ++i) {
+    if (consumers[i]->nBytes_ != (size_t)nInterests * contentLength)
+      throw runtime_error("benchmarkLoopbackSeconds: A consumer didn't receive all the content");
+  }
+  if (forwarder->getPitSize() != 0)
+    throw runtime_error("benchmarkLoopbackSeconds: The forwarder PIT is not empty");
+  nProducerInterests = producer.interestCount_;
+
+  return duration;
+}
+
+/**
+ * Connect a producer Face and nConsumers consumer Faces to one MiniForwarder, like benchmarkLoopbackSeconds, but run
+ * an event loop which blocks in poll() on the file descriptors of all the LoopbackTransport objects and calls
+ * processEvents(timeoutMilliseconds) of each Face whose file descriptor is readable.  Check that a file descriptor is
+ * readable exactly when the forwarder has sent an element to its face.
+ * @param nConsumers The number of consumer Faces.
+ * @param nInterests The number of data packets which each consumer fetches.
+ * @param window The number of pending interests of each consumer.
+ * @param contentLength The number of bytes in the content of each data packet.
+ * @param nWaits Set this to the number of calls to poll().
+ * @return The number of seconds for all consumers to receive all the data.
+ */
+static double
+benchmarkLoopbackEventLoopSeconds(int nConsumers, int nInterests, int window, size_t contentLength, int& nWaits)
+{
+  ptr_lib::shared_ptr<MiniForwarder> forwarder(new MiniForwarder());
+  ptr_lib::shared_ptr<LoopbackTransport::ConnectionInfo> connectionInfo
+    (new LoopbackTransport::ConnectionInfo(forwarder));
+
+  // faces[0] is the producer.
+  vector<ptr_lib::shared_ptr<LoopbackTransport> > transports;
+  vector<ptr_lib::shared_ptr<Face> > faces;
+  transports.push_back(ptr_lib::make_shared<LoopbackTransport>());
+  faces.push_back(ptr_lib::make_shared<Face>(transports[0], connectionInfo));
+  Producer producer(contentLength);
+  faces[0]->registerPrefix
+    (Name("/ndn/ucla.edu/apps/loopback-test"), bind(&Producer::onInterest, &producer, _1, _2, _3, _4),
+     bind(&Producer::onRegisterFailed, &producer, _1));
+  // Process the ndndId request and the selfreg interest.
+  while (forwarder->getFibSize() == 0)
+    faces[0]->processEvents();
+
+  vector<ptr_lib::shared_ptr<Consumer> > consumers;
+  for (int i = 0; i < nConsumers; ++i) {
+    transports.push_back(ptr_lib::make_shared<LoopbackTransport>());
+    faces.push_back(ptr_lib::make_shared<Face>(transports.back(), connectionInfo));
+    consumers.push_back(ptr_lib::shared_ptr<Consumer>(new Consumer(*faces.back(), nInterests, window)));
+  }
+
+  double start = getNowSeconds();
+  for (int i = 0; i < nConsumers; ++i)
+    consumers[i]->expressInterests();
+  vector<struct pollfd> pollInfo(faces.size());
+  nWaits = 0;
+  while (true) {
+    bool isDone = true;
+    for (int i = 0; i < nConsumers; ++i) {
+      if (!consumers[i]->isDone())
+        isDone = false;
+    }
+    if (isDone)
+      break;
+
+    for (size_t i = 0; i < faces.size(); ++i) {
+      pollInfo[i].fd = transports[i]->getFileDescriptor();
+      pollInfo[i].events = POLLIN;
+      pollInfo[i].revents = 0;
+    }
+    ++nWaits;
+    if (poll(&pollInfo[0], pollInfo.size(), 1000) <= 0)
+      throw runtime_error("benchmarkLoopbackEventLoopSeconds: No file descriptor became readable");
+    for (size_t i = 0; i < faces.size(); ++i) {
+      if (!(pollInfo[i].revents & POLLIN))
+        continue;
+      // This doesn't wait since the face has received elements.
+      if (faces[i]->processEvents(1000) == 0)
+        throw runtime_error("benchmarkLoopbackEventLoopSeconds: The file descriptor is readable with no element");
+    }
+  }
+  double duration = getNowSeconds() - start;
+
+  for (int i = 0; i < nConsumers; ++i) {
+    if (consumers[i]->nBytes_ != (size_t)nInterests * contentLength)
+      throw runtime_error("benchmarkLoopbackEventLoopSeconds: A consumer didn't receive all the content");
+  }
+  if (forwarder->getPitSize() != 0)
+    throw runtime_error("benchmarkLoopbackEventLoopSeconds: The forwarder PIT is not empty");
+  // Nothing is in flight, so no file descriptor should be readable.
+  for (size_t i = 0; i < faces.size(); ++i) {
+    pollInfo[i].fd = transports[i]->getFileDescriptor();
+    pollInfo[i].events = POLLIN;
+  }
+  if (poll(&pollInfo[0], pollInfo.size(), 0) != 0)
+    throw runtime_error("benchmarkLoopbackEventLoopSeconds: A file descriptor is readable after all events");
+
+  return duration;
+}
+
+/**
+ * A SegmentProducer answers an interest for segment i of its content with a data packet whose content is the slice
+ * of segment i and whose finalBlockID is the last segment.
+ */
+class SegmentProducer {
+public:
+  SegmentProducer(const Blob& content, size_t segmentSize)
+  : content_(content), segmentSize_(segmentSize),
+    nSegments_(content.size() == 0 ? 1 : (content.size() + segmentSize - 1) / segmentSize),
+    finalBlockID_(Name::Component::fromNumberWithMarker(nSegments_ - 1, 0x00))
+  {
+  }
+
+  void
+  onInterest
+    (const ptr_lib::shared_ptr<const Name>& prefix, const ptr_lib::shared_ptr<const Interest>& interest,
+     Transport& transport, uint64_t registeredPrefixId)
+  {
+    uint64_t segment = interest->getName().get(prefix->size()).toSegment();
+    if (segment >= nSegments_)
+      return;
+    size_t offset = segment * segmentSize_;
+    size_t size = offset + segmentSize_ <= content_.size() ? segmentSize_ : content_.size() - offset;
+
+    Data data(interest->getName());
+    data.getMetaInfo().setFinalBlockID(finalBlockID_);
+    data.setContent(Blob(content_, offset, size));
+    transport.send(data.wireEncode());
+  }
+
+  void
+  onRegisterFailed(const ptr_lib::shared_ptr<const Name>& prefix)
+  {
+    throw runtime_error("Register failed for prefix " + prefix->toUri());
+  }
+
+  Blob content_;
+  size_t segmentSize_;
+  uint64_t nSegments_;
+  Name::Component finalBlockID_;
+};
+
+/**
+ * A FetchResult keeps the content or the error from a SegmentFetcher.
+ */
+class FetchResult {
+public:
+  FetchResult()
+  : isDone_(false), errorCode_(0)
+  {
+  }
+
+  void
+  onComplete(const Blob& content)
+  {
+    content_ = content;
+    isDone_ = true;
+  }
+
+  void
+  onError(SegmentFetcher::ErrorCode errorCode, const string& message)
+  {
+    errorCode_ = errorCode;
+    message_ = message;
+    isDone_ = true;
+  }
+
+  Blob content_;
+  bool isDone_;
+  int errorCode_;
+  string message_;
+};
+
+/**
+ * Connect a producer Face and a consumer Face to one MiniForwarder, and use a SegmentFetcher to fetch an object of
+ * contentLength bytes which the producer serves in segments.
+ * @param contentLength The number of bytes in the object.
+ * @param segmentSize The number of content bytes in each segment.
+ * @param maxWindowSize The maximum window size of the SegmentFetcher.
+ * @param finalWindowSize Set this to the window size of the SegmentFetcher when the fetch completes.
+ * @return The number of seconds to fetch the object.
+ */
+static double
+benchmarkSegmentFetcherSeconds
+  (size_t contentLength, size_t segmentSize, double maxWindowSize, double& finalWindowSize)
+{
+  ptr_lib::shared_ptr<vector<uint8_t> > value(new vector<uint8_t>(contentLength));
+  for (size_t i = 0; i < contentLength; ++i)
+    (*value)[i] = (uint8_t)(i * 7 + i / 8000);
+  Blob content(value);
+
+  ptr_lib::shared_ptr<MiniForwarder> forwarder(new MiniForwarder());
+  ptr_lib::shared_ptr<LoopbackTransport::ConnectionInfo> connectionInfo
+    (new LoopbackTransport::ConnectionInfo(forwarder));
+
+  Name prefix("/ndn/ucla.edu/apps/segment-test");
+  Face producerFace(ptr_lib::make_shared<LoopbackTransport>(), connectionInfo);
+  SegmentProducer producer(content, segmentSize);
+  producerFace.registerPrefix
+    (prefix, bind(&SegmentProducer::onInterest, &producer, _1, _2, _3, _4),
+     bind(&SegmentProducer::onRegisterFailed, &producer, _1));
+  // Process the ndndId request and the selfreg interest.
+  while (forwarder->getFibSize() == 0)
+    producerFace.processEvents();
+
+  Face consumerFace(ptr_lib::make_shared<LoopbackTransport>(), connectionInfo);
+  FetchResult result;
+  SegmentFetcher fetcher
+    (consumerFace, Interest(prefix), bind(&FetchResult::onComplete, &result, _1),
+     bind(&FetchResult::onError, &result, _1, _2));
+  fetcher.setMaxWindowSize(maxWindowSize);
+
+  double start = getNowSeconds();
+  fetcher.start();
+  while (true) {
+    consumerFace.processEvents();
+    if (result.isDone_)
+      break;
+    producerFace.processEvents();
+  }
+  double duration = getNowSeconds() - start;
+
+  if (result.errorCode_ != 0)
+    throw runtime_error("benchmarkSegmentFetcherSeconds: SegmentFetcher error: " + result.message_);
+  if (result.content_.size() != contentLength ||
+      memcmp(result.content_.buf(), content.buf(), contentLength) != 0)
+    throw runtime_error("benchmarkSegmentFetcherSeconds: The fetched content is not the same");
+  if (forwarder->getPitSize() != 0)
+    throw runtime_error("benchmarkSegmentFetcherSeconds: The forwarder PIT is not empty");
+  finalWindowSize = fetcher.getWindowSize();
+
+  return duration;
+}
+
+/**
+ * Use a SegmentFetcher to fetch an object whose producer sets the finalBlockID of each segment to finalBlockID, and
+ * return the error code.  This checks that a finalBlockID which is too large is reported through onError instead of
+ * allocating the buffer or throwing from processEvents.
+ * @param contentLength The number of bytes which the producer has.
+ * @param finalBlockID The finalBlockID which the producer puts in each data packet.
+ * @param maxContentSize The maximum content size of the SegmentFetcher.
+ * @return The SegmentFetcher::ErrorCode, or 0 if the fetch completed.
+ */
+static int
+fetchWithFinalBlockID(size_t contentLength, const Name::Component& finalBlockID, size_t maxContentSize)
+{
+  ptr_lib::shared_ptr<MiniForwarder> forwarder(new MiniForwarder());
+  ptr_lib::shared_ptr<LoopbackTransport::ConnectionInfo> connectionInfo
+    (new LoopbackTransport::ConnectionInfo(forwarder));
+
+  Name prefix("/ndn/ucla.edu/apps/segment-test");
+  Face producerFace(ptr_lib::make_shared<LoopbackTransport>(), connectionInfo);
+  SegmentProducer producer(Blob(vector<uint8_t>(contentLength, 'x')), 8000);
+  producer.finalBlockID_ = finalBlockID;
+  producerFace.registerPrefix
+    (prefix, bind(&SegmentProducer::onInterest, &producer, _1, _2, _3, _4),
+     bind(&SegmentProducer::onRegisterFailed, &producer, _1));
+  while (forwarder->getFibSize() == 0)
+    producerFace.processEvents();
+
+  Face consumerFace(ptr_lib::make_shared<LoopbackTransport>(), connectionInfo);
+  FetchResult result;
+  SegmentFetcher fetcher
+    (consumerFace, Interest(prefix, 1000.0), bind(&FetchResult::onComplete, &result, _1),
+     bind(&FetchResult::onError, &result, _1, _2));
+  fetcher.setMaxContentSize(maxContentSize);
+  fetcher.start();
+  while (!result.isDone_) {
+    consumerFace.processEvents();
+    producerFace.processEvents();
+  }
+
+  if (result.errorCode_ == 0 && result.content_.size() != contentLength)
+    throw runtime_error("fetchWithFinalBlockID: The fetched content is not the same");
+  return result.errorCode_;
+}
+
+/**
+ * Check that SegmentFetcher reports CONTENT_TOO_LARGE for a bogus finalBlockID, including one where the buffer size
+ * would overflow, and for an object larger than the maximum content size.
+ */
+static void
+checkSegmentFetcherContentTooLarge()
+{
+  uint64_t bogusFinalSegments[] = { 1000000, (uint64_t)1 << 62, ~(uint64_t)0 };
+  for (size_t i = 0; i < sizeof(bogusFinalSegments) / sizeof(bogusFinalSegments[0]); ++i) {
+    if (fetchWithFinalBlockID
+        (20000, Name::Component::fromNumberWithMarker(bogusFinalSegments[i], 0x00), 1000000000) !=
+        SegmentFetcher::CONTENT_TOO_LARGE)
+      throw runtime_error("checkSegmentFetcherContentTooLarge: A bogus finalBlockID was not reported");
+  }
+
+  Name::Component finalBlockID = Name::Component::fromNumberWithMarker(2, 0x00);
+  if (fetchWithFinalBlockID(20000, finalBlockID, 1000000000) != 0)
+    throw runtime_error("checkSegmentFetcherContentTooLarge: The fetch did not complete");
+  if (fetchWithFinalBlockID(20000, finalBlockID, 10000) != SegmentFetcher::CONTENT_TOO_LARGE)
+    throw runtime_error("checkSegmentFetcherContentTooLarge: The maximum content size was not enforced");
+}
+
+int
+main(int argc, char** argv)
+{
+  try {
+    int nInterests = 100000;
+    for (size_t contentLength = 100; contentLength <= 8000; contentLength *= 80) {
+      for (int nConsumers = 1; nConsumers <= 4; nConsumers *= 2) {
+        int nProducerInterests;
+        double duration = benchmarkLoopbackSeconds(nConsumers, nInterests, 32, contentLength, nProducerInterests);
+        cout << "Loopback fetch: " << nConsumers << " consumers, " << contentLength << " byte content, "
+             << nProducerInterests << " interests to the producer, Duration sec, data Hz, MB/s: " << duration << ", "
+             << (nConsumers * nInterests / duration) << ", "
+             << ((double)nConsumers * nInterests * contentLength / duration / 1e6) << endl;
+      }
+    }
+
+    for (int nConsumers = 1; nConsumers <= 4; nConsumers *= 2) {
+      int nWaits;
+      double duration = benchmarkLoopbackEventLoopSeconds(nConsumers, nInterests, 32, 8000, nWaits);
+      cout << "Loopback fetch with poll and processEvents(timeout): " << nConsumers << " consumers, 8000 byte content, "
+           << nWaits << " waits, Duration sec, data Hz: " << duration << ", " << (nConsumers * nInterests / duration)
+           << endl;
+    }
+
+    checkSegmentFetcherContentTooLarge();
+    cout << "SegmentFetcher: A bogus finalBlockID is reported as CONTENT_TOO_LARGE" << endl;
+
+    size_t objectLength = 100 * 1000 * 1000;
+    size_t segmentSize = 8000;
+    for (double maxWindowSize = 4; maxWindowSize <= 256; maxWindowSize *= 8) {
+      double finalWindowSize;
+      double duration = benchmarkSegmentFetcherSeconds(objectLength, segmentSize, maxWindowSize, finalWindowSize);
+      cout << "SegmentFetcher: " << objectLength << " byte object, " << segmentSize << " byte segments, max window "
+           << maxWindowSize << ", final window " << finalWindowSize << ", Duration sec, MB/s: " << duration << ", "
+           << (objectLength / duration / 1e6) << endl;
+    }
+  } catch (std::exception& e) {
+    cout << "exception: " << e.what() << endl;
+  }
+  return 0;
+}
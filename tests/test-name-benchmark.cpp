@@ -0,0 +1,319 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <time.h>
+#include <sys/time.h>
+#include <stdexcept>
+#include <string.h>
+#include <ndn-cpp/name.hpp>
+#include "../src/c/name.h"
+
+using namespace std;
+using namespace ndn;
+
+static double
+getNowSeconds()
+{
+  struct timeval t;
+  gettimeofday(&t, 0);
+  return t.tv_sec + t.tv_usec / 1000000.0;
+}
+
+static const char *URI = "/ndn/ucla.edu/apps/name-benchmark/session/%FD%05%0A%1B%2C%3D/%00%01";
+
+/**
+ * Loop to parse the URI into a new Name.
+ * @param nIterations The number of names to construct.
+ * @return The number of seconds for all iterations.
+ */
+static double
+benchmarkConstructFromUriSeconds(int nIterations)
+{
+  size_t count = 0;
+  double start = getNowSeconds();
+  for (int i = 0; i < nIterations; ++i) {
+    Name name(URI);
+    count += name.size();
+  }
+  double finish = getNowSeconds();
+
+  if (count != (size_t)nIterations * 7)
+    throw runtime_error("benchmarkConstructFromUriSeconds: The name does not have 7 components");
+  return finish - start;
+}
+
+/**
+ * Loop to encode a name as a URI, escaping the components which are not printable.
+ * @param nIterations The number of URIs to make.
+ * @return The number of seconds for all iterations.
+ */
+static double
+benchmarkToUriSeconds(int nIterations)
+{
+  Name name(URI);
+
+  size_t count = 0;
+  double start = getNowSeconds();
+  for (int i = 0; i < nIterations; ++i)
+    count += name.toUri().size();
+  double finish = getNowSeconds();
+
+  if (name.toUri() != URI)
+    throw runtime_error("benchmarkToUriSeconds: toUri did not return the URI which was parsed");
+  if (count != (size_t)nIterations * ::strlen(URI))
+    throw runtime_error("benchmarkToUriSeconds: The URI has the wrong length");
+  return finish - start;
+}
+
+/**
+ * Loop to set a new Name from the components in a C ndn_Name struct, as when decoding.
+ * @param nIterations The number of names to construct.
+ * @return The number of seconds for all iterations.
+ */
+static double
+benchmarkConstructFromStructSeconds(int nIterations)
+{
+  Name uriName(URI);
+  struct ndn_NameComponent nameComponents[100];
+  struct ndn_Name nameStruct;
+  ndn_Name_initialize(&nameStruct, nameComponents, sizeof(nameComponents) / sizeof(nameComponents[0]));
+  uriName.get(nameStruct);
+
+  size_t count = 0;
+  double start = getNowSeconds();
+  for (int i = 0; i < nIterations; ++i) {
+    Name name;
+    name.set(nameStruct);
+    count += name.size();
+  }
+  double finish = getNowSeconds();
+
+  if (count != (size_t)nIterations * uriName.size())
+    throw runtime_error("benchmarkConstructFromStructSeconds: The name does not have all the components");
+  return finish - start;
+}
+
+/**
+ * Loop to copy a prefix and append a component and a segment number, as when making the name of the next segment.
+ * @param nIterations The number of names to make.
+ * @return The number of seconds for all iterations.
+ */
+static double
+benchmarkAppendSeconds(int nIterations)
+{
+  Name prefix("/ndn/ucla.edu/apps/name-benchmark");
+
+  size_t count = 0;
+  double start = getNowSeconds();
+  for (int i = 0; i < nIterations; ++i) {
+    Name name(prefix);
+    name.append((const uint8_t *)"session", 7).appendSegment(i);
+    count += name.size();
+  }
+  double finish = getNowSeconds();
+
+  if (count != (size_t)nIterations * 6)
+    throw runtime_error("benchmarkAppendSeconds: The name does not have 6 components");
+  return finish - start;
+}
+
+/**
+ * Loop to get sub names of a name.
+ * @param nIterations The number of times to call getSubName and getPrefix.
+ * @return The number of seconds for all iterations.
+ */
+static double
+benchmarkGetSubNameSeconds(int nIterations)
+{
+  Name name(URI);
+
+  size_t count = 0;
+  double start = getNowSeconds();
+  for (int i = 0; i < nIterations; ++i) {
+    count += name.getSubName(1, 4).size();
+    count += name.getPrefix(-1).size();
+  }
+  double finish = getNowSeconds();
+
+  if (count != (size_t)nIterations * 10)
+    throw runtime_error("benchmarkGetSubNameSeconds: The sub names have the wrong size");
+  return finish - start;
+}
+
+/**
+ * Loop to match prefixes of a name, and to compare and check equality of names which differ only in the last component.
+ * @param nIterations The number of times to call match, equals and compare.
+ * @return The number of seconds for all iterations.
+ */
+static double
+benchmarkMatchSeconds(int nIterations)
+{
+  Name name(URI);
+  Name prefix(name.getPrefix(4));
+  Name otherPrefix("/ndn/ucla.edu/apps/other-benchmark");
+  Name otherName(name.getPrefix(-1));
+  otherName.appendSegment(2);
+
+  int nMatches = 0;
+  int nDifferent = 0;
+  double start = getNowSeconds();
+  for (int i = 0; i < nIterations; ++i) {
+    if (prefix.match(name))
+      ++nMatches;
+    if (otherPrefix.match(name))
+      ++nMatches;
+    if (!name.equals(otherName))
+      ++nDifferent;
+    if (name.compare(otherName) < 0)
+      ++nDifferent;
+  }
+  double finish = getNowSeconds();
+
+  if (nMatches != nIterations || nDifferent != 2 * nIterations)
+    throw runtime_error("benchmarkMatchSeconds: Wrong result from match, equals or compare");
+  return finish - start;
+}
+
+/**
+ * Make a corpus of names like those of an application's data packets: /ndn/<site>/apps/<app>/<session>/<segment>
+ * where the first four components come from a small set.  Each name is parsed from a URI so that it has its own byte
+ * array, as when decoded from a packet.
+ * @param nNames The number of names.
+ * @param names Set this to the names.
+ * @param prefixes Set this to the 10 x 20 /ndn/<site>/apps/<app> prefixes.  Name number i has the prefix
+ * number (i % 10) * 20 + (i % 20).
+ */
+static void
+makeCorpus(int nNames, vector<Name>& names, vector<Name>& prefixes)
+{
+  for (int site = 0; site < 10; ++site) {
+    for (int app = 0; app < 20; ++app) {
+      ostringstream uri;
+      uri << "/ndn/site" << site << ".edu/apps/app" << app;
+      prefixes.push_back(Name(uri.str()));
+    }
+  }
+
+  for (int i = 0; i < nNames; ++i) {
+    ostringstream uri;
+    uri << "/ndn/site" << (i % 10) << ".edu/apps/app" << (i % 20) << "/session" << (i % 50) << "/%00%" << hex
+        << (i % 16) << (i % 7);
+    names.push_back(Name(uri.str()));
+  }
+}
+
+/**
+ * Loop over a corpus of names to find the matching registered prefix of each name, and to check the name for equality
+ * with the next name and with a name parsed from the same URI.
+ * @param nIterations The number of names to check.
+ * @param nMatchCalls Set this to the number of calls to match and equals.
+ * @return The number of seconds for all iterations.
+ */
+static double
+benchmarkMatchCorpusSeconds(int nIterations, int& nMatchCalls)
+{
+  vector<Name> names;
+  vector<Name> prefixes;
+  makeCorpus(1000, names, prefixes);
+  vector<Name> sameNames;
+  for (size_t i = 0; i < names.size(); ++i)
+    sameNames.push_back(Name(names[i].toUri()));
+
+  int nMatches = 0;
+  int nEqual = 0;
+  double start = getNowSeconds();
+  for (int i = 0; i < nIterations; ++i) {
+    const Name& name = names[i % names.size()];
+    for (size_t j = 0; j < prefixes.size(); ++j) {
+      if (prefixes[j].match(name))
+        ++nMatches;
+    }
+    if (name.equals(names[(i + 1) % names.size()]))
+      ++nEqual;
+    if (name.equals(sameNames[i % names.size()]))
+      ++nEqual;
+  }
+  double finish = getNowSeconds();
+
+  if (nMatches != nIterations || nEqual != nIterations)
+    throw runtime_error("benchmarkMatchCorpusSeconds: Wrong result from match or equals");
+  nMatchCalls = nIterations * (prefixes.size() + 2);
+  return finish - start;
+}
+
+/**
+ * Loop to get the hash code of each component of a name and of each prefix, and to check that a copy of the name and
+ * a name parsed from the same URI have the same hash code.
+ * @param nIterations The number of times to get the hash codes.
+ * @return The number of seconds for all iterations.
+ */
+static double
+benchmarkHashSeconds(int nIterations)
+{
+  Name name(URI);
+  Name otherName(URI);
+
+  size_t hash = 0;
+  int nEqual = 0;
+  double start = getNowSeconds();
+  for (int i = 0; i < nIterations; ++i) {
+    for (size_t j = 0; j < name.size(); ++j)
+      hash ^= name.get(j).hash();
+    for (size_t j = 0; j <= name.size(); ++j)
+      hash ^= name.getPrefixHash(j);
+    if (Name(name).hash() == otherName.hash())
+      ++nEqual;
+  }
+  double finish = getNowSeconds();
+
+  if (nEqual != nIterations || name.getPrefix(4).hash() != name.getPrefixHash(4) ||
+      name.getSubName(1).hash() != Name(name.getSubName(1).toUri()).hash())
+    throw runtime_error("benchmarkHashSeconds: Equal names have different hash codes");
+  if (hash == 1)
+    // Use the hash so that the compiler doesn't optimize it out.
+    cout << "hash: " << hash << endl;
+  return finish - start;
+}
+
+int
+main(int argc, char** argv)
+{
+  try {
+    int nIterations = 1000000;
+    double duration = benchmarkConstructFromUriSeconds(nIterations);
+    cout << "Name construct from URI: Duration sec, Hz: " << duration << ", " << (nIterations / duration) << endl;
+
+    duration = benchmarkToUriSeconds(nIterations);
+    cout << "Name toUri: Duration sec, Hz: " << duration << ", " << (nIterations / duration) << endl;
+
+    duration = benchmarkConstructFromStructSeconds(nIterations);
+    cout << "Name set from ndn_Name: Duration sec, Hz: " << duration << ", " << (nIterations / duration) << endl;
+
+    duration = benchmarkAppendSeconds(nIterations);
+    cout << "Name copy and append: Duration sec, Hz: " << duration << ", " << (nIterations / duration) << endl;
+
+    duration = benchmarkGetSubNameSeconds(nIterations);
+    cout << "Name getSubName and getPrefix: Duration sec, Hz: " << duration << ", " << (nIterations / duration) << endl;
+
+    duration = benchmarkMatchSeconds(nIterations);
+    cout << "Name match, equals and compare: Duration sec, Hz: " << duration << ", " << (nIterations / duration) << endl;
+
+    int nMatchCalls;
+    duration = benchmarkMatchCorpusSeconds(nIterations / 10, nMatchCalls);
+    cout << "Name match and equals over a corpus: Duration sec, calls Hz: " << duration << ", "
+         << (nMatchCalls / duration) << endl;
+
+    duration = benchmarkHashSeconds(nIterations);
+    cout << "Name hash of components and prefixes: Duration sec, Hz: " << duration << ", " << (nIterations / duration) << endl;
+  } catch (std::exception& e) {
+    cout << "exception: " << e.what() << endl;
+  }
+  return 0;
+}
@@ -0,0 +1,909 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <time.h>
+#include <sys/time.h>
+#include <stdexcept>
+#include <algorithm>
+#include <pthread.h>
+#include <ndn-cpp/sha256-with-rsa-signature.hpp>
+#include <ndn-cpp/util/thread-pool-executor.hpp>
+#include <ndn-cpp/node.hpp>
+#include "../src/c/util/crypto.h"
+
+using namespace std;
+using namespace ndn;
+using namespace ndn::func_lib;
+#if NDN_CPP_HAVE_STD_FUNCTION
+// In the std library, the placeholders are in a different namespace than boost.
+using namespace func_lib::placeholders;
+#endif
+
+static double
+getNowSeconds()
+{
+  struct timeval t;
+  gettimeofday(&t, 0);
+  return t.tv_sec + t.tv_usec / 1000000.0;
+}
+
+/**
+ * A DummyTransport counts and discards everything sent and never receives anything, so that we can call
+ * Node::onReceivedElement directly without a connection to an NDN hub.
+ */
+class DummyTransport : public Transport {
+public:
+  DummyTransport()
+  : sendCount_(0), isConnected_(false)
+  {
+  }
+
+  virtual void
+  connect(const Transport::ConnectionInfo& connectionInfo, ElementListener& elementListener)
+  {
+    isConnected_ = true;
+  }
+
+  virtual void
+  send(const uint8_t *data, size_t dataLength)
+  {
+    ++sendCount_;
+  }
+
+  virtual void
+  processEvents()
+  {
+  }
+
+  virtual bool
+  getIsConnected() { return isConnected_; }
+
+  int sendCount_;
+
+private:
+  bool isConnected_;
+};
+
+class Counter
+{
+public:
+  Counter() {
+    callbackCount_ = 0;
+    callLaterCount_ = 0;
+    interestCount_ = 0;
+  }
+
+  void onData(const ptr_lib::shared_ptr<const Interest>& interest, const ptr_lib::shared_ptr<Data>& data)
+  {
+    ++callbackCount_;
+    lastData_ = data;
+  }
+
+  void onCallLater()
+  {
+    ++callLaterCount_;
+  }
+
+  void onInterest
+    (const ptr_lib::shared_ptr<const Name>& prefix, const ptr_lib::shared_ptr<const Interest>& interest, 
+     Transport& transport, uint64_t registeredPrefixId)
+  {
+    ++interestCount_;
+    lastPrefix_ = prefix;
+  }
+
+  void onRegisterFailed(const ptr_lib::shared_ptr<const Name>& prefix)
+  {
+    throw runtime_error("Register failed for prefix " + prefix->toUri());
+  }
+
+  int callbackCount_;
+  int callLaterCount_;
+  int interestCount_;
+  ptr_lib::shared_ptr<const Name> lastPrefix_;
+  ptr_lib::shared_ptr<Data> lastData_;
+};
+
+/**
+ * A Producer answers each interest with a new data packet of the same name, and optionally puts it in the node's
+ * producer store so that the node answers the next interest for the name without calling onInterest.
+ */
+class Producer
+{
+public:
+  Producer(Node& node, bool usePutData)
+  : node_(node), usePutData_(usePutData), content_(1000, 'x'), interestCount_(0)
+  {
+  }
+
+  void onInterest
+    (const ptr_lib::shared_ptr<const Name>& prefix, const ptr_lib::shared_ptr<const Interest>& interest,
+     Transport& transport, uint64_t registeredPrefixId)
+  {
+    ++interestCount_;
+    Data data(interest->getName());
+    data.getMetaInfo().setFreshnessSeconds(1000);
+    data.setContent(content_);
+    if (usePutData_)
+      transport.send(node_.putData(data, *WireFormat::getDefaultWireFormat()));
+    else
+      transport.send(data.wireEncode());
+  }
+
+  void onRegisterFailed(const ptr_lib::shared_ptr<const Name>& prefix)
+  {
+    throw runtime_error("Register failed for prefix " + prefix->toUri());
+  }
+
+  Node& node_;
+  bool usePutData_;
+  vector<uint8_t> content_;
+  int interestCount_;
+};
+
+/**
+ * Make the interest name for the pending interest number i.
+ * @param i The pending interest number.
+ * @return The name /ndn/ucla.edu/apps/pit-test/<i> .
+ */
+static Name
+makeInterestName(int i)
+{
+  ostringstream number;
+  number << i;
+  return Name("/ndn/ucla.edu/apps/pit-test").append((const uint8_t *)number.str().c_str(), number.str().size());
+}
+
+/**
+ * Fill the pending interest table with nPendingInterests interests, then time nIterations calls to
+ * onReceivedElement where each data packet satisfies one pending interest.  After each call, express the satisfied
+ * interest again so that the size of the pending interest table stays the same.
+ * @param nPendingInterests The number of interests in the pending interest table.
+ * @param nIterations The number of incoming data packets.
+ * @return The number of seconds for all calls to onReceivedElement.
+ */
+static double
+benchmarkPendingInterestTableSeconds(int nPendingInterests, int nIterations)
+{
+  Node node(ptr_lib::make_shared<DummyTransport>(), ptr_lib::make_shared<Transport::ConnectionInfo>());
+  Counter counter;
+  WireFormat& wireFormat = *WireFormat::getDefaultWireFormat();
+
+  for (int i = 0; i < nPendingInterests; ++i)
+    node.expressInterest(Interest(makeInterestName(i)), bind(&Counter::onData, &counter, _1, _2), OnTimeout(), wireFormat);
+
+  // Encode the incoming data packets ahead of time, spread over the pending interests.
+  int nEncodings = nPendingInterests < 1000 ? nPendingInterests : 1000;
+  vector<int> interestNumbers;
+  vector<Blob> encodings;
+  for (int i = 0; i < nEncodings; ++i) {
+    int interestNumber = i * (nPendingInterests / nEncodings);
+    Data data(Name(makeInterestName(interestNumber)).appendSegment(0));
+    interestNumbers.push_back(interestNumber);
+    encodings.push_back(data.wireEncode());
+  }
+
+  double duration = 0;
+  for (int i = 0; i < nIterations; ++i) {
+    size_t iEncoding = i % encodings.size();
+    double start = getNowSeconds();
+    node.onReceivedElement(encodings[iEncoding].buf(), encodings[iEncoding].size());
+    duration += getNowSeconds() - start;
+
+    node.expressInterest
+      (Interest(makeInterestName(interestNumbers[iEncoding])), bind(&Counter::onData, &counter, _1, _2), OnTimeout(),
+       wireFormat);
+  }
+
+  if (counter.callbackCount_ != nIterations)
+    throw runtime_error("benchmarkPendingInterestTableSeconds: Not every data packet satisfied a pending interest");
+
+  return duration;
+}
+
+/**
+ * Time nIterations rounds where nCallbacks applications express the same interest and one data packet satisfies all
+ * of them.  Check that the interest is sent only once in each round and that every callback is called.
+ * @param nCallbacks The number of identical interests expressed in each round.
+ * @param nIterations The number of rounds.
+ * @return The number of seconds for all rounds.
+ */
+static double
+benchmarkAggregateInterestsSeconds(int nCallbacks, int nIterations)
+{
+  ptr_lib::shared_ptr<DummyTransport> transport(new DummyTransport());
+  Node node(transport, ptr_lib::make_shared<Transport::ConnectionInfo>());
+  Counter counter;
+  WireFormat& wireFormat = *WireFormat::getDefaultWireFormat();
+
+  Interest interest(makeInterestName(0));
+  Data data(Name(interest.getName()).appendSegment(0));
+  Blob encoding = data.wireEncode();
+
+  // Allocate a large buffer before timing so that the timing doesn't include the memory allocator consolidating the
+  // memory freed by the previous benchmark.
+  Blob(ptr_lib::make_shared<vector<uint8_t> >(65536));
+
+  double start = getNowSeconds();
+  for (int i = 0; i < nIterations; ++i) {
+    for (int j = 0; j < nCallbacks; ++j)
+      node.expressInterest(interest, bind(&Counter::onData, &counter, _1, _2), OnTimeout(), wireFormat);
+    node.onReceivedElement(encoding.buf(), encoding.size());
+  }
+  double duration = getNowSeconds() - start;
+
+  if (transport->sendCount_ != nIterations)
+    throw runtime_error("benchmarkAggregateInterestsSeconds: Identical interests were not sent once");
+  if (counter.callbackCount_ != nCallbacks * nIterations)
+    throw runtime_error("benchmarkAggregateInterestsSeconds: The data did not satisfy every pending interest");
+
+  // Check that the PIT is empty.
+  node.onReceivedElement(encoding.buf(), encoding.size());
+  if (counter.callbackCount_ != nCallbacks * nIterations)
+    throw runtime_error("benchmarkAggregateInterestsSeconds: A satisfied pending interest was not removed");
+
+  return duration;
+}
+
+/**
+ * Express an interest for the name of data and call onReceivedElement with data, so that the node caches it.
+ */
+static void
+fetchData(Node& node, Counter& counter, const Data& data)
+{
+  node.expressInterest
+    (Interest(data.getName()), bind(&Counter::onData, &counter, _1, _2), OnTimeout(),
+     *WireFormat::getDefaultWireFormat());
+  Blob encoding = data.wireEncode();
+  node.onReceivedElement(encoding.buf(), encoding.size());
+}
+
+/**
+ * Express the interest and call processEvents, and return the name of the data from the content store.
+ * @return The data name, or an empty name if the interest was sent instead.
+ */
+static Name
+expressToContentStore(Node& node, Counter& counter, const Interest& interest)
+{
+  counter.lastData_.reset();
+  node.expressInterest(interest, bind(&Counter::onData, &counter, _1, _2), OnTimeout(), *WireFormat::getDefaultWireFormat());
+  node.processEvents();
+  if (!counter.lastData_)
+    return Name();
+  return counter.lastData_->getName();
+}
+
+/**
+ * Check that the content store answers interests by the selectors, childSelector, freshness and answerOriginKind,
+ * and evicts the least recently used data to stay in the budget.
+ */
+static void
+checkContentStore()
+{
+  ptr_lib::shared_ptr<DummyTransport> transport(new DummyTransport());
+  Node node(transport, ptr_lib::make_shared<Transport::ConnectionInfo>());
+  Counter counter;
+  node.setContentStoreMaxBytes(1000000);
+
+  Name prefix("/ndn/ucla.edu/apps/cs-test");
+  for (int version = 1; version <= 3; ++version) {
+    Data data(Name(prefix).appendVersion(version));
+    data.getMetaInfo().setFreshnessSeconds(1000);
+    fetchData(node, counter, data);
+  }
+  int sendCount = transport->sendCount_;
+
+  Interest interest(prefix);
+  if (expressToContentStore(node, counter, interest) != Name(prefix).appendVersion(1))
+    throw runtime_error("checkContentStore: The default interest did not get the leftmost child");
+  interest.setChildSelector(ndn_Interest_CHILD_SELECTOR_RIGHT);
+  if (expressToContentStore(node, counter, interest) != Name(prefix).appendVersion(3))
+    throw runtime_error("checkContentStore: The childSelector did not get the rightmost child");
+  interest.setMinSuffixComponents(3);
+  interest.setChildSelector(-1);
+  if (expressToContentStore(node, counter, interest).size() != 0)
+    throw runtime_error("checkContentStore: The interest minSuffixComponents was not checked");
+  if (transport->sendCount_ != sendCount + 1)
+    throw runtime_error("checkContentStore: An interest answered from the content store was sent");
+
+  // Make room for only two of the three versions.  Using version 1 makes version 2 the least recently used.
+  size_t encodingSize = Data(Name(prefix).appendVersion(1)).wireEncode().size();
+  if (expressToContentStore(node, counter, Interest(Name(prefix).appendVersion(1))).size() == 0)
+    throw runtime_error("checkContentStore: Version 1 is not in the content store");
+  node.setContentStoreMaxBytes(2 * encodingSize + encodingSize / 2);
+  if (expressToContentStore(node, counter, Interest(Name(prefix).appendVersion(2))).size() != 0)
+    throw runtime_error("checkContentStore: The least recently used data was not evicted");
+  if (expressToContentStore(node, counter, Interest(Name(prefix).appendVersion(1))).size() == 0 ||
+      expressToContentStore(node, counter, Interest(Name(prefix).appendVersion(3))).size() == 0)
+    throw runtime_error("checkContentStore: Recently used data was evicted");
+
+  interest = Interest(Name(prefix).appendVersion(1));
+  interest.setAnswerOriginKind(ndn_Interest_ANSWER_NO_CONTENT_STORE);
+  if (expressToContentStore(node, counter, interest).size() != 0)
+    throw runtime_error("checkContentStore: The interest answerOriginKind was not checked");
+
+  Data staleData(Name(prefix).append("stale"));
+  staleData.getMetaInfo().setFreshnessSeconds(0);
+  fetchData(node, counter, staleData);
+  interest = Interest(staleData.getName());
+  if (expressToContentStore(node, counter, interest).size() != 0)
+    throw runtime_error("checkContentStore: Stale data was returned");
+  interest.setAnswerOriginKind(ndn_Interest_ANSWER_CONTENT_STORE | ndn_Interest_ANSWER_STALE);
+  if (expressToContentStore(node, counter, interest) != staleData.getName())
+    throw runtime_error("checkContentStore: Stale data was not returned for answerOriginKind ANSWER_STALE");
+}
+
+/**
+ * Cache nCached data packets, then time nIterations rounds which express an interest for one of them and call
+ * processEvents to receive the data from the content store.
+ * @param nCached The number of data packets in the content store.
+ * @param nIterations The number of interests.
+ * @return The number of seconds for all rounds.
+ */
+static double
+benchmarkContentStoreSeconds(int nCached, int nIterations)
+{
+  ptr_lib::shared_ptr<DummyTransport> transport(new DummyTransport());
+  Node node(transport, ptr_lib::make_shared<Transport::ConnectionInfo>());
+  Counter counter;
+  WireFormat& wireFormat = *WireFormat::getDefaultWireFormat();
+  node.setContentStoreMaxBytes(1000000000);
+
+  vector<Interest> interests;
+  for (int i = 0; i < nCached; ++i) {
+    Data data(Name(makeInterestName(i)).appendSegment(0));
+    data.getMetaInfo().setFreshnessSeconds(1000);
+    fetchData(node, counter, data);
+    interests.push_back(Interest(makeInterestName(i)));
+  }
+  int sendCount = transport->sendCount_;
+  int callbackCount = counter.callbackCount_;
+
+  double start = getNowSeconds();
+  for (int i = 0; i < nIterations; ++i) {
+    node.expressInterest
+      (interests[(i * 7919) % nCached], bind(&Counter::onData, &counter, _1, _2), OnTimeout(), wireFormat);
+    node.processEvents();
+  }
+  double duration = getNowSeconds() - start;
+
+  if (transport->sendCount_ != sendCount || counter.callbackCount_ != callbackCount + nIterations)
+    throw runtime_error("benchmarkContentStoreSeconds: An interest was not answered from the content store");
+
+  return duration;
+}
+
+/**
+ * Register a prefix with a Producer, then time nIterations calls to onReceivedElement with interests for nNames
+ * names.  If usePutData, the producer puts each data packet in the producer store, so that only the first interest for
+ * each name reaches the producer.
+ * @param usePutData If true, use the producer store.
+ * @param nNames The number of different interest names.
+ * @param nIterations The number of incoming interests.
+ * @param hitRate Set this to the producer store hit rate.
+ * @return The number of seconds for all calls to onReceivedElement.
+ */
+static double
+benchmarkProducerStoreSeconds(bool usePutData, int nNames, int nIterations, double& hitRate)
+{
+  ptr_lib::shared_ptr<DummyTransport> transport(new DummyTransport());
+  Node node(transport, ptr_lib::make_shared<Transport::ConnectionInfo>());
+  Producer producer(node, usePutData);
+  WireFormat& wireFormat = *WireFormat::getDefaultWireFormat();
+
+  // The first registerPrefix fetches the ndndId, so answer it with a data packet which has a publisher public key digest.
+  node.registerPrefix
+    (Name("/ndn/ucla.edu/apps/producer-test"), bind(&Producer::onInterest, &producer, _1, _2, _3, _4),
+     bind(&Producer::onRegisterFailed, &producer, _1), ForwardingFlags(), wireFormat);
+  Data ndndIdData(Name("/%C1.M.S.localhost/%C1.M.SRV/ndnd/KEY"));
+  uint8_t ndndId[32] = { 1 };
+  dynamic_cast<Sha256WithRsaSignature*>(ndndIdData.getSignature())->getPublisherPublicKeyDigest().setPublisherPublicKeyDigest
+    (Blob(ndndId, sizeof(ndndId)));
+  Blob ndndIdEncoding = ndndIdData.wireEncode();
+  node.onReceivedElement(ndndIdEncoding.buf(), ndndIdEncoding.size());
+
+  vector<Blob> encodings;
+  for (int i = 0; i < nNames; ++i)
+    encodings.push_back(Interest(Name("/ndn/ucla.edu/apps/producer-test").appendSegment(i)).wireEncode());
+  int sendCount = transport->sendCount_;
+
+  double start = getNowSeconds();
+  for (int i = 0; i < nIterations; ++i)
+    node.onReceivedElement(encodings[i % nNames].buf(), encodings[i % nNames].size());
+  double duration = getNowSeconds() - start;
+
+  if (transport->sendCount_ != sendCount + nIterations)
+    throw runtime_error("benchmarkProducerStoreSeconds: Not every interest was answered");
+  if (producer.interestCount_ != (usePutData ? nNames : nIterations))
+    throw runtime_error("benchmarkProducerStoreSeconds: The producer store did not answer the repeated interests");
+  uint64_t nLookups = node.getProducerStoreHitCount() + node.getProducerStoreMissCount();
+  hitRate = nLookups > 0 ? (double)node.getProducerStoreHitCount() / nLookups : 0;
+
+  return duration;
+}
+
+/**
+ * An ExpressingThread expresses interests on a Node in the thread-safe mode from its own thread, and removes every
+ * other one, while the main thread calls processEvents.
+ */
+class ExpressingThread
+{
+public:
+  ExpressingThread(Node& node, Counter& counter, const vector<Name>& names, int& nFinishedThreads)
+  : node_(node), counter_(counter), names_(names), nFinishedThreads_(nFinishedThreads)
+  {
+  }
+
+  static void*
+  run(void *self)
+  {
+    ExpressingThread& thread = *(ExpressingThread*)self;
+    try {
+      WireFormat& wireFormat = *WireFormat::getDefaultWireFormat();
+      for (size_t i = 0; i < thread.names_.size(); ++i) {
+        uint64_t pendingInterestId = thread.node_.expressInterest
+          (Interest(thread.names_[i], 1000000.0), bind(&Counter::onData, &thread.counter_, _1, _2), OnTimeout(),
+           wireFormat);
+        thread.pendingInterestIds_.push_back(pendingInterestId);
+        if (i % 2 == 1)
+          thread.node_.removePendingInterest(pendingInterestId);
+      }
+    } catch (std::exception& e) {
+      thread.error_ = e.what();
+    }
+    __atomic_add_fetch(&thread.nFinishedThreads_, 1, __ATOMIC_SEQ_CST);
+    return 0;
+  }
+
+  Node& node_;
+  Counter& counter_;
+  const vector<Name>& names_;
+  int& nFinishedThreads_;
+  vector<uint64_t> pendingInterestIds_;
+  string error_;
+};
+
+/**
+ * Enable the thread-safe mode and time nThreads threads which together express nInterests interests with different
+ * names and remove every other one, while the main thread calls processEvents until all the requests are done.  Then
+ * check that every interest was sent with a unique pendingInterestId, and that incoming data satisfies exactly the
+ * interests which were not removed.
+ * @param nThreads The number of threads calling expressInterest and removePendingInterest.
+ * @param nInterests The total number of interests.
+ * @return The number of seconds until all the requests are done.
+ */
+static double
+benchmarkThreadSafeExpressInterestSeconds(int nThreads, int nInterests)
+{
+  ptr_lib::shared_ptr<DummyTransport> transport(new DummyTransport());
+  Node node(transport, ptr_lib::make_shared<Transport::ConnectionInfo>());
+  node.enableThreadSafeMode();
+  Counter counter;
+
+  vector<vector<Name> > names(nThreads);
+  for (int i = 0; i < nInterests; ++i)
+    names[i % nThreads].push_back(makeInterestName(i));
+  int nFinishedThreads = 0;
+  vector<ptr_lib::shared_ptr<ExpressingThread> > threads;
+  for (int i = 0; i < nThreads; ++i)
+    threads.push_back(ptr_lib::shared_ptr<ExpressingThread>
+      (new ExpressingThread(node, counter, names[i], nFinishedThreads)));
+  vector<pthread_t> threadIds(nThreads);
+
+  double start = getNowSeconds();
+  for (int i = 0; i < nThreads; ++i) {
+    if (pthread_create(&threadIds[i], 0, &ExpressingThread::run, threads[i].get()) != 0)
+      throw runtime_error("benchmarkThreadSafeExpressInterestSeconds: Error in pthread_create");
+  }
+  while (__atomic_load_n(&nFinishedThreads, __ATOMIC_SEQ_CST) < nThreads)
+    node.processEvents(10.0);
+  // Process the requests made after the last call.
+  node.processEvents();
+  double duration = getNowSeconds() - start;
+
+  vector<uint64_t> pendingInterestIds;
+  for (int i = 0; i < nThreads; ++i) {
+    pthread_join(threadIds[i], 0);
+    if (threads[i]->error_.size() > 0)
+      throw runtime_error("benchmarkThreadSafeExpressInterestSeconds: Error in thread: " + threads[i]->error_);
+    pendingInterestIds.insert
+      (pendingInterestIds.end(), threads[i]->pendingInterestIds_.begin(), threads[i]->pendingInterestIds_.end());
+  }
+
+  if (transport->sendCount_ != nInterests)
+    throw runtime_error("benchmarkThreadSafeExpressInterestSeconds: Not every interest was sent");
+  sort(pendingInterestIds.begin(), pendingInterestIds.end());
+  if (unique(pendingInterestIds.begin(), pendingInterestIds.end()) != pendingInterestIds.end())
+    throw runtime_error("benchmarkThreadSafeExpressInterestSeconds: Two interests got the same pendingInterestId");
+
+  int nExpected = 0;
+  for (int i = 0; i < nThreads; ++i) {
+    nExpected += names[i].size() / 2;
+    for (size_t j = 0; j < names[i].size(); ++j) {
+      Blob encoding = Data(names[i][j]).wireEncode();
+      node.onReceivedElement(encoding.buf(), encoding.size());
+    }
+  }
+  if (counter.callbackCount_ != nExpected)
+    throw runtime_error("benchmarkThreadSafeExpressInterestSeconds: The data did not satisfy exactly the interests which were not removed");
+
+  return duration;
+}
+
+/**
+ * A SlowProducer answers each interest after doing work like signing, and checks that the interests arrive in the
+ * order of their segment numbers.
+ */
+class SlowProducer
+{
+public:
+  SlowProducer(int nWorkIterations, int& nAnswered)
+  : nWorkIterations_(nWorkIterations), nAnswered_(nAnswered), work_(1000, 'x'), lastSegment_(0), isOrdered_(true)
+  {
+  }
+
+  void onInterest
+    (const ptr_lib::shared_ptr<const Name>& prefix, const ptr_lib::shared_ptr<const Interest>& interest,
+     Transport& transport, uint64_t registeredPrefixId)
+  {
+    uint8_t digest[SHA256_DIGEST_LENGTH];
+    for (int i = 0; i < nWorkIterations_; ++i)
+      ndn_digestSha256(&work_[0], work_.size(), digest);
+    work_[0] = digest[0];
+
+    const Name& name = interest->getName();
+    uint64_t segment = name.get(name.size() - 1).toSegment();
+    if (segment != lastSegment_ + 1)
+      isOrdered_ = false;
+    lastSegment_ = segment;
+
+    transport.send(Data(interest->getName()).wireEncode());
+    __atomic_add_fetch(&nAnswered_, 1, __ATOMIC_SEQ_CST);
+  }
+
+  void onRegisterFailed(const ptr_lib::shared_ptr<const Name>& prefix)
+  {
+    throw runtime_error("Register failed for prefix " + prefix->toUri());
+  }
+
+  int nWorkIterations_;
+  int& nAnswered_;
+  vector<uint8_t> work_;
+  uint64_t lastSegment_;
+  bool isOrdered_;
+};
+
+/**
+ * Register two prefixes whose OnInterest callbacks each hash 100 KB, then time nInterests calls to onReceivedElement
+ * with interests alternating between the prefixes, and the time until all of them are answered.  If nThreads is not
+ * 0, call the callbacks with a ThreadPoolExecutor which preserves the order for each prefix.
+ * @param nThreads The number of executor threads, or 0 to call the callbacks inline.
+ * @param nInterests The number of incoming interests.
+ * @param receiveDuration Set this to the number of seconds for all calls to onReceivedElement.
+ * @param maxQueueDepth Set this to the maximum queue depth of the executor, or 0 if none.
+ * @return The number of seconds until all interests are answered.
+ */
+static double
+benchmarkCallbackExecutorSeconds(int nThreads, int nInterests, double& receiveDuration, size_t& maxQueueDepth)
+{
+  ptr_lib::shared_ptr<DummyTransport> transport(new DummyTransport());
+  Node node(transport, ptr_lib::make_shared<Transport::ConnectionInfo>());
+  ptr_lib::shared_ptr<ThreadPoolExecutor> executor;
+  if (nThreads > 0) {
+    executor.reset(new ThreadPoolExecutor(nThreads));
+    node.setCallbackExecutor(executor, true);
+  }
+  WireFormat& wireFormat = *WireFormat::getDefaultWireFormat();
+
+  int nAnswered = 0;
+  vector<ptr_lib::shared_ptr<SlowProducer> > producers;
+  vector<Name> prefixes;
+  for (int i = 0; i < 2; ++i) {
+    producers.push_back(ptr_lib::shared_ptr<SlowProducer>(new SlowProducer(100, nAnswered)));
+    prefixes.push_back(Name("/ndn/ucla.edu/apps/executor-test").appendSegment(i));
+    node.registerPrefix
+      (prefixes[i], bind(&SlowProducer::onInterest, producers[i].get(), _1, _2, _3, _4),
+       bind(&SlowProducer::onRegisterFailed, producers[i].get(), _1), ForwardingFlags(), wireFormat);
+  }
+  // With the executor, the Node is in the thread-safe mode, so the interest which fetches the ndndId is queued for
+  // processEvents.
+  node.processEvents();
+  // Both registerPrefix calls fetch the ndndId with the same interest, so one data packet answers both.
+  Data ndndIdData(Name("/%C1.M.S.localhost/%C1.M.SRV/ndnd/KEY"));
+  uint8_t ndndId[32] = { 1 };
+  dynamic_cast<Sha256WithRsaSignature*>(ndndIdData.getSignature())->getPublisherPublicKeyDigest().setPublisherPublicKeyDigest
+    (Blob(ndndId, sizeof(ndndId)));
+  Blob ndndIdEncoding = ndndIdData.wireEncode();
+  node.onReceivedElement(ndndIdEncoding.buf(), ndndIdEncoding.size());
+
+  vector<Blob> encodings;
+  for (int i = 0; i < nInterests; ++i)
+    encodings.push_back(Interest(Name(prefixes[i % 2]).appendSegment(i / 2 + 1)).wireEncode());
+  int sendCount = transport->sendCount_;
+
+  double start = getNowSeconds();
+  for (int i = 0; i < nInterests; ++i)
+    node.onReceivedElement(encodings[i].buf(), encodings[i].size());
+  receiveDuration = getNowSeconds() - start;
+  while (__atomic_load_n(&nAnswered, __ATOMIC_SEQ_CST) < nInterests)
+    node.processEvents(1.0);
+  // Send the data which the last callbacks queued.
+  node.processEvents();
+  double duration = getNowSeconds() - start;
+
+  if (transport->sendCount_ != sendCount + nInterests)
+    throw runtime_error("benchmarkCallbackExecutorSeconds: Not every interest was answered");
+  if (!producers[0]->isOrdered_ || !producers[1]->isOrdered_)
+    throw runtime_error("benchmarkCallbackExecutorSeconds: The interests for a prefix were not called in order");
+  maxQueueDepth = executor ? executor->getMaxQueueDepth() : 0;
+
+  return duration;
+}
+
+/**
+ * Fill the pending interest table with nPendingInterests interests which don't time out during the test, then time
+ * nIterations calls to processEvents.  Each call also has a callLater callback which is due.
+ * @param nPendingInterests The number of interests in the pending interest table.
+ * @param nIterations The number of calls to processEvents.
+ * @return The number of seconds for all calls to processEvents.
+ */
+static double
+benchmarkProcessEventsSeconds(int nPendingInterests, int nIterations)
+{
+  Node node(ptr_lib::make_shared<DummyTransport>(), ptr_lib::make_shared<Transport::ConnectionInfo>());
+  Counter counter;
+  WireFormat& wireFormat = *WireFormat::getDefaultWireFormat();
+
+  for (int i = 0; i < nPendingInterests; ++i)
+    node.expressInterest
+      (Interest(makeInterestName(i), 1000000.0), bind(&Counter::onData, &counter, _1, _2), OnTimeout(), wireFormat);
+
+  double duration = 0;
+  for (int i = 0; i < nIterations; ++i) {
+    node.callLater(0, bind(&Counter::onCallLater, &counter));
+    double start = getNowSeconds();
+    node.processEvents();
+    duration += getNowSeconds() - start;
+  }
+
+  if (counter.callLaterCount_ != nIterations)
+    throw runtime_error("benchmarkProcessEventsSeconds: Not every callLater callback was called");
+
+  return duration;
+}
+
+/**
+ * Express nPendingInterests interests, then time removing all of them by pendingInterestId in the order they were
+ * expressed.  Then express them again and time removing all of them with one call to removePendingInterestsWithPrefix.
+ * @param nPendingInterests The number of interests in the pending interest table.
+ * @param removeWithPrefixDuration Set this to the number of seconds for the call to removePendingInterestsWithPrefix.
+ * @return The number of seconds for all calls to removePendingInterest.
+ */
+static double
+benchmarkRemovePendingInterestSeconds(int nPendingInterests, double& removeWithPrefixDuration)
+{
+  Node node(ptr_lib::make_shared<DummyTransport>(), ptr_lib::make_shared<Transport::ConnectionInfo>());
+  Counter counter;
+  WireFormat& wireFormat = *WireFormat::getDefaultWireFormat();
+
+  vector<uint64_t> pendingInterestIds;
+  for (int i = 0; i < nPendingInterests; ++i)
+    pendingInterestIds.push_back(node.expressInterest
+      (Interest(makeInterestName(i)), bind(&Counter::onData, &counter, _1, _2), OnTimeout(), wireFormat));
+
+  // Allocate a large buffer before timing so that the timing doesn't include the memory allocator consolidating the
+  // memory freed by the previous benchmark.
+  Blob(ptr_lib::make_shared<vector<uint8_t> >(65536));
+
+  double start = getNowSeconds();
+  for (size_t i = 0; i < pendingInterestIds.size(); ++i)
+    node.removePendingInterest(pendingInterestIds[i]);
+  double duration = getNowSeconds() - start;
+
+  for (int i = 0; i < nPendingInterests; ++i)
+    node.expressInterest(Interest(makeInterestName(i)), bind(&Counter::onData, &counter, _1, _2), OnTimeout(), wireFormat);
+
+  start = getNowSeconds();
+  node.removePendingInterestsWithPrefix(Name("/ndn/ucla.edu/apps/pit-test"));
+  removeWithPrefixDuration = getNowSeconds() - start;
+
+  // Check that the PIT is empty.
+  Data data(makeInterestName(0));
+  Blob encoding = data.wireEncode();
+  node.onReceivedElement(encoding.buf(), encoding.size());
+  if (counter.callbackCount_ != 0)
+    throw runtime_error("benchmarkRemovePendingInterestSeconds: A removed pending interest was satisfied");
+
+  return duration;
+}
+
+/**
+ * Fill the pending interest table with nPendingInterests interests, then time nIterations calls to
+ * onReceivedElement where each data packet has a name which doesn't match any pending interest, so that the node
+ * drops it.
+ * @param nPendingInterests The number of interests in the pending interest table.
+ * @param nIterations The number of incoming data packets.
+ * @param contentLength The number of bytes in the content of each data packet.
+ * @return The number of seconds for all calls to onReceivedElement.
+ */
+static double
+benchmarkUnsolicitedDataSeconds(int nPendingInterests, int nIterations, size_t contentLength)
+{
+  Node node(ptr_lib::make_shared<DummyTransport>(), ptr_lib::make_shared<Transport::ConnectionInfo>());
+  Counter counter;
+  WireFormat& wireFormat = *WireFormat::getDefaultWireFormat();
+
+  for (int i = 0; i < nPendingInterests; ++i)
+    node.expressInterest(Interest(makeInterestName(i)), bind(&Counter::onData, &counter, _1, _2), OnTimeout(), wireFormat);
+
+  // Encode the incoming data packets ahead of time, with names under a prefix of no pending interest.
+  vector<uint8_t> content(contentLength, 'x');
+  uint8_t signatureBits[128] = { 1 };
+  vector<Blob> encodings;
+  for (int i = 0; i < 1000; ++i) {
+    ostringstream number;
+    number << i;
+    Data data(Name("/ndn/ucla.edu/apps/unsolicited").append((const uint8_t *)number.str().c_str(), number.str().size()));
+    data.setContent(content);
+    dynamic_cast<Sha256WithRsaSignature*>(data.getSignature())->setSignature(Blob(signatureBits, sizeof(signatureBits)));
+    encodings.push_back(data.wireEncode());
+  }
+
+  double start = getNowSeconds();
+  for (int i = 0; i < nIterations; ++i) {
+    size_t iEncoding = i % encodings.size();
+    node.onReceivedElement(encodings[iEncoding].buf(), encodings[iEncoding].size());
+  }
+  double duration = getNowSeconds() - start;
+
+  if (counter.callbackCount_ != 0)
+    throw runtime_error("benchmarkUnsolicitedDataSeconds: An unsolicited data packet satisfied a pending interest");
+
+  return duration;
+}
+
+/**
+ * Make the registered prefix number i.
+ * @param i The registered prefix number.
+ * @return The name /ndn/ucla.edu/apps/fib-test/<i> .
+ */
+static Name
+makePrefix(int i)
+{
+  ostringstream number;
+  number << i;
+  return Name("/ndn/ucla.edu/apps/fib-test").append((const uint8_t *)number.str().c_str(), number.str().size());
+}
+
+/**
+ * Register nPrefixes prefixes, then time nIterations calls to onReceivedElement where each interest is dispatched
+ * to one of the registered prefixes.
+ * @param nPrefixes The number of registered prefixes.
+ * @param nIterations The number of incoming interests.
+ * @return The number of seconds for all calls to onReceivedElement.
+ */
+static double
+benchmarkRegisteredPrefixTableSeconds(int nPrefixes, int nIterations)
+{
+  Node node(ptr_lib::make_shared<DummyTransport>(), ptr_lib::make_shared<Transport::ConnectionInfo>());
+  Counter counter;
+  WireFormat& wireFormat = *WireFormat::getDefaultWireFormat();
+
+  // The first registerPrefix fetches the ndndId, so answer it with a data packet which has a publisher public key digest.
+  node.registerPrefix
+    (makePrefix(0), bind(&Counter::onInterest, &counter, _1, _2, _3, _4), 
+     bind(&Counter::onRegisterFailed, &counter, _1), ForwardingFlags(), wireFormat);
+  Data ndndIdData(Name("/%C1.M.S.localhost/%C1.M.SRV/ndnd/KEY"));
+  uint8_t ndndId[32] = { 1 };
+  dynamic_cast<Sha256WithRsaSignature*>(ndndIdData.getSignature())->getPublisherPublicKeyDigest().setPublisherPublicKeyDigest
+    (Blob(ndndId, sizeof(ndndId)));
+  Blob ndndIdEncoding = ndndIdData.wireEncode();
+  node.onReceivedElement(ndndIdEncoding.buf(), ndndIdEncoding.size());
+
+  for (int i = 1; i < nPrefixes; ++i)
+    node.registerPrefix
+      (makePrefix(i), bind(&Counter::onInterest, &counter, _1, _2, _3, _4), 
+       bind(&Counter::onRegisterFailed, &counter, _1), ForwardingFlags(), wireFormat);
+
+  // Encode the incoming interests ahead of time, spread over the registered prefixes.
+  int nEncodings = nPrefixes < 1000 ? nPrefixes : 1000;
+  vector<Blob> encodings;
+  for (int i = 0; i < nEncodings; ++i) {
+    Name name(makePrefix(i * (nPrefixes / nEncodings)));
+    name.append((const uint8_t *)"session", 7).appendSegment(i);
+    encodings.push_back(Interest(name).wireEncode());
+  }
+
+  double duration = 0;
+  for (int i = 0; i < nIterations; ++i) {
+    size_t iEncoding = i % encodings.size();
+    double start = getNowSeconds();
+    node.onReceivedElement(encodings[iEncoding].buf(), encodings[iEncoding].size());
+    duration += getNowSeconds() - start;
+  }
+
+  if (counter.interestCount_ != nIterations)
+    throw runtime_error("benchmarkRegisteredPrefixTableSeconds: Not every interest was dispatched to a registered prefix");
+  if (!counter.lastPrefix_->equals(makePrefix((int)((nIterations - 1) % encodings.size()) * (nPrefixes / nEncodings))))
+    throw runtime_error("benchmarkRegisteredPrefixTableSeconds: The interest was dispatched to the wrong prefix");
+
+  return duration;
+}
+
+int
+main(int argc, char** argv)
+{
+  try {
+    int nIterations = 100000;
+    checkContentStore();
+    for (int nPendingInterests = 10; nPendingInterests <= 1000000; nPendingInterests *= 10) {
+      double duration = benchmarkPendingInterestTableSeconds(nPendingInterests, nIterations);
+      cout << "Satisfy pending interest: PIT size " << nPendingInterests << ", Duration sec, Hz: "
+           << duration << ", " << (nIterations / duration) << endl;
+    }
+    for (int nCallbacks = 1; nCallbacks <= 100; nCallbacks *= 10) {
+      double duration = benchmarkAggregateInterestsSeconds(nCallbacks, nIterations / 10);
+      cout << "Aggregate identical interests: " << nCallbacks << " callbacks, Duration sec, data Hz, callbacks Hz: "
+           << duration << ", " << (nIterations / 10 / duration) << ", " << (nCallbacks * nIterations / 10 / duration)
+           << endl;
+    }
+    for (int nCached = 10; nCached <= 100000; nCached *= 100) {
+      double duration = benchmarkContentStoreSeconds(nCached, nIterations);
+      cout << "Answer from content store: " << nCached << " cached, Duration sec, Hz: "
+           << duration << ", " << (nIterations / duration) << endl;
+    }
+    for (size_t contentLength = 100; contentLength <= 8000; contentLength *= 80) {
+      double duration = benchmarkUnsolicitedDataSeconds(1000, nIterations, contentLength);
+      cout << "Drop unsolicited data: " << contentLength << " byte content, Duration sec, Hz: "
+           << duration << ", " << (nIterations / duration) << endl;
+    }
+    for (int nPendingInterests = 10; nPendingInterests <= 1000000; nPendingInterests *= 10) {
+      double duration = benchmarkProcessEventsSeconds(nPendingInterests, nIterations);
+      cout << "Process events: PIT size " << nPendingInterests << ", Duration sec, Hz: "
+           << duration << ", " << (nIterations / duration) << endl;
+    }
+    for (int nPendingInterests = 10; nPendingInterests <= 1000000; nPendingInterests *= 10) {
+      double removeWithPrefixDuration;
+      double duration = benchmarkRemovePendingInterestSeconds(nPendingInterests, removeWithPrefixDuration);
+      cout << "Remove pending interest: PIT size " << nPendingInterests << ", Duration sec, Hz: "
+           << duration << ", " << (nPendingInterests / duration) << endl;
+      cout << "Remove pending interests with prefix: PIT size " << nPendingInterests << ", Duration sec, Hz: "
+           << removeWithPrefixDuration << ", " << (nPendingInterests / removeWithPrefixDuration) << endl;
+    }
+    for (int usePutData = 0; usePutData <= 1; ++usePutData) {
+      double hitRate;
+      double duration = benchmarkProducerStoreSeconds(usePutData != 0, 100, nIterations, hitRate);
+      cout << "Answer interest " << (usePutData ? "from producer store" : "in onInterest") << ": hit rate "
+           << hitRate << ", Duration sec, Hz: " << duration << ", " << (nIterations / duration) << endl;
+    }
+    for (int nThreads = 1; nThreads <= 8; nThreads *= 2) {
+      double duration = benchmarkThreadSafeExpressInterestSeconds(nThreads, nIterations);
+      // Each thread removes every other interest that it expresses.
+      cout << "Thread-safe express and remove interest: " << nThreads << " threads, Duration sec, requests Hz: "
+           << duration << ", " << (nIterations * 3 / 2 / duration) << endl;
+    }
+    for (int nThreads = 0; nThreads <= 4; nThreads += 2) {
+      double receiveDuration;
+      size_t maxQueueDepth;
+      double duration = benchmarkCallbackExecutorSeconds(nThreads, nIterations / 10, receiveDuration, maxQueueDepth);
+      cout << "Slow OnInterest " << (nThreads > 0 ? "on executor" : "inline") << ": " << nThreads
+           << " threads, max queue depth " << maxQueueDepth << ", Receive sec, Hz: " << receiveDuration << ", "
+           << (nIterations / 10 / receiveDuration) << ", Answer sec, Hz: " << duration << ", "
+           << (nIterations / 10 / duration) << endl;
+    }
+    for (int nPrefixes = 10; nPrefixes <= 10000; nPrefixes *= 10) {
+      double duration = benchmarkRegisteredPrefixTableSeconds(nPrefixes, nIterations);
+      cout << "Dispatch interest: Registered prefixes " << nPrefixes << ", Duration sec, Hz: "
+           << duration << ", " << (nIterations / duration) << endl;
+    }
+  } catch (std::exception& e) {
+    cout << "exception: " << e.what() << endl;
+  }
+  return 0;
+}
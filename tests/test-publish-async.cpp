@@ -8,7 +8,6 @@
 #include <sstream>
 #include <iostream>
 #include <time.h>
-#include <unistd.h>
 #include <ndn-cpp/face.hpp>
 #include <ndn-cpp/security/identity/memory-identity-storage.hpp>
 #include <ndn-cpp/security/identity/memory-private-key-storage.hpp>
@@ -87,7 +86,7 @@ public:
     Blob encodedData = data.wireEncode();
 
     cout << "Sent content " << content << endl;
-    transport.send(*encodedData);
+    transport.send(encodedData);
   }
   
   // onRegisterFailed.
@@ -128,11 +127,9 @@ int main(int argc, char** argv)
     
     // The main event loop.  
     // Wait forever to receive one interest for the prefix.
-    while (echo.responseCount_ < 1) {
-      face.processEvents();
-      // We need to sleep for a few milliseconds so we don't use 100% of the CPU.
-      usleep(10000);
-    }
+    while (echo.responseCount_ < 1)
+      // Block until there is an event so we don't use 100% of the CPU.
+      face.processEvents(1000.0);
   } catch (std::exception& e) {
     cout << "exception: " << e.what() << endl;
   }
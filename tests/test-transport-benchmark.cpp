@@ -0,0 +1,313 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Jeff Thompson <jefft0@remap.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <stdexcept>
+#include <time.h>
+#include <sys/time.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <ndn-cpp/data.hpp>
+#include <ndn-cpp/interest.hpp>
+#include <ndn-cpp/encoding/element-listener.hpp>
+#include <ndn-cpp/transport/shm-transport.hpp>
+#include <ndn-cpp/transport/tcp-transport.hpp>
+#include <ndn-cpp/transport/unix-transport.hpp>
+
+using namespace std;
+using namespace ndn;
+
+static double
+getNowSeconds()
+{
+  struct timeval t;
+  gettimeofday(&t, 0);
+  return t.tv_sec + t.tv_usec / 1000000.0;
+}
+
+/**
+ * An ElementCounter counts the elements and bytes which a transport receives.
+ */
+class ElementCounter : public ElementListener {
+public:
+  ElementCounter()
+  : nElements_(0), nBytes_(0)
+  {
+  }
+
+  virtual void
+  onReceivedElement(const uint8_t *element, size_t elementLength)
+  {
+    ++nElements_;
+    nBytes_ += elementLength;
+  }
+
+  size_t nElements_;
+  size_t nBytes_;
+};
+
+/**
+ * An EchoListener sends each element that it receives back through the transport.
+ */
+class EchoListener : public ElementListener {
+public:
+  EchoListener(Transport& transport)
+  : transport_(transport)
+  {
+  }
+
+  virtual void
+  onReceivedElement(const uint8_t *element, size_t elementLength)
+  {
+    transport_.send(element, elementLength);
+  }
+
+private:
+  Transport& transport_;
+};
+
+/**
+ * Create a TCP socket listening on a free port of the loopback interface.
+ * @param port Set this to the port number.
+ * @return The socket descriptor.
+ */
+static int
+listenTcp(unsigned short& port)
+{
+  int socketDescriptor = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in address;
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = 0;
+  socklen_t addressLength = sizeof(address);
+  if (socketDescriptor < 0 || bind(socketDescriptor, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+      listen(socketDescriptor, 1) != 0 ||
+      getsockname(socketDescriptor, (struct sockaddr *)&address, &addressLength) != 0)
+    throw runtime_error("Cannot listen on a TCP socket");
+
+  port = ntohs(address.sin_port);
+  return socketDescriptor;
+}
+
+/**
+ * Create a Unix socket listening on the file path.
+ * @param filePath The path of the socket file.  This removes an existing file.
+ * @return The socket descriptor.
+ */
+static int
+listenUnix(const string& filePath)
+{
+  unlink(filePath.c_str());
+  int socketDescriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+  struct sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strncpy(address.sun_path, filePath.c_str(), sizeof(address.sun_path) - 1);
+  if (socketDescriptor < 0 || bind(socketDescriptor, (struct sockaddr *)&address, sizeof(address)) != 0 ||
+      listen(socketDescriptor, 1) != 0)
+    throw runtime_error("Cannot listen on a Unix socket");
+
+  return socketDescriptor;
+}
+
+/**
+ * Accept one connection on the listening socket and send back everything received until the peer closes it.
+ * @param listenSocket The listening socket descriptor.
+ */
+static void
+echoOneConnection(int listenSocket)
+{
+  int socketDescriptor = accept(listenSocket, 0, 0);
+  if (socketDescriptor < 0)
+    return;
+
+  vector<uint8_t> buffer(65536);
+  while (true) {
+    ssize_t nBytes = recv(socketDescriptor, &buffer[0], buffer.size(), 0);
+    if (nBytes <= 0)
+      break;
+    for (ssize_t nSent = 0; nSent < nBytes; ) {
+      ssize_t result = send(socketDescriptor, &buffer[nSent], nBytes - nSent, 0);
+      if (result < 0)
+        break;
+      nSent += result;
+    }
+  }
+  close(socketDescriptor);
+}
+
+/**
+ * Listen with a ShmTransport on the file path and send back every element received.  This blocks on the eventfd
+ * between elements and doesn't return.
+ * @param filePath The path of the socket file for the ShmTransport handshake.
+ */
+static void
+echoShm(const string& filePath)
+{
+  ShmTransport transport;
+  EchoListener listener(transport);
+  transport.connect(ShmTransport::ConnectionInfo(filePath.c_str(), true), listener);
+
+  struct pollfd pollInfo;
+  pollInfo.fd = transport.getFileDescriptor();
+  pollInfo.events = POLLIN;
+  while (true) {
+    poll(&pollInfo, 1, 1000);
+    transport.processEvents();
+  }
+}
+
+/**
+ * Send element to the echo server nRoundTrips times, each time waiting for it to come back.
+ * @param transport The connected transport.
+ * @param counter The ElementCounter given to connect.
+ * @param element The encoded element to send.
+ * @param nRoundTrips The number of round trips.
+ * @return The number of seconds for all round trips.
+ */
+static double
+benchmarkLatencySeconds(Transport& transport, ElementCounter& counter, const Blob& element, int nRoundTrips)
+{
+  double start = getNowSeconds();
+  for (int i = 0; i < nRoundTrips; ++i) {
+    size_t nExpected = counter.nElements_ + 1;
+    transport.send(element);
+    while (counter.nElements_ < nExpected)
+      transport.processEvents();
+  }
+  return getNowSeconds() - start;
+}
+
+/**
+ * Send element to the echo server nElements times, keeping up to window elements in flight, and wait for them all
+ * to come back.
+ * @param transport The connected transport.
+ * @param counter The ElementCounter given to connect.
+ * @param element The encoded element to send.
+ * @param nElements The number of elements to send.
+ * @param window The maximum number of elements sent but not yet received back.
+ * @return The number of seconds to send and receive all the elements.
+ */
+static double
+benchmarkThroughputSeconds
+  (Transport& transport, ElementCounter& counter, const Blob& element, int nElements, int window)
+{
+  size_t nStart = counter.nElements_;
+  size_t nSent = 0;
+  double start = getNowSeconds();
+  while (counter.nElements_ - nStart < (size_t)nElements) {
+    while (nSent < (size_t)nElements && nSent - (counter.nElements_ - nStart) < (size_t)window) {
+      transport.send(element);
+      ++nSent;
+    }
+    transport.processEvents();
+  }
+  return getNowSeconds() - start;
+}
+
+/**
+ * Print the latency and throughput of the transport connected to the echo server, then close it.
+ * @param name The name of the transport to print.
+ * @param transport The connected transport.
+ * @param counter The ElementCounter given to connect.
+ */
+static void
+benchmarkTransport(const string& name, Transport& transport, ElementCounter& counter)
+{
+  Blob interestEncoding = Interest(Name("/ndn/ucla.edu/apps/transport-test/latency")).wireEncode();
+  int nRoundTrips = 20000;
+  double duration = benchmarkLatencySeconds(transport, counter, interestEncoding, nRoundTrips);
+  cout << name << " round trip: " << interestEncoding.size() << " byte interest, Duration sec, Hz, microseconds: "
+       << duration << ", " << (nRoundTrips / duration) << ", " << (duration / nRoundTrips * 1e6) << endl;
+
+  Data data(Name("/ndn/ucla.edu/apps/transport-test/throughput"));
+  data.setContent(vector<uint8_t>(8000, 'x'));
+  Blob dataEncoding = data.wireEncode();
+  int nElements = 50000;
+  duration = benchmarkThroughputSeconds(transport, counter, dataEncoding, nElements, 32);
+  cout << name << " throughput: " << dataEncoding.size() << " byte data, Duration sec, MB/s: "
+       << duration << ", " << ((double)nElements * dataEncoding.size() / duration / 1e6) << endl;
+
+  transport.close();
+}
+
+int
+main(int argc, char** argv)
+{
+  ostringstream unixPath;
+  unixPath << "/tmp/ndn-cpp-transport-benchmark-" << getpid() << ".sock";
+  ostringstream shmPath;
+  shmPath << "/tmp/ndn-cpp-transport-benchmark-shm-" << getpid() << ".sock";
+  try {
+    unsigned short tcpPort;
+    int tcpListenSocket = listenTcp(tcpPort);
+    int unixListenSocket = listenUnix(unixPath.str());
+
+    // The child process echoes the TCP connection, then the Unix connection, then the shared memory transport.
+    pid_t child = fork();
+    if (child < 0)
+      throw runtime_error("Error in fork");
+    if (child == 0) {
+      echoOneConnection(tcpListenSocket);
+      echoOneConnection(unixListenSocket);
+      echoShm(shmPath.str());
+      _exit(0);
+    }
+    close(tcpListenSocket);
+    close(unixListenSocket);
+
+    try {
+      TcpTransport tcpTransport;
+      ElementCounter tcpCounter;
+      tcpTransport.connect(TcpTransport::ConnectionInfo("127.0.0.1", tcpPort), tcpCounter);
+      benchmarkTransport("TCP loopback", tcpTransport, tcpCounter);
+
+      UnixTransport unixTransport;
+      ElementCounter unixCounter;
+      unixTransport.connect(UnixTransport::ConnectionInfo(unixPath.str().c_str()), unixCounter);
+      benchmarkTransport("Unix socket", unixTransport, unixCounter);
+
+      ShmTransport shmTransport;
+      ElementCounter shmCounter;
+      // Retry until the child is listening.
+      for (int i = 0; ; ++i) {
+        try {
+          shmTransport.connect(ShmTransport::ConnectionInfo(shmPath.str().c_str()), shmCounter);
+          break;
+        } catch (std::exception& e) {
+          if (i >= 5000)
+            throw;
+          usleep(1000);
+        }
+      }
+      benchmarkTransport("Shared memory", shmTransport, shmCounter);
+    } catch (...) {
+      kill(child, SIGTERM);
+      waitpid(child, 0, 0);
+      throw;
+    }
+    kill(child, SIGTERM);
+    waitpid(child, 0, 0);
+  } catch (std::exception& e) {
+    cout << "exception: " << e.what() << endl;
+  }
+  unlink(unixPath.str().c_str());
+  unlink(shmPath.str().c_str());
+  return 0;
+}